@@ -0,0 +1,166 @@
+/** @file */
+
+#ifndef ANNEALER_H
+#define ANNEALER_H
+
+#include "data.h"
+#include "global.h"
+#include <random>
+#include <vector>
+
+/**
+ * @brief      Struct for a violation count, split into the number of violated
+ * hard constraints and the weight of the violated soft constraints.
+ */
+struct Penalty {
+    /**
+     * The number of violated hard constraints
+     */
+    long long hard;
+    /**
+     * The total weight of the violated soft constraints
+     */
+    long long soft;
+};
+
+/**
+ * @brief      Struct for the state of one annealing chain.
+ *
+ * This is the compact representation of a timetable that the annealer works
+ * on, along with the occupancy of every Instructor, Classroom and core Program
+ * at every time, and the Penalty of the timetable, which are all kept up to
+ * date as courses are moved.
+ */
+struct AnnealerState {
+    /**
+     * The Slot index of each Course
+     */
+    std::vector<int> slots;
+    /**
+     * The Segment index of each Course
+     */
+    std::vector<int> segments;
+    /**
+     * The Classroom index of each Course, -1 if no Classroom is large enough
+     */
+    std::vector<int> classrooms;
+    /**
+     * The number of courses of each Instructor at each time, indexed by
+     * instructor * timeCount + time
+     */
+    std::vector<int> instructorBusy;
+    /**
+     * The number of courses in each Classroom at each time, indexed by
+     * classroom * timeCount + time
+     */
+    std::vector<int> classroomBusy;
+    /**
+     * The number of core courses of each Program at each time, indexed by
+     * program * timeCount + time
+     */
+    std::vector<int> programBusy;
+    /**
+     * The Penalty of the timetable
+     */
+    Penalty penalty;
+};
+
+/**
+ * @brief      Class for the annealer.
+ *
+ * This is a simulated annealing engine that works directly on the Data,
+ * without encoding the constraints as clauses. A timetable is stored as the
+ * (Slot, Segment, Classroom) of each Course. A time is a (Slot, Segment) pair,
+ * and the courses occupying each time are counted per Instructor, Classroom
+ * and core Program. Moving a Course then only looks at the times intersecting
+ * its old and new times, so that the change in the Penalty is found without
+ * evaluating the whole timetable.
+ *
+ * Each chain starts from the greedy schedule and makes random moves, which
+ * change the Slot, Segment or Classroom of a Course, or swap the times of two
+ * courses. Worsening moves are accepted with a probability that falls with the
+ * temperature, which is cooled over the time limit. A Course is not moved back
+ * to a Slot it recently left unless that gives a new best timetable. Several
+ * independent chains can be run on separate threads, and the best timetable
+ * among them is kept.
+ *
+ * The predefined constraints and the existing assignments are taken into
+ * account with their weights. Custom constraints are not.
+ */
+class Annealer {
+  private:
+    /**
+     * A reference to the Data for which the timetable is made
+     */
+    Data &data;
+    /**
+     * The number of times, which is the number of slots times the number of
+     * segments
+     */
+    int timeCount;
+    /**
+     * The times intersecting each time, including itself
+     */
+    std::vector<std::vector<int>> overlapping;
+    /**
+     * The core programs of each Course
+     */
+    std::vector<std::vector<int>> corePrograms;
+    /**
+     * The classrooms large enough for each Course
+     */
+    std::vector<std::vector<int>> allowedClassrooms;
+    /**
+     * The Penalty of giving each Slot to each Course
+     */
+    std::vector<std::vector<Penalty>> slotPenalty;
+    /**
+     * The Penalty of giving each Segment to each Course
+     */
+    std::vector<std::vector<Penalty>> segmentPenalty;
+    /**
+     * The Penalty of giving each Classroom to each Course
+     */
+    std::vector<std::vector<Penalty>> classroomPenalty;
+    /**
+     * The weight of a hard constraint when comparing penalties during the
+     * search, which is larger than the soft weight that a single move can
+     * change
+     */
+    long long hardWeight;
+    /**
+     * The number of iterations for which a Course is not moved back to a
+     * Slot it left
+     */
+    int tabuTenure;
+    /**
+     * The best timetable found by any chain
+     */
+    AnnealerState best;
+    /**
+     * The number of moves made by all the chains
+     */
+    unsigned long long moves;
+    Penalty existingPenalty(int, FieldType, int);
+    void precompute();
+    int timeOf(int, int);
+    void addViolations(Penalty &, int, long long);
+    int countOverlapping(const std::vector<int> &, int, int);
+    void addCourse(AnnealerState &, int, int);
+    void moveCourse(AnnealerState &, int, int, int, int);
+    long long value(const Penalty &);
+    bool isBetter(const Penalty &, const Penalty &);
+    AnnealerState initialState();
+    void runChain(AnnealerState &, unsigned, double, unsigned long long &);
+
+  public:
+    Annealer(Data &);
+    void run(double, unsigned, int);
+    int getSlot(int);
+    int getSegment(int);
+    int getClassroom(int);
+    Penalty getPenalty();
+    unsigned long long getMoves();
+};
+
+#endif
@@ -0,0 +1,85 @@
+/** @file */
+
+#ifndef COMPILED_INSTANCE_H
+#define COMPILED_INSTANCE_H
+
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include "data.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace NSPACE;
+using namespace openwbo;
+
+/**
+ * @brief      Class for a compiled instance, which is the parsed Data and the
+ * encoded formula of an instance saved to a binary file, so that solving the
+ * instance again skips parsing and encoding it.
+ *
+ * The file starts with a header of 32 bytes: the magic "TTCOMPIL", the format
+ * version and a padding word, then the size and the FNV-1a checksum of the
+ * payload, as 64 bit numbers. The payload follows, and is made of little
+ * endian 32 bit words, so that it is read in place from the mapped file. It
+ * holds the field values, the courses, the variables of each course and the
+ * weights of the Data, and then the variables, the hard clauses, the soft
+ * clauses with their objective levels, the groups of hard clauses, the phase
+ * hints and the hints of the greedy schedule. Counts precede lists, strings
+ * are padded to whole words, and literals are stored as 2 * variable + sign.
+ */
+class CompiledInstance {
+  private:
+    /**
+     * The payload being written
+     */
+    std::string payload;
+    /**
+     * The position up to which the payload is read
+     */
+    const unsigned char *position;
+    /**
+     * The end of the payload being read
+     */
+    const unsigned char *end;
+    /**
+     * Whether a read went past the end of the payload
+     */
+    bool truncated;
+    /**
+     * The error of the last read or write, empty if there is none
+     */
+    std::string error;
+    void putWord(uint32_t);
+    void putWeight(uint64_t);
+    void putString(const std::string &);
+    void putInts(const std::vector<int> &);
+    void putLits(const vec<Lit> &);
+    void putHints(const std::vector<Lit> &);
+    uint32_t getWord();
+    uint32_t getCount();
+    uint64_t getWeight();
+    std::string getString();
+    std::vector<int> getInts();
+    bool getLits(vec<Lit> &, int);
+    void putData(Data &);
+    void getData(Data &);
+    bool getHints(std::vector<Lit> &, int);
+    bool parse(Data &, MaxSATFormula *, std::vector<int> &,
+               std::vector<std::pair<int, int>> &, std::vector<Lit> &,
+               std::vector<Lit> &);
+
+  public:
+    CompiledInstance();
+    bool write(const std::string &, Data &, MaxSATFormula *,
+               const std::vector<int> &,
+               const std::vector<std::pair<int, int>> &,
+               const std::vector<Lit> &, const std::vector<Lit> &);
+    bool read(const std::string &, Data &, MaxSATFormula *,
+              std::vector<int> &, std::vector<std::pair<int, int>> &,
+              std::vector<Lit> &, std::vector<Lit> &);
+    std::string getError();
+};
+
+#endif
@@ -0,0 +1,104 @@
+/** @file */
+
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * @brief      Struct for a cell of a CSV file, as a view into the file that
+ * is valid until the next row is read.
+ */
+struct CSVCell {
+    /**
+     * The first character of the cell
+     */
+    const char *data;
+    /**
+     * The number of characters of the cell
+     */
+    size_t length;
+    bool empty() const;
+    bool operator==(const char *) const;
+    bool operator!=(const char *) const;
+};
+
+/**
+ * @brief      Class for a reader of CSV files.
+ *
+ * The file is memory mapped and read once, a row at a time. The header row is
+ * read when the file is opened, so that the index of each column is looked up
+ * once, and each cell of a row is then given as a CSVCell pointing into the
+ * mapped file. Only quoted cells with escaped quotes are copied, to remove the
+ * escapes.
+ *
+ * Cells may be quoted, in which case they may contain commas, newlines and
+ * quotes doubled to escape them. Lines may end with "\r\n", and blank lines
+ * are skipped. Every row must have as many cells as the header. A malformed
+ * row stops the reading with an error that gives the line it is on.
+ */
+class CSVReader {
+  private:
+    /**
+     * The mapped file, nullptr if it is empty or not open
+     */
+    const char *mapped;
+    /**
+     * The size of the mapped file
+     */
+    size_t size;
+    /**
+     * The position up to which the file is read
+     */
+    const char *position;
+    /**
+     * The end of the file
+     */
+    const char *end;
+    /**
+     * The line on which the current row starts, counting from 1
+     */
+    int line;
+    /**
+     * The line on which the next row starts
+     */
+    int nextLine;
+    /**
+     * The name of each column
+     */
+    std::vector<std::string> header;
+    /**
+     * The cells of the current row
+     */
+    std::vector<CSVCell> cells;
+    /**
+     * The copies of the cells of the current row that had escaped quotes.
+     * A std::deque does not move its elements as it grows, so the cells can
+     * point into them.
+     */
+    std::deque<std::string> unescaped;
+    /**
+     * The error that stopped the reading, empty if there is none
+     */
+    std::string error;
+    bool readRow();
+    void fail(const std::string &);
+
+  public:
+    CSVReader();
+    ~CSVReader();
+    CSVReader(const CSVReader &) = delete;
+    CSVReader &operator=(const CSVReader &) = delete;
+    bool open(const std::string &);
+    int findColumn(const std::string &);
+    bool next();
+    const CSVCell &getCell(int);
+    int getLine();
+    bool hasError();
+    std::string getError();
+};
+
+#endif
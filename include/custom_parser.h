@@ -47,6 +47,8 @@ struct Object {
     Clauses constraint;
     std::vector<Clauses> constraintAnds;
     std::vector<Clauses> constraintVals;
+
+    std::string error;
 };
 
 /**
@@ -61,4 +63,23 @@ void parseCustomConstraints(std::string file,
                             ConstraintEncoder *constraintEncoder,
                             TimeTabler *timeTabler);
 
+/**
+ * @brief      Parses custom constraints given in a string and adds them to the
+ * solver.
+ *
+ * Unlike parseCustomConstraints(), a syntax error or a value that does not
+ * exist does not end the program, and no constraint of the string is added
+ * then.
+ *
+ * @param[in]  text               The constraints, in the syntax of the custom
+ * constraints file
+ * @param      constraintEncoder  The ConstraintEncoder object
+ * @param      timeTabler         The TimeTabler object
+ *
+ * @return     True if the constraints were parsed, False otherwise
+ */
+bool parseCustomConstraintString(std::string text,
+                                 ConstraintEncoder *constraintEncoder,
+                                 TimeTabler *timeTabler);
+
 #endif
\ No newline at end of file
@@ -10,10 +10,12 @@
 #include "fields/program.h"
 #include "fields/segment.h"
 #include "fields/slot.h"
+#include "global.h"
+#include "symbol_table.h"
 #include <string>
 #include <vector>
 
-using namespace Minisat;
+using namespace NSPACE;
 
 /**
  * @brief      Class for data.
@@ -26,9 +28,15 @@ using namespace Minisat;
  * the existing assignments given in the input, and the weights of
  * every constraint and exisiting assignment. Most of this
  * data is populated by the Parser after parsing fields and inputs.
+ * It cannot be copied, as the field values point to its SymbolTable.
  */
 class Data {
   public:
+    /**
+     * Interns the names of the courses and the field values, which store the
+     * ids of their names in it
+     */
+    SymbolTable symbols;
     /**
      * Stores objects for each Course in the input
      */
@@ -113,7 +121,29 @@ class Data {
      * or to disable certain constraints.
      */
     std::vector<int> predefinedClausesWeights;
+    /**
+     * Whether a custom constraint mentions classrooms, in which case the
+     * classrooms cannot be assigned by matching alone
+     */
+    bool classroomCustomConstraints;
+    /**
+     * Stores the index of each field value by the id of its name, for each
+     * FieldType, -1 for the ids of no field value of that FieldType. Programs
+     * are indexed by their names with their course types, as given by
+     * Program::getNameWithType().
+     */
+    std::vector<std::vector<int>> fieldValueIndices;
+    /**
+     * Stores the index of each Course by the id of its name, -1 for the ids
+     * of no Course
+     */
+    std::vector<int> courseIndices;
     Data();
+    Data(const Data &) = delete;
+    Data &operator=(const Data &) = delete;
+    void buildIndices();
+    int findFieldValue(FieldType, const std::string &);
+    int findCourse(const std::string &);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+/** @file */
+
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include <cstdint>
+#include <vector>
+
+using namespace NSPACE;
+using namespace openwbo;
+
+/**
+ * @brief      Class for the decomposition of a formula into independent
+ * components.
+ *
+ * The hard unit clauses are first propagated over the hard clauses. This
+ * fixes the values that the input gives as hard, such as the programs of
+ * every Course and usually their instructors, after which the clauses
+ * relating two courses with no common candidate Instructor, Classroom or core
+ * Program are satisfied and dropped. The variables left are split into
+ * connected components, two variables being connected if they appear in the
+ * same remaining clause, so a custom constraint over several courses puts
+ * them in the same component. Each component is then a formula of its own,
+ * whose optimal models together with the fixed values give an optimal model
+ * of the whole formula.
+ */
+class Decomposition {
+  private:
+    /**
+     * A pointer to the formula that is decomposed
+     */
+    MaxSATFormula *formula;
+    /**
+     * The value of each variable fixed by the hard clauses, l_Undef if it is
+     * not fixed
+     */
+    std::vector<lbool> fixed;
+    /**
+     * The component of each variable, -1 if it is fixed or appears in no
+     * remaining clause
+     */
+    std::vector<int> component;
+    /**
+     * The variable of the component formula for each variable
+     */
+    std::vector<Var> localVar;
+    /**
+     * The variables of each component, indexed by the variables of the
+     * component formula
+     */
+    std::vector<std::vector<Var>> componentVars;
+    /**
+     * The indices of the remaining hard clauses of each component
+     */
+    std::vector<std::vector<int>> componentHard;
+    /**
+     * The indices of the remaining soft clauses of each component
+     */
+    std::vector<std::vector<int>> componentSoft;
+    /**
+     * The total weight of the soft clauses falsified by the fixed values
+     */
+    uint64_t fixedCost;
+    /**
+     * Whether the hard clauses were found to be unsatisfiable
+     */
+    bool conflicting;
+    bool propagate();
+    lbool value(Lit);
+    int remaining(vec<Lit> &, Lit &);
+    void findComponents();
+    void addLits(vec<Lit> &, vec<Lit> &);
+
+  public:
+    Decomposition(MaxSATFormula *);
+    bool isConflicting();
+    int getComponentCount();
+    uint64_t getFixedCost();
+    std::vector<int> getHardClauses(int);
+    MaxSATFormula *buildFormula(int);
+    std::vector<Lit> localHints(int, const std::vector<Lit> &);
+    std::vector<lbool> getFixedModel();
+    void mergeModel(int, const std::vector<lbool> &, std::vector<lbool> &);
+};
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "fields/field.h"
 #include "global.h"
+#include "symbol_table.h"
 #include <string>
 
 /**
@@ -13,9 +14,13 @@
 class Classroom : public Field {
   private:
     /**
-     * Represents the classroom number, which uniquely identifies the Classroom
+     * The id of the classroom number, which uniquely identifies the Classroom
      */
-    std::string number;
+    int number;
+    /**
+     * The table in which the number is interned
+     */
+    const SymbolTable *symbols;
     /**
      * The size of the Classroom, which is the maximum number of students it can
      * hold
@@ -23,12 +28,13 @@ class Classroom : public Field {
     unsigned size;
 
   public:
-    Classroom(std::string, unsigned);
+    Classroom(const std::string &, unsigned, SymbolTable &);
     bool operator==(const Classroom &other);
     bool sizeLessThan(const Classroom &other);
     FieldType getType();
     std::string getTypeName();
     std::string getName();
+    int getNameId();
     unsigned getSize();
 };
 
@@ -7,6 +7,7 @@
 #include "fields/is_minor.h"
 #include "fields/program.h"
 #include "fields/segment.h"
+#include "symbol_table.h"
 #include <string>
 #include <vector>
 
@@ -16,10 +17,14 @@
 class Course {
   private:
     /**
-     * The name of the course, typically the course code.
+     * The id of the name of the course, typically the course code.
      * This uniquely identifies a given course.
      */
-    std::string name;
+    int name;
+    /**
+     * The table in which the name is interned
+     */
+    const SymbolTable *symbols;
     /**
      * The class strength of the course. This is the
      * number of students registering for the course.
@@ -49,12 +54,14 @@ class Course {
     int isMinor;
 
   public:
-    Course(std::string, unsigned, int, int, int);
-    Course(std::string, unsigned, int, int, int, std::vector<int>);
+    Course(const std::string &, unsigned, int, int, int, SymbolTable &);
+    Course(const std::string &, unsigned, int, int, int, std::vector<int>,
+           SymbolTable &);
     void setPrograms(std::vector<int>);
     void addProgram(int);
     bool operator==(const Course &other);
     std::string getName();
+    int getNameId();
     int getInstructor();
     std::vector<int> getPrograms();
     int getSegment();
@@ -5,6 +5,7 @@
 
 #include "fields/field.h"
 #include "global.h"
+#include "symbol_table.h"
 #include <string>
 
 /**
@@ -13,15 +14,21 @@
 class Instructor : public Field {
   private:
     /**
-     * The name of the instructor, that uniquely identifies the instructor.
+     * The id of the name of the instructor, that uniquely identifies the
+     * instructor.
      */
-    std::string name;
+    int name;
+    /**
+     * The table in which the name is interned
+     */
+    const SymbolTable *symbols;
 
   public:
-    Instructor(std::string);
+    Instructor(const std::string &, SymbolTable &);
     bool operator==(const Instructor &other);
     FieldType getType();
     std::string getName();
+    int getNameId();
     std::string getTypeName();
 };
 
@@ -5,6 +5,7 @@
 
 #include "fields/field.h"
 #include "global.h"
+#include "symbol_table.h"
 #include <string>
 
 /**
@@ -27,10 +28,14 @@ enum class CourseType {
 class Program : public Field {
   private:
     /**
-     * The name of the Program, which uniquely identifies it.
-     * For example, it might be "B Tech 1".
+     * The id of the name of the Program, which uniquely identifies it.
+     * For example, the name might be "B Tech 1".
      */
-    std::string name;
+    int name;
+    /**
+     * The table in which the name is interned
+     */
+    const SymbolTable *symbols;
     /**
      * The type with which the Program has a certain Course.
      * This could be core or elective, which specifies whether the
@@ -39,10 +44,11 @@ class Program : public Field {
     CourseType courseType;
 
   public:
-    Program(std::string, CourseType);
+    Program(const std::string &, CourseType, SymbolTable &);
     bool operator==(const Program &other);
     FieldType getType();
     std::string getName();
+    int getNameId();
     bool isCoreProgram();
     std::string getTypeName();
     std::string getCourseTypeName();
@@ -25,6 +25,8 @@ class Segment : public Field {
     Segment(int, int);
     bool operator==(const Segment &other);
     int length();
+    int getStartSegment();
+    int getEndSegment();
     bool isIntersecting(const Segment &other);
     FieldType getType();
     std::string getName();
@@ -6,6 +6,7 @@
 #include "fields/field.h"
 #include "fields/is_minor.h"
 #include "global.h"
+#include "symbol_table.h"
 #include <string>
 #include <vector>
 
@@ -48,6 +49,8 @@ class Time {
     bool operator>=(const Time &);
     bool operator>(const Time &);
     std::string getTimeString();
+    unsigned getHours();
+    unsigned getMinutes();
     bool isMorningTime();
 };
 
@@ -71,6 +74,9 @@ class SlotElement {
     SlotElement(Time &, Time &, Day);
     bool isIntersecting(SlotElement &other);
     bool isMorningSlotElement();
+    Day getDay();
+    Time getStartTime();
+    Time getEndTime();
 };
 
 /**
@@ -82,9 +88,13 @@ class SlotElement {
 class Slot : public Field {
   private:
     /**
-     * The name of the Slot, which uniquely identifies it
+     * The id of the name of the Slot, which uniquely identifies it
      */
-    std::string name;
+    int name;
+    /**
+     * The table in which the name is interned
+     */
+    const SymbolTable *symbols;
     /**
      * Represents whether the Slot is a minor slot.
      * Minor slots are reserved for minor courses, by default.
@@ -96,15 +106,19 @@ class Slot : public Field {
     std::vector<SlotElement> slotElements;
 
   public:
-    Slot(std::string, IsMinor, std::vector<SlotElement>);
+    Slot(const std::string &, IsMinor, std::vector<SlotElement>,
+         SymbolTable &);
     bool operator==(const Slot &other);
     bool isIntersecting(Slot &other);
     void addSlotElements(SlotElement);
     bool isMinorSlot();
+    bool isOnDay(Day);
     FieldType getType();
     std::string getTypeName();
     std::string getName();
+    int getNameId();
     bool isMorningSlot();
+    std::vector<SlotElement> getSlotElements();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,174 @@
+/** @file */
+
+#ifndef FIELDS_LOADER_H
+#define FIELDS_LOADER_H
+
+#include "data.h"
+#include "fields/slot.h"
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/yaml.h>
+
+/**
+ * @brief      Struct for a map or sequence of the fields file that the
+ * FieldsLoader is inside.
+ */
+struct FieldsNode {
+    /**
+     * Whether the node is a map, rather than a sequence
+     */
+    bool isMap;
+    /**
+     * For a map, whether its next scalar is a key rather than a value
+     */
+    bool expectingKey;
+    /**
+     * For a map, the key of the value being read
+     */
+    std::string key;
+    /**
+     * For a sequence, the index of the element being read
+     */
+    int index;
+    /**
+     * The length of the path of the parent of the node, to restore the path
+     * to once the node ends
+     */
+    size_t parentPathLength;
+    /**
+     * The position at which the node starts
+     */
+    YAML::Mark mark;
+};
+
+/**
+ * @brief      Class for the loader of the fields file.
+ *
+ * This reads the file as a stream of YAML events, rather than building the
+ * whole document first, and adds the field values and weights to the Data as
+ * they are read. The position of each event is kept by the path of keys that
+ * leads to it, such as "/slots/-/time_periods/-/day", where "-" stands for
+ * an element of a sequence, and each value is handled by its path. Values
+ * with paths that are not part of the fields are skipped.
+ *
+ * The first invalid or missing value stops the loading with an error, which
+ * gives the line and column at which it was found. The weights that are not
+ * given keep the defaults of the Data.
+ */
+class FieldsLoader : public YAML::EventHandler {
+  private:
+    /**
+     * The Data to which the fields are added
+     */
+    Data &data;
+    /**
+     * The maps and sequences that the loader is inside, from the outermost
+     */
+    std::vector<FieldsNode> nodes;
+    /**
+     * The path of the innermost node
+     */
+    std::string path;
+    /**
+     * The path of the value being read, reused between values
+     */
+    std::string valuePath;
+    /**
+     * The number of the Classroom being read
+     */
+    std::string classroomNumber;
+    /**
+     * The size of the Classroom being read
+     */
+    unsigned classroomSize;
+    /**
+     * The name of the Slot being read
+     */
+    std::string slotName;
+    /**
+     * Whether the Slot being read is a minor Slot
+     */
+    bool slotIsMinor;
+    /**
+     * The slot elements of the Slot being read, one for each time period
+     */
+    std::vector<SlotElement> slotElements;
+    /**
+     * The Day of the time period being read
+     */
+    Day periodDay;
+    /**
+     * The start and end Time of the time period being read
+     */
+    Time periodStart, periodEnd;
+    /**
+     * The clause of the predefined weight being read
+     */
+    int clause;
+    /**
+     * The weight of the predefined weight being read
+     */
+    int clauseWeight;
+    /**
+     * The start of the segments
+     */
+    unsigned segmentStart;
+    /**
+     * The end of the segments
+     */
+    unsigned segmentEnd;
+    /**
+     * For each of the items being read, a bit for each of its values that was
+     * read, so that the missing ones are found when the item ends
+     */
+    unsigned classroomSeen, slotSeen, periodSeen, predefinedSeen, segmentsSeen;
+    /**
+     * The position of the document, to which values missing from the whole
+     * document are reported
+     */
+    YAML::Mark documentMark;
+    /**
+     * The error that stopped the loading, empty if there is none
+     */
+    std::string error;
+    /**
+     * The position of the error
+     */
+    YAML::Mark errorMark;
+    void fail(const YAML::Mark &, const std::string &);
+    void beginValue();
+    void endValue();
+    void beginNode(const YAML::Mark &, bool);
+    void endNode();
+    void onValue(const YAML::Mark &, const std::string &);
+    void onWeight(const YAML::Mark &, const std::string &, int);
+    void onMapEnd(const YAML::Mark &);
+    bool parseInt(const std::string &, int &);
+    bool parseBool(const std::string &, bool &);
+    bool parseDay(const std::string &, Day &);
+    bool parseTime(const std::string &, Time &);
+
+  public:
+    FieldsLoader(Data &);
+    bool load(std::istream &);
+    std::string getError();
+    int getErrorLine();
+    int getErrorColumn();
+    void OnDocumentStart(const YAML::Mark &) override;
+    void OnDocumentEnd() override;
+    void OnNull(const YAML::Mark &, YAML::anchor_t) override;
+    void OnAlias(const YAML::Mark &, YAML::anchor_t) override;
+    void OnScalar(const YAML::Mark &, const std::string &, YAML::anchor_t,
+                  const std::string &) override;
+    void OnSequenceStart(const YAML::Mark &, const std::string &,
+                         YAML::anchor_t, YAML::EmitterStyle::value) override;
+    void OnSequenceEnd() override;
+    void OnMapStart(const YAML::Mark &, const std::string &, YAML::anchor_t,
+                    YAML::EmitterStyle::value) override;
+    void OnMapEnd() override;
+};
+
+#endif
@@ -0,0 +1,83 @@
+/** @file */
+
+#ifndef GREEDY_SCHEDULER_H
+#define GREEDY_SCHEDULER_H
+
+#include "core/SolverTypes.h"
+#include "data.h"
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for the greedy scheduler.
+ *
+ * This is a constructive heuristic that works directly on the Data, without
+ * looking at the encoded formula. Courses are picked in DSatur order, that is,
+ * the Course whose time choices are most restricted by the already scheduled
+ * courses is picked next, with ties broken by its conflict degree. Each picked
+ * Course is then given the cheapest Segment, Slot and Classroom that do not
+ * clash with the courses scheduled so far, respecting the classroom capacity
+ * and the minor slot rules. The resulting assignment is given to the solver as
+ * phase hints, so that the first model it finds is already a good one.
+ */
+class GreedyScheduler {
+  private:
+    /**
+     * A reference to the Data for which the schedule is made
+     */
+    Data &data;
+    /**
+     * The courses conflicting with each Course, which are the courses that
+     * must not be scheduled at an intersecting time with it
+     */
+    std::vector<std::vector<int>> neighbours;
+    /**
+     * Stores whether each pair of slots is intersecting
+     */
+    std::vector<std::vector<bool>> slotIntersecting;
+    /**
+     * Stores whether each pair of segments is intersecting
+     */
+    std::vector<std::vector<bool>> segmentIntersecting;
+    /**
+     * The indices of the classrooms, in increasing order of size
+     */
+    std::vector<int> classroomsBySize;
+    /**
+     * The courses assigned to each Classroom so far
+     */
+    std::vector<std::vector<int>> classroomCourses;
+    /**
+     * The assigned Slot index of each Course, -1 if not assigned
+     */
+    std::vector<int> slots;
+    /**
+     * The assigned Segment index of each Course, -1 if not assigned
+     */
+    std::vector<int> segments;
+    /**
+     * The assigned Classroom index of each Course, -1 if not assigned
+     */
+    std::vector<int> classrooms;
+    void buildConflicts();
+    bool isEnabled(PredefinedClauses);
+    bool isHard(PredefinedClauses);
+    bool isIntersecting(int, int, int, int);
+    bool isMinorCourse(int);
+    bool hasProgramOfType(int, bool);
+    int existingValue(int, FieldType);
+    long long slotCost(int, int);
+    int findClassroom(int, int, int);
+    bool placeCourse(int);
+
+  public:
+    GreedyScheduler(Data &);
+    bool schedule();
+    int getSlot(int);
+    int getSegment(int);
+    int getClassroom(int);
+    std::vector<Lit> getPhaseHints();
+};
+
+#endif
@@ -0,0 +1,96 @@
+/** @file */
+
+#ifndef INSTANCE_FEATURES_H
+#define INSTANCE_FEATURES_H
+
+#include "MaxSATFormula.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace openwbo;
+
+/**
+ * @brief      Enum for the MaxSAT algorithms that TSolver can run.
+ */
+enum class MaxSATAlgorithm {
+    /**
+     * Pick the algorithm from the features of the instance
+     */
+    Auto,
+    /**
+     * OLL with all the soft clauses considered from the first SAT call
+     */
+    OLL,
+    /**
+     * OLL that considers the soft clauses in strata of decreasing weight
+     */
+    Stratified,
+    /**
+     * MSU3 with an incremental totalizer, for instances whose soft clauses
+     * all have the same weight
+     */
+    MSU3,
+    /**
+     * SAT-UNSAT linear search over the weight levels from the largest down,
+     * for instances whose weights are lexicographic
+     */
+    LinearSearch,
+    /**
+     * Stratified OLL for a limited number of cores or time, followed by
+     * SAT-UNSAT linear search over the objective that the cores reformulated
+     */
+    CoreBoosted
+};
+
+/**
+ * @brief      Class for the features of a MaxSAT instance, from which the
+ * algorithm used to solve it is picked.
+ */
+class InstanceFeatures {
+  public:
+    /**
+     * The number of variables
+     */
+    int vars;
+    /**
+     * The number of hard clauses
+     */
+    int hardClauses;
+    /**
+     * The number of soft clauses
+     */
+    int softClauses;
+    /**
+     * The number of soft clauses over the number of hard clauses
+     */
+    double softHardRatio;
+    /**
+     * The distinct weights of the soft clauses, in decreasing order
+     */
+    std::vector<uint64_t> weights;
+    /**
+     * Whether the weights are lexicographic (BMO), which is when each weight
+     * is larger than the total weight of all the soft clauses of smaller
+     * weights
+     */
+    bool lexicographic;
+    /**
+     * The number of hard clauses of each length, with the last entry counting
+     * all the longer clauses
+     */
+    std::vector<int> hardLengths;
+    /**
+     * The number of soft clauses of each length, with the last entry counting
+     * all the longer clauses
+     */
+    std::vector<int> softLengths;
+    InstanceFeatures(MaxSATFormula *);
+    MaxSATAlgorithm selectAlgorithm();
+    void print();
+};
+
+bool parseAlgorithm(const std::string &, MaxSATAlgorithm &);
+std::string algorithmName(MaxSATAlgorithm);
+
+#endif
@@ -0,0 +1,52 @@
+/** @file */
+
+#ifndef INTERACTIVE_H
+#define INTERACTIVE_H
+
+#include "constraint_encoder.h"
+#include "time_tabler.h"
+#include <istream>
+#include <string>
+
+/**
+ * @brief      Class for the interactive mode.
+ *
+ * This reads commands, one per line, that change the constraint groups of the
+ * TimeTabler or add new constraints, and solves again on request. The solver
+ * keeps its learnt clauses and, where they still hold, its cores between the
+ * solves, so a small change is solved much faster than the first timetable.
+ *
+ * The commands are:
+ * - groups: lists the constraint groups with their weights
+ * - enable i, disable i: switches group i on or off
+ * - weight i w: sets the weight of group i, -1 making it hard
+ * - add constraint: adds a custom constraint, written as in the custom
+ *   constraints file, as a new group
+ * - solve: solves again and writes the timetable to the output file
+ * - write file: writes the timetable to the file
+ * - quit: ends the interactive mode
+ */
+class Interactive {
+  private:
+    /**
+     * A pointer to the TimeTabler whose constraints are changed
+     */
+    TimeTabler *timeTabler;
+    /**
+     * A pointer to the ConstraintEncoder used for added constraints
+     */
+    ConstraintEncoder *encoder;
+    /**
+     * The output file to which each solved timetable is written
+     */
+    std::string outputFile;
+    bool readGroup(std::istream &, int &);
+    void listGroups();
+    void solve();
+
+  public:
+    Interactive(TimeTabler *, ConstraintEncoder *, std::string);
+    void run(std::istream &);
+};
+
+#endif
@@ -0,0 +1,153 @@
+/** @file */
+
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace NSPACE;
+using namespace openwbo;
+
+/**
+ * @brief      Class for the stochastic local search.
+ *
+ * This is a dynamic clause weighting local search in the style of SATLike,
+ * which works directly on the hard and soft clauses of a MaxSATFormula. It
+ * flips one variable at a time, preferring variables whose flip decreases the
+ * weight of the falsified clauses. When no such variable exists, the weights
+ * of the falsified clauses are increased, hard clauses faster than soft ones,
+ * and a variable from a random falsified clause is flipped. The best
+ * assignment satisfying all hard clauses is kept, and is given to the exact
+ * solver as its initial model and upper bound.
+ *
+ * The clauses and the occurrence lists are stored flat, with an array of
+ * start offsets into a single array of literals or clause indices, so that
+ * the clauses of a variable are read from contiguous memory.
+ */
+class LocalSearch {
+  private:
+    /**
+     * The number of variables
+     */
+    int nbVars;
+    /**
+     * The number of hard clauses, which are stored before the soft clauses
+     */
+    int nbHard;
+    /**
+     * The offset of the first literal of each clause in clauseLits, with one
+     * extra entry at the end
+     */
+    std::vector<int> clauseStart;
+    /**
+     * The literals of all the clauses, stored one clause after another
+     */
+    std::vector<Lit> clauseLits;
+    /**
+     * The offset of the first occurrence of each literal in occurClauses,
+     * indexed by toInt() of the literal, with one extra entry at the end
+     */
+    std::vector<int> occurStart;
+    /**
+     * The clauses in which each literal occurs, stored one literal after
+     * another
+     */
+    std::vector<int> occurClauses;
+    /**
+     * The weight of each soft clause in the formula, zero for hard clauses
+     */
+    std::vector<uint64_t> softWeight;
+    /**
+     * The current dynamic weight of each clause
+     */
+    std::vector<int64_t> clauseWeight;
+    /**
+     * The number of true literals in each clause
+     */
+    std::vector<int> trueCount;
+    /**
+     * The variable of a true literal of each clause, which is the only one
+     * when trueCount is one
+     */
+    std::vector<int> trueVar;
+    /**
+     * The change in the weight of the satisfied clauses if each variable is
+     * flipped
+     */
+    std::vector<int64_t> score;
+    /**
+     * The step at which each variable was last flipped
+     */
+    std::vector<uint64_t> lastFlip;
+    /**
+     * The current assignment
+     */
+    std::vector<bool> value;
+    /**
+     * The falsified clauses
+     */
+    std::vector<int> falsified;
+    /**
+     * The position of each clause in falsified, -1 if it is satisfied
+     */
+    std::vector<int> falsifiedIndex;
+    /**
+     * The number of falsified hard clauses
+     */
+    int nbFalsifiedHard;
+    /**
+     * The variables with a positive score
+     */
+    std::vector<int> goodVars;
+    /**
+     * The position of each variable in goodVars, -1 if not present
+     */
+    std::vector<int> goodIndex;
+    /**
+     * The total weight of the falsified soft clauses
+     */
+    uint64_t softCost;
+    /**
+     * The best assignment found that satisfies all hard clauses
+     */
+    std::vector<bool> bestValue;
+    /**
+     * The cost of the best assignment, UINT64_MAX if none has been found
+     */
+    uint64_t bestCost;
+    /**
+     * The number of flips made so far
+     */
+    uint64_t flips;
+    /**
+     * The random number generator, seeded for reproducible runs
+     */
+    std::mt19937 generator;
+    /**
+     * The value of each variable in the initial assignment, with the
+     * variables that have no given value picked randomly
+     */
+    std::vector<bool> initialValue;
+    void addClause(const vec<Lit> &, uint64_t);
+    bool isTrue(Lit);
+    void initialize();
+    void setFalsified(int, bool);
+    void updateGoodVar(int);
+    void flip(int);
+    void updateWeights();
+    int pickVar();
+
+  public:
+    LocalSearch(MaxSATFormula *, unsigned);
+    void setInitialAssignment(const std::vector<Lit> &);
+    bool search(uint64_t);
+    std::vector<lbool> getBestModel();
+    uint64_t getBestCost();
+    uint64_t getFlips();
+};
+
+#endif
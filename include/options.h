@@ -0,0 +1,190 @@
+/** @file */
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief      Class for the command line options.
+ *
+ * The program is run with the paths of the fields, input, custom constraints
+ * and output files, in that order. These can be followed by optional flags,
+ * each of which takes a single value.
+ *
+ * Run as "compile" followed by the same paths, the instance is compiled to the
+ * output file instead of being solved. Run as "--load-compiled" followed by
+ * the paths of a compiled instance and the output file, the instance is
+ * loaded from the compiled instance instead of being parsed and encoded.
+ */
+class Options {
+  public:
+    /**
+     * The path of the file containing the fields
+     */
+    std::string fieldsFile;
+    /**
+     * The path of the file containing the input
+     */
+    std::string inputFile;
+    /**
+     * The path of the file containing the custom constraints
+     */
+    std::string customFile;
+    /**
+     * The path of the file to which the output is written
+     */
+    std::string outputFile;
+    /**
+     * The time in seconds for which the large neighbourhood search improves
+     * the timetable after it is solved. Zero disables the search.
+     */
+    double lnsTimeLimit;
+    /**
+     * The conflict budget of each SAT call made by the large neighbourhood
+     * search
+     */
+    int64_t lnsBudget;
+    /**
+     * The maximum number of flips of the local search run before the exact
+     * search. Zero disables the local search.
+     */
+    uint64_t localSearchFlips;
+    /**
+     * The time in seconds for which the annealer makes the timetable instead
+     * of the MaxSAT solver. Zero uses the MaxSAT solver.
+     */
+    double annealTimeLimit;
+    /**
+     * The number of threads, used by the annealer to run independent chains
+     * and to solve the components of a decomposed formula
+     */
+    int threads;
+    /**
+     * Whether the cores found by the solver are trimmed
+     */
+    bool coreTrimming;
+    /**
+     * Whether the cores found by the solver are minimized
+     */
+    bool coreMinimization;
+    /**
+     * Whether the bounds of the cores found by the solver are exhausted
+     */
+    bool coreExhaustion;
+    /**
+     * The conflict budget of each SAT call made to reduce a core
+     */
+    int64_t coreBudget;
+    /**
+     * The conflict budget of the first SAT call of the core guided search,
+     * zero if its calls are not budgeted
+     */
+    int64_t satBudget;
+    /**
+     * The factor by which the SAT call budget grows each time it runs out
+     */
+    double satBudgetGrowth;
+    /**
+     * The number of times in a row a SAT call may run out of its budget
+     * before the best model found is kept
+     */
+    int satBudgetRetries;
+    /**
+     * The conflict budget of each SAT call made to seed the upper bound
+     */
+    int64_t seedBudget;
+    /**
+     * The name of the MaxSAT algorithm, or auto to pick it from the instance
+     */
+    std::string algorithm;
+    /**
+     * The number of cores after which the core-boosted algorithm switches to
+     * linear search, zero for no limit
+     */
+    int coreBoostCores;
+    /**
+     * The time in seconds after which the core-boosted algorithm switches to
+     * linear search, zero for no limit
+     */
+    double coreBoostTime;
+    /**
+     * Whether the high level variables, the existing assignments and the
+     * constraints are optimized lexicographically, in that order
+     */
+    bool lexicographic;
+    /**
+     * The number of timetables enumerated, best first
+     */
+    int enumerateCount;
+    /**
+     * The minimum number of slot and classroom assignments in which each
+     * enumerated timetable differs from the ones before it
+     */
+    int enumerateDistance;
+    /**
+     * Whether the SAT solver is benchmarked on the instance instead of
+     * solving it
+     */
+    bool satBenchmark;
+    /**
+     * Whether loading the fields file is timed instead of solving the
+     * instance
+     */
+    bool fieldsBenchmark;
+    /**
+     * Whether the constraints can be changed from standard input after
+     * solving, to solve again incrementally
+     */
+    bool interactive;
+    /**
+     * Whether the formula is split into independent components, which are
+     * solved separately
+     */
+    bool decompose;
+    /**
+     * Whether the times are solved first and the classrooms second
+     */
+    bool hierarchical;
+    /**
+     * Whether the classrooms of the hierarchical mode are assigned by
+     * matching instead of the SAT solver, where that is exact
+     */
+    bool roomMatching;
+    /**
+     * The file from which the solver state of an earlier run is read, and to
+     * which it is saved after solving, empty if none
+     */
+    std::string stateFile;
+    /**
+     * Whether the parsed and encoded instance is written to the output file
+     * instead of being solved
+     */
+    bool compile;
+    /**
+     * The compiled instance from which the instance is loaded, empty if it is
+     * parsed and encoded from the fields, input and custom constraints files
+     */
+    std::string compiledFile;
+    /**
+     * Whether the SAT solver decides the slot, segment and classroom
+     * variables first, most constrained courses first
+     */
+    bool branching;
+    /**
+     * Whether the greedy schedule is made and given to the solver as phase
+     * hints and as a seed of the upper bound
+     */
+    bool greedy;
+    /**
+     * The seed for all randomized choices, so that runs are reproducible
+     */
+    unsigned seed;
+    Options();
+    bool parseSwitch(std::string);
+    bool parse(int, char const *[]);
+    void printUsage(std::string);
+};
+
+#endif
@@ -3,7 +3,7 @@
 #ifndef PARSER_H
 #define PARSER_H
 
-#include "CSVparser.hpp"
+#include "csv_reader.h"
 #include "data.h"
 #include "time_tabler.h"
 #include <string>
@@ -20,12 +20,12 @@ class Parser {
      * A pointer to the TimeTabler object
      */
     TimeTabler *timeTabler;
-    Day getDayFromString(std::string);
 
   public:
     Parser(TimeTabler *);
-    void parseFields(std::string file);
-    void parseInput(std::string file);
+    bool parseFields(std::string file);
+    void benchmarkFields(std::string file);
+    bool parseInput(std::string file);
     void addVars();
 };
 
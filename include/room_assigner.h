@@ -0,0 +1,68 @@
+/** @file */
+
+#ifndef ROOM_ASSIGNER_H
+#define ROOM_ASSIGNER_H
+
+#include "core/SolverTypes.h"
+#include "data.h"
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for the room assigner.
+ *
+ * This assigns the classrooms once the slots and segments are decided,
+ * without a SAT solver. The courses that are to be given a Classroom are
+ * split into groups of courses meeting at intersecting times. Each group is
+ * then given distinct classrooms by a minimum cost bipartite matching
+ * between its courses and the classrooms large enough for them, where the
+ * cost of a Classroom is the weight of the existing assignments it breaks.
+ *
+ * When all the courses of a group meet at intersecting times, they need
+ * distinct classrooms, so the matching is optimal, and if there is none the
+ * times of the group have no valid classroom assignment. Otherwise distinct
+ * classrooms are only sufficient, and a group with no matching is left to
+ * the SAT solver.
+ *
+ * This is only exact when the classroom constraints are hard and no custom
+ * constraint mentions classrooms, see isApplicable().
+ */
+class RoomAssigner {
+  private:
+    /**
+     * A reference to the Data for which the classrooms are assigned
+     */
+    Data &data;
+    /**
+     * The cost of giving each Classroom to each Course, -1 if it cannot be
+     * given
+     */
+    std::vector<std::vector<long long>> roomCost;
+    /**
+     * Stores whether each pair of slots is intersecting
+     */
+    std::vector<std::vector<bool>> slotIntersecting;
+    /**
+     * Stores whether each pair of segments is intersecting
+     */
+    std::vector<std::vector<bool>> segmentIntersecting;
+    /**
+     * The slots of each Course that are True in the model being assigned
+     */
+    std::vector<std::vector<int>> slotsOf;
+    /**
+     * The segments of each Course that are True in the model being assigned
+     */
+    std::vector<std::vector<int>> segmentsOf;
+    bool isClashing(int, int);
+    bool match(const std::vector<int> &, std::vector<int> &, long long &);
+
+  public:
+    RoomAssigner(Data &);
+    bool isApplicable();
+    bool assign(const std::vector<lbool> &, std::vector<int> &,
+                std::vector<std::vector<int>> &, long long &);
+};
+
+#endif
@@ -0,0 +1,85 @@
+/** @file */
+
+#ifndef SOLVER_STATE_H
+#define SOLVER_STATE_H
+
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace NSPACE;
+using namespace openwbo;
+
+/**
+ * @brief      Class for the solver state carried over from one run to the
+ * next.
+ *
+ * The state is the best model, the lower bound proven on its cost, and the
+ * clauses learnt while solving that the hard clauses imply. It is saved over
+ * the names of the variables, so that it can be read back for an input whose
+ * courses or field values were added, removed or reordered.
+ *
+ * The hard clauses are hashed in the groups in which they were added, such as
+ * the clauses of one predefined or custom constraint. The learnt clauses still
+ * hold if every saved group is left unchanged, whatever groups were added. The
+ * lower bound only holds if the soft clauses are unchanged too. The model is
+ * always usable as phase hints.
+ */
+class SolverState {
+  private:
+    /**
+     * The name of each variable of the formula, empty if it has none
+     */
+    std::vector<std::string> names;
+    /**
+     * The hash of each group of hard clauses of the formula, sorted
+     */
+    std::vector<uint64_t> groupHashes;
+    /**
+     * The hash of the soft clauses of the formula
+     */
+    uint64_t softHash;
+    /**
+     * The group hashes of the saved state, sorted
+     */
+    std::vector<uint64_t> savedGroupHashes;
+    /**
+     * The soft clause hash of the saved state
+     */
+    uint64_t savedSoftHash;
+    /**
+     * The saved lower bound
+     */
+    uint64_t savedLowerBound;
+    /**
+     * The saved model, over the variables of the formula, l_Undef for the
+     * variables that were not saved
+     */
+    std::vector<lbool> savedModel;
+    /**
+     * The saved learnt clauses whose variables all exist in the formula, over
+     * the variables of the formula
+     */
+    std::vector<std::vector<Lit>> savedLearnts;
+    uint64_t hashName(const std::string &);
+    uint64_t hashClause(const vec<Lit> &, const std::vector<uint64_t> &,
+                        std::unordered_map<Var, int> &);
+
+  public:
+    SolverState(const std::vector<std::string> &, MaxSATFormula *,
+                const std::vector<std::pair<int, int>> &);
+    bool read(const std::string &);
+    bool write(const std::string &, const std::vector<lbool> &, uint64_t,
+               const std::vector<std::vector<Lit>> &);
+    bool keepsHardClauses();
+    bool isUnchanged();
+    std::vector<Lit> getModelHints();
+    std::vector<std::vector<Lit>> getLearnts();
+    uint64_t getLowerBound();
+};
+
+#endif
@@ -0,0 +1,36 @@
+/** @file */
+
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief      Class for a table of interned names.
+ *
+ * Each distinct name is stored once and given a dense integer id, in the order
+ * in which the names are first interned. The fields store these ids in place
+ * of their names, so that comparing two of them compares two integers, and a
+ * name is only looked up when it is output.
+ */
+class SymbolTable {
+  private:
+    /**
+     * The name of each id
+     */
+    std::vector<std::string> names;
+    /**
+     * The id of each name
+     */
+    std::unordered_map<std::string, int> ids;
+
+  public:
+    int intern(const std::string &);
+    int find(const std::string &) const;
+    const std::string &getName(int) const;
+    int size() const;
+};
+
+#endif
@@ -7,11 +7,17 @@
 #include "cclause.h"
 #include "core/SolverTypes.h"
 #include "data.h"
+#include "decomposition.h"
 #include "mtl/Vec.h"
+#include "options.h"
+#include "solver_state.h"
 #include "tsolver.h"
+#include <random>
+#include <string>
+#include <utility>
 #include <vector>
 
-using namespace Minisat;
+using namespace NSPACE;
 
 /**
  * @brief      Enum to store the solver status
@@ -31,6 +37,52 @@ enum SolverStatus {
     Unsolved
 };
 
+/**
+ * @brief      Enum for the objective levels of the soft clauses, from the most
+ * important, used when the levels are optimized lexicographically
+ */
+enum ObjectiveLevel {
+    /**
+     * The high level variables, which are True when a Course gets a valid
+     * value for a field
+     */
+    HighLevelObjective,
+    /**
+     * The existing assignments, whose violation changes the given timetable
+     */
+    AssignmentObjective,
+    /**
+     * The soft predefined and custom constraints
+     */
+    ConstraintObjective
+};
+
+/**
+ * @brief      Struct for a group of clauses added together, which can be
+ * switched off and on between solves in incremental mode.
+ *
+ * Each clause of the group is guarded by the negation of the selector, so
+ * the group is enforced only while the selector is assumed True.
+ */
+struct ConstraintGroup {
+    /**
+     * The clauses of the group, without the selector
+     */
+    std::vector<std::vector<Lit>> clauses;
+    /**
+     * The weight of the clauses, negative if they are hard
+     */
+    int weight;
+    /**
+     * The selector guarding the clauses
+     */
+    Lit selector;
+    /**
+     * Whether the selector is assumed in the next solve
+     */
+    bool enabled;
+};
+
 /**
  * @brief      Class for time tabler.
  *
@@ -55,6 +107,83 @@ class TimeTabler {
      * Stores the values of each solver variable to be checked after solving
      */
     std::vector<lbool> model;
+    /**
+     * Stores the literals given to the solver as phase hints, which are the
+     * existing assignments and the high level variables being True
+     */
+    std::vector<Lit> phaseHints;
+    /**
+     * The phase hints of the greedy schedule, which come before the other
+     * hints, so that the existing assignments override them
+     */
+    std::vector<Lit> greedyHints;
+    /**
+     * The ObjectiveLevel of each soft clause in the formula
+     */
+    std::vector<int> softClauseLevels;
+    /**
+     * Whether the objective levels are optimized lexicographically instead of
+     * optimizing the total weight
+     */
+    bool lexicographic;
+    /**
+     * Whether the clauses are added in groups guarded by selectors, so that
+     * the timetable can be solved again after changing the constraints
+     */
+    bool incremental;
+    /**
+     * Whether the formula was loaded into the solver, after which new
+     * variables and clauses go to the solver directly
+     */
+    bool solverLoaded;
+    /**
+     * The constraint groups, in the order in which they were added
+     */
+    std::vector<ConstraintGroup> groups;
+    /**
+     * The command line options, kept to configure the solvers of the
+     * components when the formula is decomposed
+     */
+    Options options;
+    /**
+     * The range of the hard clauses of the formula added by each call to
+     * addClauses(), addHighLevelClauses() and addExistingAssignments(), as
+     * the groups hashed to check a saved state
+     */
+    std::vector<std::pair<int, int>> hardGroups;
+    /**
+     * The state carried over between runs, NULL if no state file is used
+     */
+    SolverState *state;
+    SolverStatus getStatus();
+    bool configureSolver(TSolver *);
+    std::vector<Lit> uniqueHints();
+    std::vector<Lit> assignmentHints();
+    void loadSolver();
+    std::vector<std::vector<lbool>>
+    solveComponents(Decomposition &, const std::vector<Lit> &, uint64_t &);
+    std::vector<bool> classroomVars();
+    void addAtMost(MaxSATFormula *, const std::vector<Lit> &, int);
+    void addCapacityConstraints(MaxSATFormula *);
+    MaxSATFormula *buildTimeFormula(const std::vector<bool> &);
+    MaxSATFormula *buildRoomFormula(const std::vector<lbool> &,
+                                    const std::vector<bool> &,
+                                    std::vector<std::vector<Lit>> &);
+    void solveHierarchical();
+    void addGroupClauses(int);
+    void addHardGroup(int);
+    std::vector<Lit> enabledSelectors();
+    std::vector<bool> pickNeighbourhood(int, std::mt19937 &);
+    MaxSATFormula *buildNeighbourhoodFormula(const std::vector<lbool> &,
+                                             uint64_t &);
+    std::vector<lbool> solveNeighbourhood(const std::vector<lbool> &,
+                                          const std::vector<Lit> &, int64_t,
+                                          unsigned, uint64_t &);
+    uint64_t modelCost(const std::vector<lbool> &);
+    std::vector<std::string> variableNames();
+    std::vector<double> branchingPriorities();
+    std::string fieldValueName(FieldType, int);
+    void loadState();
 
   public:
     /**
@@ -63,11 +192,27 @@ class TimeTabler {
     Data data;
     TimeTabler();
     ~TimeTabler();
-    void addClauses(const std::vector<CClause> &, int);
-    void addClauses(const Clauses &, int);
+    bool configure(const Options &);
+    int addClauses(const std::vector<CClause> &, int);
+    int addClauses(const Clauses &, int);
+    int getGroupCount();
+    int getGroupWeight(int);
+    bool isGroupEnabled(int);
+    void enableGroup(int);
+    void disableGroup(int);
+    void setGroupWeight(int, int);
+    SolverStatus resolve();
     bool checkAllTrue(const std::vector<Var> &);
     bool isVarTrue(const Var &);
     SolverStatus solve();
+    void benchmarkSATSolver();
+    void saveState();
+    bool writeCompiled(std::string);
+    bool loadCompiled(std::string);
+    SolverStatus improve(double, unsigned);
+    SolverStatus nextSolution(int);
+    void enumerate(int, int, std::string);
+    SolverStatus anneal(double, unsigned, int);
     Var newVar();
     Lit newLiteral(bool);
     void printResult(SolverStatus);
@@ -77,6 +222,9 @@ class TimeTabler {
     void writeOutput(std::string);
     void addExistingAssignments();
     void addToFormula(vec<Lit> &, int);
+    void addToFormula(vec<Lit> &, int, ObjectiveLevel);
+    void addPhaseHints(const std::vector<Lit> &);
+    void addGreedyHints(const std::vector<Lit> &);
     void displayChangesInGivenAssignment();
 };
 
@@ -0,0 +1,25 @@
+/** @file */
+
+#ifndef TSAT_SOLVER_H
+#define TSAT_SOLVER_H
+
+#include "core/Solver.h"
+#include "core/SolverTypes.h"
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for the SAT solver used by TSolver.
+ *
+ * This is the SAT solver that Open WBO is built with, extended to give access
+ * to the state that MiniSat keeps protected, so that what it has learnt can
+ * be carried over to later runs, and its branching can be seeded.
+ */
+class TSATSolver : public Solver {
+  public:
+    std::vector<std::vector<Lit>> getLearnts(int, Var);
+    void setActivity(Var, double);
+};
+
+#endif
@@ -5,10 +5,15 @@
 
 #include "MaxSAT.h"
 #include "algorithms/Alg_OLL.h"
+#include "instance_features.h"
 #include "mtl/Vec.h"
+#include <chrono>
+#include <random>
+#include <set>
+#include <string>
 #include <vector>
 
-using namespace Minisat;
+using namespace NSPACE;
 using namespace openwbo;
 
 /**
@@ -20,13 +25,355 @@ using namespace openwbo;
  * identical. The differences are that tSearch() does not print
  * the output to stdout and exit, instead, it returns the model.
  * tWeighted() also does not print to stdout, when the solver
- * terminates, it simply returns.
+ * terminates, it simply returns. For instances that suit them
+ * better, it also runs the MSU3 and linear search algorithms as
+ * tMSU3() and tLinear().
  */
 class TSolver : public OLL {
+  private:
+    /**
+     * Literals whose polarity is given to the SAT solver before the first
+     * search, typically the existing assignments given in the input
+     */
+    std::vector<Lit> phaseHints;
+    /**
+     * The sets of literals under which a first model is searched for before
+     * the search, to seed the upper bound
+     */
+    std::vector<std::vector<Lit>> seeds;
+    /**
+     * The name of each seed, printed with the cost of its model
+     */
+    std::vector<std::string> seedNames;
+    /**
+     * The conflict budget of each SAT call made to seed the upper bound
+     */
+    int64_t seedBudget;
+    /**
+     * Whether the search prints nothing, as for the many small searches of
+     * the large neighbourhood search
+     */
+    bool quiet;
+    /**
+     * The number of soft clauses in the formula before solving, as the
+     * solver splits soft clauses and adds new ones while solving
+     */
+    int nbOriginalSoft;
+    /**
+     * The weights of the original soft clauses before solving
+     */
+    std::vector<uint64_t> originalWeights;
+    /**
+     * The maximum number of flips of the local search run before the exact
+     * search. Zero disables the local search.
+     */
+    uint64_t localSearchFlips;
+    /**
+     * The seed of the local search
+     */
+    unsigned localSearchSeed;
+    /**
+     * The best model found by the local search, empty if none was found
+     */
+    std::vector<lbool> initialModel;
+    /**
+     * The index of the soft clause relaxed by each variable, -1 if the
+     * variable is not the assumption variable of a soft clause
+     */
+    std::vector<int> softOfVar;
+    /**
+     * The index in cardinalityEncoders of the encoder of each variable that is
+     * a bound output, -1 if the variable is not a bound output
+     */
+    std::vector<int> boundEncoder;
+    /**
+     * The bound enforced by each bound output
+     */
+    std::vector<uint64_t> boundValue;
+    /**
+     * The weight of violating the bound of each bound output
+     */
+    std::vector<uint64_t> boundWeight;
+    /**
+     * The bound outputs whose bounds are being enforced
+     */
+    std::vector<Lit> boundOutputs;
+    /**
+     * The position of each variable in boundOutputs, -1 if not present
+     */
+    std::vector<int> boundOutputPosition;
+    /**
+     * The assumptions of the next SAT call of the core guided search
+     */
+    vec<Lit> coreAssumptions;
+    /**
+     * The position of each variable in coreAssumptions, -1 if not assumed
+     */
+    std::vector<int> assumptionPosition;
+    /**
+     * Stores whether the soft clause of each assumption variable has been
+     * hardened
+     */
+    std::vector<bool> hardened;
+    /**
+     * The largest weight of a soft clause or bound output that could still be
+     * hardened, as of the last time they were scanned
+     */
+    uint64_t hardeningWeight;
+    /**
+     * The cardinality encoders built for the cores, owned by this object
+     */
+    std::vector<Encoder *> cardinalityEncoders;
+    /**
+     * Whether each core is trimmed by solving it again until it stops
+     * shrinking
+     */
+    bool coreTrimming;
+    /**
+     * Whether each core is minimized by deleting literals
+     */
+    bool coreMinimization;
+    /**
+     * Whether the bound of each new cardinality encoder is raised while the
+     * hard clauses show that it must be
+     */
+    bool coreExhaustion;
+    /**
+     * The conflict budget of each SAT call made to reduce a core
+     */
+    int64_t coreBudget;
+    /**
+     * The number of SAT calls made to trim cores
+     */
+    uint64_t trimCalls;
+    /**
+     * The number of literals removed from cores by trimming
+     */
+    uint64_t trimmedLits;
+    /**
+     * The number of SAT calls made to minimize cores
+     */
+    uint64_t minimizeCalls;
+    /**
+     * The number of literals removed from cores by minimization
+     */
+    uint64_t minimizedLits;
+    /**
+     * The number of cores whose bounds were exhausted
+     */
+    uint64_t exhaustCalls;
+    /**
+     * The number of times a bound was raised by exhaustion
+     */
+    uint64_t exhaustedBounds;
+    /**
+     * The MaxSAT algorithm requested, which may be MaxSATAlgorithm::Auto
+     */
+    MaxSATAlgorithm algorithm;
+    /**
+     * The MaxSAT algorithm run by the last call to tSearch()
+     */
+    MaxSATAlgorithm selectedAlgorithm;
+    /**
+     * The objective level of each soft clause, empty if the total weight is
+     * optimized instead
+     */
+    std::vector<int> softLevel;
+    /**
+     * The objective level being optimized, -1 if all the soft clauses are
+     * searched together
+     */
+    int currentLevel;
+    /**
+     * The optimal cost of each objective level found by the last
+     * lexicographic search
+     */
+    std::vector<uint64_t> levelCosts;
+    /**
+     * Whether the search is kept resumable after the optimum is found
+     */
+    bool resumable;
+    /**
+     * The selectors of the enabled constraint groups, assumed True in every
+     * SAT call
+     */
+    vec<Lit> selectorAssumptions;
+    /**
+     * The variables of selectorAssumptions
+     */
+    std::set<Var> assumedSelectors;
+    /**
+     * The selectors that appeared in a conflict since the cores were last
+     * dropped
+     */
+    std::set<Var> coreSelectors;
+    /**
+     * Whether a selector in coreSelectors was disabled, so that the cores no
+     * longer hold
+     */
+    bool coresInvalid;
+    /**
+     * Whether the search only adds clauses that the hard clauses imply, so
+     * that its learnt clauses and cores hold in later runs
+     */
+    bool persistent;
+    /**
+     * The number of variables in the formula before the soft clauses are
+     * relaxed
+     */
+    Var nbOriginalVars;
+    /**
+     * The cores found over unit soft clauses, each as the clause that the
+     * hard clauses imply
+     */
+    std::vector<std::vector<Lit>> recordedCores;
+    /**
+     * A lower bound on the optimal cost known before the search
+     */
+    uint64_t knownLowerBound;
+    /**
+     * The conflict budget of the first SAT call of the core guided search,
+     * zero if its calls are not budgeted
+     */
+    int64_t satBudget;
+    /**
+     * The factor by which the budget grows each time it runs out
+     */
+    double satBudgetGrowth;
+    /**
+     * The number of times in a row that a SAT call may run out of its budget
+     * before the search stops with the best model found
+     */
+    int satBudgetRetries;
+    /**
+     * The conflict budget of the next SAT call of the core guided search
+     */
+    int64_t currentBudget;
+    /**
+     * The random generator used to reorder the assumptions
+     */
+    std::mt19937 budgetRandom;
+    /**
+     * The number of budgeted SAT calls made
+     */
+    uint64_t budgetedCalls;
+    /**
+     * The number of budgeted SAT calls that ran out of their budget
+     */
+    uint64_t exhaustedCalls;
+    /**
+     * Whether the search stopped with the best model found, as the SAT calls
+     * kept running out of their budget
+     */
+    bool budgetStopped;
+    /**
+     * Whether a neighbourhood of the large neighbourhood search is being
+     * searched, see searchNeighbourhood()
+     */
+    bool inNeighbourhood;
+    /**
+     * The number of cores after which the core phase of the core-boosted
+     * search ends, zero for no limit
+     */
+    int coreBoostCores;
+    /**
+     * The time in seconds after which the core phase of the core-boosted
+     * search ends, zero for no limit
+     */
+    double coreBoostTime;
+    /**
+     * Whether the core phase of the core-boosted search is running
+     */
+    bool boosting;
+    /**
+     * The time at which the core phase of the core-boosted search started
+     */
+    std::chrono::steady_clock::time_point boostStart;
+    /**
+     * Whether bounds on the objective were added to the SAT solver as hard
+     * clauses, after which its learnt clauses no longer follow from the hard
+     * clauses alone
+     */
+    bool boundsAdded;
+    /**
+     * The initial VSIDS activity of each variable, zero to leave it to the
+     * SAT solver
+     */
+    std::vector<double> branchingPriorities;
+    Solver *rebuildSolver();
+    void recordCore(const vec<Lit> &);
+    lbool budgetedSearch();
+    void diversify();
+    void applyPhaseHints();
+    void applyBranchingPriorities();
+    void seedUpperBound();
+    void runLocalSearch();
+    void applyInitialModel();
+    void growVarArrays(Var);
+    void mapSoftClause(int);
+    int softClauseOf(Lit);
+    bool isBoundOutput(Lit);
+    void addAssumption(Lit);
+    void removeAssumption(Lit);
+    void addBoundOutput(Lit, int, uint64_t, uint64_t);
+    void removeBoundOutput(Lit);
+    void resetAssumptions();
+    void restartCores();
+    uint64_t nextWeight(uint64_t);
+    uint64_t nextWeightDiversity(uint64_t);
+    bool hasUnconsideredWeight();
+    void hardenSoftClauses();
+    void clearCoreState();
+    lbool checkCore(const vec<Lit> &);
+    void trimCore(vec<Lit> &);
+    void minimizeCore(vec<Lit> &);
+    uint64_t exhaustCore(int, uint64_t);
+    lbool solveWithBudget(const vec<Lit> &, int64_t, vec<lbool> &);
+    lbool searchSATSolver(Solver *, vec<Lit> &, bool pre = false);
+    void prepareSearch();
+    void tMSU3();
+    void tLinear();
+    void tCoreBoosted();
+    bool isCorePhaseOver();
+    void tLexicographic();
+    void freezeLevel();
+    bool isSearched(int);
+    uint64_t searchCost(vec<lbool> &);
+
   public:
     TSolver(int, int);
+    ~TSolver();
+    void setPhaseHints(const std::vector<Lit> &);
+    void addSeed(const std::string &, const std::vector<Lit> &);
+    void setSeedBudget(int64_t);
+    void setQuiet(bool);
+    void setBranchingPriorities(const std::vector<double> &);
+    void setAlgorithm(MaxSATAlgorithm);
+    void setObjectiveLevels(const std::vector<int> &);
+    void setResumable(bool);
+    void setPersistent(bool);
+    void setKnownLowerBound(uint64_t);
+    std::vector<std::vector<Lit>> getLearnts(int);
+    uint64_t getLowerBound();
+    void blockModel(const std::vector<Lit> &, int);
+    std::vector<lbool> resumeSearch();
+    std::vector<lbool> searchNeighbourhood(const std::vector<Lit> &,
+                                           const std::vector<Lit> &, int64_t);
+    void setSelectors(const std::vector<Lit> &);
+    Var newVar();
+    void addHardClause(vec<Lit> &);
+    void addSoftClause(uint64_t, vec<Lit> &);
+    std::vector<uint64_t> getLevelCosts();
+    void setLocalSearch(uint64_t, unsigned);
+    void setCoreOptions(bool, bool, bool, int64_t);
+    void setSATBudget(int64_t, double, int, unsigned);
+    void setCoreBoost(int, double);
+    void printCoreStatistics();
+    void benchmarkSATSolver();
     std::vector<lbool> tSearch();
-    void tWeighted();
+    void tWeighted(bool);
+    std::vector<lbool> getModel();
+    uint64_t getCost();
 };
 
 #endif
\ No newline at end of file
@@ -31,14 +31,6 @@ cmake ..
 make -j4
 cd ../..
 
-echo "Getting CSVparser..."
-if [ ! -d CSVparser ] ; then
-  git clone https://github.com/MyBoon/CSVparser.git
-fi
-cd CSVparser
-git checkout 540e3e2
-cd ..
-
 echo "Getting PEGTL..."
 if [ ! -d PEGTL-2.2.0 ] ; then
   wget https://github.com/taocpp/PEGTL/archive/2.2.0.tar.gz
@@ -0,0 +1,610 @@
+#include "annealer.h"
+
+#include "core/SolverTypes.h"
+#include "data.h"
+#include "global.h"
+#include "greedy_scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * @brief      Constructs the Annealer object.
+ *
+ * @param      data  The data for which the timetable is made
+ */
+Annealer::Annealer(Data &data) : data(data) {
+    timeCount = 0;
+    hardWeight = 1;
+    tabuTenure = 0;
+    moves = 0;
+    best.penalty.hard = 0;
+    best.penalty.soft = 0;
+}
+
+/**
+ * @brief      Adds a number of violations of a constraint to a Penalty.
+ *
+ * @param      penalty  The penalty
+ * @param[in]  weight   The weight of the constraint, negative if it is hard
+ * @param[in]  count    The number of violations, negative to remove them
+ */
+void Annealer::addViolations(Penalty &penalty, int weight, long long count) {
+    if (weight < 0) {
+        penalty.hard += count;
+    } else {
+        penalty.soft += count * weight;
+    }
+}
+
+/**
+ * @brief      Gets the Penalty of the existing assignment clauses of a
+ * FieldType of a Course, if it is given a value.
+ *
+ * Each existing assignment is a unit clause, so changing a given value
+ * violates two of them, one for the old value and one for the new value.
+ *
+ * @param[in]  course     The course
+ * @param[in]  fieldType  The field type
+ * @param[in]  value      The index of the field value
+ *
+ * @return     The penalty
+ */
+Penalty Annealer::existingPenalty(int course, FieldType fieldType,
+                                  int value) {
+    Penalty penalty = {0, 0};
+    std::vector<lbool> &existing =
+        data.existingAssignmentVars[course][fieldType];
+    long long count = 0;
+    for (int i = 0; i < existing.size(); i++) {
+        if ((existing[i] == l_True && i != value) ||
+            (existing[i] == l_False && i == value)) {
+            count++;
+        }
+    }
+    addViolations(penalty, data.existingAssignmentWeights[fieldType], count);
+    return penalty;
+}
+
+/**
+ * @brief      Gets the time of a (Slot, Segment) pair.
+ *
+ * @param[in]  slot     The slot
+ * @param[in]  segment  The segment
+ *
+ * @return     The index of the time
+ */
+int Annealer::timeOf(int slot, int segment) {
+    return slot * data.segments.size() + segment;
+}
+
+/**
+ * @brief      Precomputes the intersecting times, the core programs and
+ * allowed classrooms of every Course, and the Penalty of giving each field
+ * value to each Course.
+ */
+void Annealer::precompute() {
+    int courseCount = data.courses.size();
+    int segmentCount = data.segments.size();
+    timeCount = data.slots.size() * segmentCount;
+    overlapping.assign(timeCount, std::vector<int>());
+    for (int t1 = 0; t1 < timeCount; t1++) {
+        for (int t2 = 0; t2 < timeCount; t2++) {
+            Slot &slot = data.slots[t1 / segmentCount];
+            Segment &segment = data.segments[t1 % segmentCount];
+            if (slot.isIntersecting(data.slots[t2 / segmentCount]) &&
+                segment.isIntersecting(data.segments[t2 % segmentCount])) {
+                overlapping[t1].push_back(t2);
+            }
+        }
+    }
+
+    std::vector<int> &weights = data.predefinedClausesWeights;
+    bool programClashes =
+        weights[PredefinedClauses::programSingleCoreCourseAtATime] != 0;
+    corePrograms.assign(courseCount, std::vector<int>());
+    allowedClassrooms.assign(courseCount, std::vector<int>());
+    slotPenalty.assign(courseCount, std::vector<Penalty>());
+    segmentPenalty.assign(courseCount, std::vector<Penalty>());
+    classroomPenalty.assign(courseCount, std::vector<Penalty>());
+    for (int i = 0; i < courseCount; i++) {
+        Course &course = data.courses[i];
+        bool core = false;
+        bool elective = false;
+        std::vector<int> programs = course.getPrograms();
+        for (int j = 0; j < programs.size(); j++) {
+            if (data.programs[programs[j]].isCoreProgram()) {
+                core = true;
+                if (programClashes) {
+                    corePrograms[i].push_back(programs[j]);
+                }
+            } else {
+                elective = true;
+            }
+        }
+        bool minor = data.isMinors[course.getIsMinor()].getMinorType() ==
+                     MinorType::isMinorCourse;
+        for (int j = 0; j < data.slots.size(); j++) {
+            Penalty penalty = existingPenalty(i, FieldType::slot, j);
+            bool morning = data.slots[j].isMorningSlot();
+            if (data.slots[j].isMinorSlot() != minor) {
+                addViolations(penalty,
+                              weights[PredefinedClauses::minorInMinorTime], 1);
+            }
+            if (core && !morning) {
+                addViolations(penalty,
+                              weights[PredefinedClauses::coreInMorningTime], 1);
+            }
+            if (elective && morning) {
+                addViolations(
+                    penalty,
+                    weights[PredefinedClauses::electiveInNonMorningTime], 1);
+            }
+            slotPenalty[i].push_back(penalty);
+        }
+        for (int j = 0; j < segmentCount; j++) {
+            segmentPenalty[i].push_back(
+                existingPenalty(i, FieldType::segment, j));
+        }
+        for (int j = 0; j < data.classrooms.size(); j++) {
+            classroomPenalty[i].push_back(
+                existingPenalty(i, FieldType::classroom, j));
+            if (data.classrooms[j].getSize() >= course.getClassSize()) {
+                allowedClassrooms[i].push_back(j);
+            }
+        }
+    }
+
+    /*
+     * A move changes at most two courses, so the soft weight it can change is
+     * bounded by twice the largest soft weight of a single Course, including
+     * the soft clashes with every other Course
+     */
+    long long unaryWeight = 0;
+    for (int i = 0; i < courseCount; i++) {
+        long long largest[3] = {0, 0, 0};
+        for (int j = 0; j < slotPenalty[i].size(); j++) {
+            largest[0] = std::max(largest[0], slotPenalty[i][j].soft);
+        }
+        for (int j = 0; j < segmentPenalty[i].size(); j++) {
+            largest[1] = std::max(largest[1], segmentPenalty[i][j].soft);
+        }
+        for (int j = 0; j < classroomPenalty[i].size(); j++) {
+            largest[2] = std::max(largest[2], classroomPenalty[i][j].soft);
+        }
+        unaryWeight =
+            std::max(unaryWeight, largest[0] + largest[1] + largest[2]);
+    }
+    int instructorWeight =
+        weights[PredefinedClauses::instructorSingleCourseAtATime];
+    int classroomWeight =
+        weights[PredefinedClauses::classroomSingleCourseAtATime];
+    int programWeight =
+        weights[PredefinedClauses::programSingleCoreCourseAtATime];
+    long long clashWeight =
+        std::max(0, instructorWeight) + std::max(0, classroomWeight) +
+        std::max(0, programWeight) * (long long)data.programs.size();
+    hardWeight =
+        1 + 2 * (unaryWeight + std::max(0, courseCount - 1) * clashWeight);
+    tabuTenure = 10 + courseCount / 20;
+}
+
+/**
+ * @brief      Counts the courses occupying a resource at the times
+ * intersecting a given time.
+ *
+ * @param[in]  busy  The occupancy of the kind of resource
+ * @param[in]  base  The offset of the resource in busy
+ * @param[in]  time  The time
+ *
+ * @return     The number of courses
+ */
+int Annealer::countOverlapping(const std::vector<int> &busy, int base,
+                               int time) {
+    int count = 0;
+    for (int i = 0; i < overlapping[time].size(); i++) {
+        count += busy[base + overlapping[time][i]];
+    }
+    return count;
+}
+
+/**
+ * @brief      Adds a Course to, or removes it from, the occupancy and the
+ * Penalty of a state.
+ *
+ * The clashes of the Course are counted against the other courses only, so
+ * the Course is counted after it is added, and uncounted before it is
+ * removed.
+ *
+ * @param      state   The state
+ * @param[in]  course  The course
+ * @param[in]  sign    1 to add the Course, -1 to remove it
+ */
+void Annealer::addCourse(AnnealerState &state, int course, int sign) {
+    std::vector<int> &weights = data.predefinedClausesWeights;
+    int slot = state.slots[course];
+    int segment = state.segments[course];
+    int classroom = state.classrooms[course];
+    int time = timeOf(slot, segment);
+    Penalty &penalty = state.penalty;
+
+    penalty.hard += sign * (slotPenalty[course][slot].hard +
+                            segmentPenalty[course][segment].hard);
+    penalty.soft += sign * (slotPenalty[course][slot].soft +
+                            segmentPenalty[course][segment].soft);
+    if (classroom == -1) {
+        addViolations(penalty, data.highLevelVarWeights[FieldType::classroom],
+                      sign);
+    } else {
+        penalty.hard += sign * classroomPenalty[course][classroom].hard;
+        penalty.soft += sign * classroomPenalty[course][classroom].soft;
+    }
+
+    int instructorBase = data.courses[course].getInstructor() * timeCount;
+    if (sign < 0) {
+        state.instructorBusy[instructorBase + time]--;
+    }
+    if (weights[PredefinedClauses::instructorSingleCourseAtATime] != 0) {
+        addViolations(
+            penalty, weights[PredefinedClauses::instructorSingleCourseAtATime],
+            sign * countOverlapping(state.instructorBusy, instructorBase,
+                                    time));
+    }
+    if (sign > 0) {
+        state.instructorBusy[instructorBase + time]++;
+    }
+
+    if (classroom != -1) {
+        int classroomBase = classroom * timeCount;
+        if (sign < 0) {
+            state.classroomBusy[classroomBase + time]--;
+        }
+        if (weights[PredefinedClauses::classroomSingleCourseAtATime] != 0) {
+            addViolations(
+                penalty,
+                weights[PredefinedClauses::classroomSingleCourseAtATime],
+                sign * countOverlapping(state.classroomBusy, classroomBase,
+                                        time));
+        }
+        if (sign > 0) {
+            state.classroomBusy[classroomBase + time]++;
+        }
+    }
+
+    for (int i = 0; i < corePrograms[course].size(); i++) {
+        int programBase = corePrograms[course][i] * timeCount;
+        if (sign < 0) {
+            state.programBusy[programBase + time]--;
+        }
+        addViolations(
+            penalty, weights[PredefinedClauses::programSingleCoreCourseAtATime],
+            sign * countOverlapping(state.programBusy, programBase, time));
+        if (sign > 0) {
+            state.programBusy[programBase + time]++;
+        }
+    }
+}
+
+/**
+ * @brief      Moves a Course to a new Slot, Segment and Classroom, updating
+ * the occupancy and the Penalty of the state.
+ *
+ * @param      state      The state
+ * @param[in]  course     The course
+ * @param[in]  slot       The new slot
+ * @param[in]  segment    The new segment
+ * @param[in]  classroom  The new classroom
+ */
+void Annealer::moveCourse(AnnealerState &state, int course, int slot,
+                          int segment, int classroom) {
+    addCourse(state, course, -1);
+    state.slots[course] = slot;
+    state.segments[course] = segment;
+    state.classrooms[course] = classroom;
+    addCourse(state, course, 1);
+}
+
+/**
+ * @brief      Gets the value of a Penalty used to accept or reject moves.
+ *
+ * @param[in]  penalty  The penalty
+ *
+ * @return     The value
+ */
+long long Annealer::value(const Penalty &penalty) {
+    return penalty.hard * hardWeight + penalty.soft;
+}
+
+/**
+ * @brief      Determines if a Penalty is better than another, comparing the
+ * hard violations first.
+ *
+ * @param[in]  penalty  The penalty
+ * @param[in]  other    The other penalty
+ *
+ * @return     True if better, False otherwise
+ */
+bool Annealer::isBetter(const Penalty &penalty, const Penalty &other) {
+    return penalty.hard < other.hard ||
+           (penalty.hard == other.hard && penalty.soft < other.soft);
+}
+
+/**
+ * @brief      Builds the starting state of the chains from the greedy
+ * schedule.
+ *
+ * Courses that the greedy scheduler could not place keep their existing
+ * Slot, or get the first one, and the smallest Classroom large enough for
+ * them.
+ *
+ * @return     The state
+ */
+AnnealerState Annealer::initialState() {
+    int courseCount = data.courses.size();
+    GreedyScheduler scheduler(data);
+    scheduler.schedule();
+    AnnealerState state;
+    state.slots.assign(courseCount, 0);
+    state.segments.assign(courseCount, 0);
+    state.classrooms.assign(courseCount, -1);
+    state.instructorBusy.assign(data.instructors.size() * timeCount, 0);
+    state.classroomBusy.assign(data.classrooms.size() * timeCount, 0);
+    state.programBusy.assign(data.programs.size() * timeCount, 0);
+    state.penalty.hard = 0;
+    state.penalty.soft = 0;
+    for (int i = 0; i < courseCount; i++) {
+        if (scheduler.getSlot(i) != -1) {
+            state.slots[i] = scheduler.getSlot(i);
+            state.segments[i] = scheduler.getSegment(i);
+            state.classrooms[i] = scheduler.getClassroom(i);
+        } else {
+            std::vector<lbool> &existing =
+                data.existingAssignmentVars[i][FieldType::slot];
+            for (int j = 0; j < existing.size(); j++) {
+                if (existing[j] == l_True) {
+                    state.slots[i] = j;
+                }
+            }
+            state.segments[i] = data.courses[i].getSegment();
+            int smallest = -1;
+            for (int j = 0; j < allowedClassrooms[i].size(); j++) {
+                int room = allowedClassrooms[i][j];
+                if (smallest == -1 || data.classrooms[room].getSize() <
+                                          data.classrooms[smallest].getSize()) {
+                    smallest = room;
+                }
+            }
+            state.classrooms[i] = smallest;
+        }
+        addCourse(state, i, 1);
+    }
+    return state;
+}
+
+/**
+ * @brief      Runs one annealing chain until the time limit.
+ *
+ * The temperature starts at the average worsening of a sample of random
+ * moves, and is cooled geometrically over the time limit. On return, the
+ * state holds the best timetable found by the chain. Only its assignment and
+ * Penalty are kept, not its occupancy.
+ *
+ * @param      state      The starting state, replaced by the best state
+ * @param[in]  seed       The seed of the chain
+ * @param[in]  timeLimit  The time limit in seconds
+ * @param      moveCount  The number of moves made by the chain
+ */
+void Annealer::runChain(AnnealerState &state, unsigned seed, double timeLimit,
+                        unsigned long long &moveCount) {
+    auto start = std::chrono::steady_clock::now();
+    std::mt19937 generator(seed);
+    int courseCount = data.courses.size();
+    int slotCount = data.slots.size();
+    int segmentCount = data.segments.size();
+    std::uniform_int_distribution<int> pickCourse(0, courseCount - 1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    AnnealerState bestState;
+    bestState.slots = state.slots;
+    bestState.segments = state.segments;
+    bestState.classrooms = state.classrooms;
+    bestState.penalty = state.penalty;
+    std::vector<unsigned long long> tabuUntil(courseCount * slotCount, 0);
+
+    double startTemperature = 0;
+    int worsening = 0;
+    for (int i = 0; i < 100; i++) {
+        int course = pickCourse(generator);
+        int slot = state.slots[course];
+        long long before = value(state.penalty);
+        moveCourse(state, course, generator() % slotCount,
+                   state.segments[course], state.classrooms[course]);
+        long long delta = value(state.penalty) - before;
+        moveCourse(state, course, slot, state.segments[course],
+                   state.classrooms[course]);
+        if (delta > 0) {
+            startTemperature += delta;
+            worsening++;
+        }
+    }
+    startTemperature = worsening > 0 ? startTemperature / worsening : 1;
+    double endTemperature = std::min(0.05, startTemperature);
+    double temperature = startTemperature;
+
+    unsigned long long iteration = 0;
+    while (true) {
+        iteration++;
+        if (iteration % 256 == 0) {
+            double elapsed = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+            if (elapsed >= timeLimit) {
+                break;
+            }
+            temperature =
+                startTemperature * std::pow(endTemperature / startTemperature,
+                                            elapsed / timeLimit);
+        }
+        int course = pickCourse(generator);
+        int other = -1;
+        int kind = generator() % 4;
+        int slot = state.slots[course];
+        int segment = state.segments[course];
+        int classroom = state.classrooms[course];
+        int newSlot = slot;
+        int newSegment = segment;
+        int newClassroom = classroom;
+        if (kind == 0 && slotCount > 1) {
+            newSlot = generator() % (slotCount - 1);
+            newSlot += newSlot >= slot;
+        } else if (kind == 1 && segmentCount > 1) {
+            newSegment = generator() % (segmentCount - 1);
+            newSegment += newSegment >= segment;
+        } else if (kind == 2 && allowedClassrooms[course].size() > 1) {
+            newClassroom = allowedClassrooms[course][generator() %
+                                                    allowedClassrooms[course]
+                                                        .size()];
+        } else if (kind == 3 && courseCount > 1) {
+            other = pickCourse(generator);
+            newSlot = state.slots[other];
+            newSegment = state.segments[other];
+        }
+        if (newSlot == slot && newSegment == segment &&
+            newClassroom == classroom) {
+            continue;
+        }
+
+        long long before = value(state.penalty);
+        moveCourse(state, course, newSlot, newSegment, newClassroom);
+        if (other != -1) {
+            moveCourse(state, other, slot, segment, state.classrooms[other]);
+        }
+        long long delta = value(state.penalty) - before;
+        bool tabu = tabuUntil[course * slotCount + newSlot] > iteration ||
+                    (other != -1 &&
+                     tabuUntil[other * slotCount + slot] > iteration);
+        bool accept;
+        if (tabu) {
+            accept = isBetter(state.penalty, bestState.penalty);
+        } else {
+            accept = delta <= 0 ||
+                     unit(generator) < std::exp(-delta / temperature);
+        }
+        if (!accept) {
+            if (other != -1) {
+                moveCourse(state, other, newSlot, newSegment,
+                           state.classrooms[other]);
+            }
+            moveCourse(state, course, slot, segment, classroom);
+            continue;
+        }
+        if (newSlot != slot) {
+            tabuUntil[course * slotCount + slot] = iteration + tabuTenure;
+            if (other != -1) {
+                tabuUntil[other * slotCount + newSlot] =
+                    iteration + tabuTenure;
+            }
+        }
+        if (isBetter(state.penalty, bestState.penalty)) {
+            bestState.slots = state.slots;
+            bestState.segments = state.segments;
+            bestState.classrooms = state.classrooms;
+            bestState.penalty = state.penalty;
+        }
+    }
+    state = bestState;
+    moveCount = iteration;
+}
+
+/**
+ * @brief      Runs the annealing chains and keeps the best timetable.
+ *
+ * @param[in]  timeLimit   The time limit of each chain in seconds
+ * @param[in]  seed        The seed, chain i uses seed + i
+ * @param[in]  chainCount  The number of chains, each run on its own thread
+ */
+void Annealer::run(double timeLimit, unsigned seed, int chainCount) {
+    precompute();
+    moves = 0;
+    if (data.slots.size() == 0 || data.segments.size() == 0) {
+        best.classrooms.assign(data.courses.size(), -1);
+        return;
+    }
+    best = initialState();
+    if (data.courses.size() == 0) {
+        return;
+    }
+    chainCount = std::max(1, chainCount);
+    std::vector<AnnealerState> states(chainCount, best);
+    std::vector<unsigned long long> moveCounts(chainCount, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < chainCount; i++) {
+        threads.push_back(std::thread(&Annealer::runChain, this,
+                                      std::ref(states[i]), seed + i, timeLimit,
+                                      std::ref(moveCounts[i])));
+    }
+    for (int i = 0; i < chainCount; i++) {
+        threads[i].join();
+        moves += moveCounts[i];
+        if (i == 0 || isBetter(states[i].penalty, best.penalty)) {
+            best = states[i];
+        }
+    }
+}
+
+/**
+ * @brief      Gets the Slot given to a Course.
+ *
+ * @param[in]  course  The course
+ *
+ * @return     The index of the Slot, -1 if there are no slots or segments
+ */
+int Annealer::getSlot(int course) {
+    if (data.slots.size() == 0 || data.segments.size() == 0) {
+        return -1;
+    }
+    return best.slots[course];
+}
+
+/**
+ * @brief      Gets the Segment given to a Course.
+ *
+ * @param[in]  course  The course
+ *
+ * @return     The index of the Segment, -1 if there are no slots or segments
+ */
+int Annealer::getSegment(int course) {
+    if (data.slots.size() == 0 || data.segments.size() == 0) {
+        return -1;
+    }
+    return best.segments[course];
+}
+
+/**
+ * @brief      Gets the Classroom given to a Course.
+ *
+ * @param[in]  course  The course
+ *
+ * @return     The index of the Classroom, -1 if none is large enough
+ */
+int Annealer::getClassroom(int course) { return best.classrooms[course]; }
+
+/**
+ * @brief      Gets the Penalty of the best timetable.
+ *
+ * @return     The penalty
+ */
+Penalty Annealer::getPenalty() { return best.penalty; }
+
+/**
+ * @brief      Gets the number of moves made by all the chains.
+ *
+ * @return     The number of moves
+ */
+unsigned long long Annealer::getMoves() { return moves; }
@@ -5,7 +5,7 @@
 #include <iostream>
 #include <vector>
 
-using namespace Minisat;
+using namespace NSPACE;
 
 /**
  * @brief      Constructs the Clauses object.
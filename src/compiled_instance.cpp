@@ -0,0 +1,606 @@
+#include "compiled_instance.h"
+
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include "data.h"
+#include "global.h"
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * The magic bytes at the start of a compiled instance
+ */
+static const char MAGIC[] = "TTCOMPIL";
+
+/**
+ * The version of the format, which changes whenever the payload changes
+ */
+static const uint32_t VERSION = 2;
+
+/**
+ * The size of the header in bytes, after which the payload starts
+ */
+static const size_t HEADER_SIZE = 32;
+
+/**
+ * @brief      Decodes a little endian 32 bit word.
+ *
+ * @param[in]  bytes  The bytes of the word
+ *
+ * @return     The word
+ */
+static uint32_t decodeWord(const unsigned char *bytes) {
+    return uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 |
+           uint32_t(bytes[2]) << 16 | uint32_t(bytes[3]) << 24;
+}
+
+/**
+ * @brief      Appends a little endian 32 bit word to a string of bytes.
+ *
+ * @param      bytes  The string
+ * @param[in]  word   The word
+ */
+static void encodeWord(std::string &bytes, uint32_t word) {
+    for (int i = 0; i < 4; i++) {
+        bytes.push_back(char((word >> (8 * i)) & 0xff));
+    }
+}
+
+/**
+ * @brief      Hashes bytes with FNV-1a.
+ *
+ * @param[in]  bytes  The bytes
+ * @param[in]  size   The number of bytes
+ *
+ * @return     The hash
+ */
+static uint64_t checksum(const unsigned char *bytes, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief      Constructs the CompiledInstance object.
+ */
+CompiledInstance::CompiledInstance() {
+    position = nullptr;
+    end = nullptr;
+    truncated = false;
+}
+
+/**
+ * @brief      Appends a word to the payload.
+ *
+ * @param[in]  word  The word
+ */
+void CompiledInstance::putWord(uint32_t word) { encodeWord(payload, word); }
+
+/**
+ * @brief      Appends a weight to the payload, as two words.
+ *
+ * @param[in]  weight  The weight
+ */
+void CompiledInstance::putWeight(uint64_t weight) {
+    putWord(uint32_t(weight));
+    putWord(uint32_t(weight >> 32));
+}
+
+/**
+ * @brief      Appends a string to the payload, as its length and its bytes
+ * padded to whole words.
+ *
+ * @param[in]  value  The string
+ */
+void CompiledInstance::putString(const std::string &value) {
+    putWord(value.size());
+    payload += value;
+    payload.append((4 - value.size() % 4) % 4, '\0');
+}
+
+/**
+ * @brief      Appends a list of integers to the payload, as its size and its
+ * integers.
+ *
+ * @param[in]  values  The integers
+ */
+void CompiledInstance::putInts(const std::vector<int> &values) {
+    putWord(values.size());
+    for (int i = 0; i < values.size(); i++) {
+        putWord(uint32_t(values[i]));
+    }
+}
+
+/**
+ * @brief      Appends a list of literals to the payload, as its size and its
+ * literals.
+ *
+ * @param[in]  lits  The literals
+ */
+void CompiledInstance::putLits(const vec<Lit> &lits) {
+    putWord(lits.size());
+    for (int i = 0; i < lits.size(); i++) {
+        putWord(toInt(lits[i]));
+    }
+}
+
+/**
+ * @brief      Appends a list of hints to the payload, as its size and its
+ * literals.
+ *
+ * @param[in]  hints  The hints
+ */
+void CompiledInstance::putHints(const std::vector<Lit> &hints) {
+    putWord(hints.size());
+    for (int i = 0; i < hints.size(); i++) {
+        putWord(toInt(hints[i]));
+    }
+}
+
+/**
+ * @brief      Reads a word from the payload.
+ *
+ * @return     The word, 0 if the payload has ended
+ */
+uint32_t CompiledInstance::getWord() {
+    if (end - position < 4) {
+        truncated = true;
+        position = end;
+        return 0;
+    }
+    uint32_t word = decodeWord(position);
+    position += 4;
+    return word;
+}
+
+/**
+ * @brief      Reads the size of a list from the payload. As each element takes
+ * at least a word, a size larger than the words left is not read.
+ *
+ * @return     The size, 0 if the payload is too short for it
+ */
+uint32_t CompiledInstance::getCount() {
+    uint32_t count = getWord();
+    if (count > (end - position) / 4) {
+        truncated = true;
+        position = end;
+        return 0;
+    }
+    return count;
+}
+
+/**
+ * @brief      Reads a weight from the payload.
+ *
+ * @return     The weight
+ */
+uint64_t CompiledInstance::getWeight() {
+    uint64_t low = getWord();
+    return low | uint64_t(getWord()) << 32;
+}
+
+/**
+ * @brief      Reads a string from the payload.
+ *
+ * @return     The string
+ */
+std::string CompiledInstance::getString() {
+    uint32_t length = getWord();
+    size_t padded = length + (4 - length % 4) % 4;
+    if (padded > end - position) {
+        truncated = true;
+        position = end;
+        return "";
+    }
+    std::string value(reinterpret_cast<const char *>(position), length);
+    position += padded;
+    return value;
+}
+
+/**
+ * @brief      Reads a list of integers from the payload.
+ *
+ * @return     The integers
+ */
+std::vector<int> CompiledInstance::getInts() {
+    std::vector<int> values(getCount());
+    for (int i = 0; i < values.size(); i++) {
+        values[i] = int32_t(getWord());
+    }
+    return values;
+}
+
+/**
+ * @brief      Reads a list of literals from the payload.
+ *
+ * @param      lits  Set to the literals
+ * @param[in]  vars  The number of variables of the formula
+ *
+ * @return     True if every literal is of a variable of the formula, False
+ * otherwise
+ */
+bool CompiledInstance::getLits(vec<Lit> &lits, int vars) {
+    lits.clear();
+    uint32_t count = getCount();
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t code = getWord();
+        if (code / 2 >= uint32_t(vars)) {
+            return false;
+        }
+        lits.push(mkLit(code / 2, code % 2 == 1));
+    }
+    return true;
+}
+
+/**
+ * @brief      Reads a list of hints from the payload.
+ *
+ * @param      hints  The hints are added to it
+ * @param[in]  vars   The number of variables of the formula
+ *
+ * @return     True if every hint is of a variable of the formula, False
+ * otherwise
+ */
+bool CompiledInstance::getHints(std::vector<Lit> &hints, int vars) {
+    bool valid = true;
+    uint32_t count = getCount();
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t code = getWord();
+        valid = valid && code / 2 < uint32_t(vars);
+        hints.push_back(mkLit(code / 2, code % 2 == 1));
+    }
+    return valid;
+}
+
+/**
+ * @brief      Appends the field values, the courses, the variables and the
+ * weights of the Data to the payload.
+ *
+ * @param      data  The Data
+ */
+void CompiledInstance::putData(Data &data) {
+    putWord(data.instructors.size());
+    for (int i = 0; i < data.instructors.size(); i++) {
+        putString(data.instructors[i].getName());
+    }
+    putWord(data.classrooms.size());
+    for (int i = 0; i < data.classrooms.size(); i++) {
+        putString(data.classrooms[i].getName());
+        putWord(data.classrooms[i].getSize());
+    }
+    putWord(data.programs.size());
+    for (int i = 0; i < data.programs.size(); i++) {
+        putString(data.programs[i].getName());
+        putWord(data.programs[i].isCoreProgram());
+    }
+    putWord(data.segments.size());
+    for (int i = 0; i < data.segments.size(); i++) {
+        putWord(data.segments[i].getStartSegment());
+        putWord(data.segments[i].getEndSegment());
+    }
+    putWord(data.slots.size());
+    for (int i = 0; i < data.slots.size(); i++) {
+        putString(data.slots[i].getName());
+        putWord(data.slots[i].isMinorSlot());
+        std::vector<SlotElement> elements = data.slots[i].getSlotElements();
+        putWord(elements.size());
+        for (int j = 0; j < elements.size(); j++) {
+            Time start = elements[j].getStartTime();
+            Time end = elements[j].getEndTime();
+            putWord(static_cast<uint32_t>(elements[j].getDay()));
+            putWord(start.getHours());
+            putWord(start.getMinutes());
+            putWord(end.getHours());
+            putWord(end.getMinutes());
+        }
+    }
+    putWord(data.courses.size());
+    for (int i = 0; i < data.courses.size(); i++) {
+        putString(data.courses[i].getName());
+        putWord(data.courses[i].getClassSize());
+        putWord(data.courses[i].getInstructor());
+        putWord(data.courses[i].getSegment());
+        putWord(data.courses[i].getIsMinor());
+        putInts(data.courses[i].getPrograms());
+        for (int j = 0; j < Global::FIELD_COUNT; j++) {
+            putInts(data.fieldValueVars[i][j]);
+        }
+        putInts(data.highLevelVars[i]);
+        for (int j = 0; j < Global::FIELD_COUNT; j++) {
+            const std::vector<lbool> &values =
+                data.existingAssignmentVars[i][j];
+            putWord(values.size());
+            for (int k = 0; k < values.size(); k++) {
+                putWord(values[k] == l_True ? 1 : values[k] == l_False ? 0 : 2);
+            }
+        }
+    }
+    putInts(data.highLevelVarWeights);
+    putInts(data.existingAssignmentWeights);
+    putInts(data.predefinedClausesWeights);
+    putWord(data.classroomCustomConstraints);
+}
+
+/**
+ * @brief      Reads the field values, the courses, the variables and the
+ * weights of the Data from the payload.
+ *
+ * @param      data  The Data, which is empty
+ */
+void CompiledInstance::getData(Data &data) {
+    uint32_t count = getCount();
+    for (uint32_t i = 0; i < count; i++) {
+        data.instructors.push_back(Instructor(getString(), data.symbols));
+    }
+    count = getCount();
+    for (uint32_t i = 0; i < count; i++) {
+        std::string number = getString();
+        unsigned size = getWord();
+        data.classrooms.push_back(Classroom(number, size, data.symbols));
+    }
+    count = getCount();
+    for (uint32_t i = 0; i < count; i++) {
+        std::string name = getString();
+        CourseType courseType =
+            getWord() ? CourseType::core : CourseType::elective;
+        data.programs.push_back(Program(name, courseType, data.symbols));
+    }
+    count = getCount();
+    for (uint32_t i = 0; i < count; i++) {
+        int start = getWord();
+        int end = getWord();
+        data.segments.push_back(Segment(start, end));
+    }
+    count = getCount();
+    for (uint32_t i = 0; i < count; i++) {
+        std::string name = getString();
+        IsMinor isMinor =
+            getWord() ? MinorType::isMinorCourse : MinorType::isNotMinorCourse;
+        std::vector<SlotElement> elements;
+        uint32_t elementCount = getCount();
+        for (uint32_t j = 0; j < elementCount; j++) {
+            Day day = static_cast<Day>(getWord() % 7);
+            unsigned startHours = getWord();
+            unsigned startMinutes = getWord();
+            unsigned endHours = getWord();
+            unsigned endMinutes = getWord();
+            Time start(startHours, startMinutes);
+            Time end(endHours, endMinutes);
+            elements.push_back(SlotElement(start, end, day));
+        }
+        data.slots.push_back(Slot(name, isMinor, elements, data.symbols));
+    }
+    data.isMinors.push_back(IsMinor(MinorType::isMinorCourse));
+    data.isMinors.push_back(IsMinor(MinorType::isNotMinorCourse));
+    count = getCount();
+    for (uint32_t i = 0; i < count; i++) {
+        std::string name = getString();
+        unsigned classSize = getWord();
+        int instructor = getWord();
+        int segment = getWord();
+        int isMinor = getWord();
+        std::vector<int> programs = getInts();
+        data.courses.push_back(Course(name, classSize, instructor, segment,
+                                      isMinor, programs, data.symbols));
+        std::vector<std::vector<Var>> vars(Global::FIELD_COUNT);
+        for (int j = 0; j < Global::FIELD_COUNT; j++) {
+            vars[j] = getInts();
+        }
+        data.fieldValueVars.push_back(vars);
+        data.highLevelVars.push_back(getInts());
+        std::vector<std::vector<lbool>> assignments(Global::FIELD_COUNT);
+        for (int j = 0; j < Global::FIELD_COUNT; j++) {
+            uint32_t valueCount = getCount();
+            for (uint32_t k = 0; k < valueCount; k++) {
+                uint32_t value = getWord();
+                assignments[j].push_back(value == 1   ? l_True
+                                         : value == 0 ? l_False
+                                                      : l_Undef);
+            }
+        }
+        data.existingAssignmentVars.push_back(assignments);
+    }
+    data.highLevelVarWeights = getInts();
+    data.existingAssignmentWeights = getInts();
+    data.predefinedClausesWeights = getInts();
+    data.classroomCustomConstraints = getWord() != 0;
+    data.buildIndices();
+}
+
+/**
+ * @brief      Writes a compiled instance.
+ *
+ * @param[in]  fileName    The name of the file
+ * @param      data        The Data
+ * @param      formula     The formula, before it is solved
+ * @param[in]  levels      The ObjectiveLevel of each soft clause
+ * @param[in]  hardGroups  The range of the hard clauses of each group
+ * @param[in]  hints       The phase hints
+ * @param[in]  greedy      The hints of the greedy schedule
+ *
+ * @return     True if the file was written, False otherwise, see getError()
+ */
+bool CompiledInstance::write(const std::string &fileName, Data &data,
+                             MaxSATFormula *formula,
+                             const std::vector<int> &levels,
+                             const std::vector<std::pair<int, int>> &hardGroups,
+                             const std::vector<Lit> &hints,
+                             const std::vector<Lit> &greedy) {
+    error.clear();
+    payload.clear();
+    putData(data);
+    putWord(formula->nVars());
+    putWord(formula->nHard());
+    for (int i = 0; i < formula->nHard(); i++) {
+        putLits(formula->getHardClause(i).clause);
+    }
+    putWord(formula->nSoft());
+    for (int i = 0; i < formula->nSoft(); i++) {
+        putWeight(formula->getSoftClause(i).weight);
+        putLits(formula->getSoftClause(i).clause);
+    }
+    putInts(levels);
+    putWord(hardGroups.size());
+    for (int i = 0; i < hardGroups.size(); i++) {
+        putWord(hardGroups[i].first);
+        putWord(hardGroups[i].second);
+    }
+    putHints(hints);
+    putHints(greedy);
+
+    uint64_t hash = checksum(
+        reinterpret_cast<const unsigned char *>(payload.data()),
+        payload.size());
+    std::string header(MAGIC, 8);
+    encodeWord(header, VERSION);
+    encodeWord(header, 0);
+    encodeWord(header, uint32_t(payload.size()));
+    encodeWord(header, uint32_t(uint64_t(payload.size()) >> 32));
+    encodeWord(header, uint32_t(hash));
+    encodeWord(header, uint32_t(hash >> 32));
+    std::ofstream file(fileName, std::ios::binary);
+    file.write(header.data(), header.size());
+    file.write(payload.data(), payload.size());
+    file.close();
+    payload.clear();
+    if (file.fail()) {
+        error = "cannot write the file";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief      Reads a compiled instance, after checking its header and its
+ * checksum. The file is memory mapped, and the payload read in place.
+ *
+ * @param[in]  fileName    The name of the file
+ * @param      data        The Data, which is empty
+ * @param      formula     The formula, which is empty
+ * @param      levels      Set to the ObjectiveLevel of each soft clause
+ * @param      hardGroups  Set to the range of the hard clauses of each group
+ * @param      hints       Set to the phase hints
+ * @param      greedy      Set to the hints of the greedy schedule
+ *
+ * @return     True if the file was read, False otherwise, see getError()
+ */
+bool CompiledInstance::read(const std::string &fileName, Data &data,
+                            MaxSATFormula *formula, std::vector<int> &levels,
+                            std::vector<std::pair<int, int>> &hardGroups,
+                            std::vector<Lit> &hints,
+                            std::vector<Lit> &greedy) {
+    error.clear();
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd == -1) {
+        error = "cannot open the file";
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || fileStat.st_size < HEADER_SIZE) {
+        ::close(fd);
+        error = "not a compiled instance";
+        return false;
+    }
+    size_t size = fileStat.st_size;
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error = "cannot map the file";
+        return false;
+    }
+    const unsigned char *bytes = static_cast<const unsigned char *>(map);
+    uint64_t payloadSize =
+        decodeWord(bytes + 16) | uint64_t(decodeWord(bytes + 20)) << 32;
+    uint64_t hash =
+        decodeWord(bytes + 24) | uint64_t(decodeWord(bytes + 28)) << 32;
+    bool parsed = false;
+    if (std::memcmp(bytes, MAGIC, 8) != 0) {
+        error = "not a compiled instance";
+    } else if (decodeWord(bytes + 8) != VERSION) {
+        error = "compiled with another version of the format, compile it "
+                "again";
+    } else if (payloadSize != size - HEADER_SIZE ||
+               checksum(bytes + HEADER_SIZE, payloadSize) != hash) {
+        error = "the checksum does not match, the file is damaged";
+    } else {
+        position = bytes + HEADER_SIZE;
+        end = bytes + size;
+        truncated = false;
+        parsed = parse(data, formula, levels, hardGroups, hints, greedy);
+    }
+    munmap(map, size);
+    position = nullptr;
+    end = nullptr;
+    return parsed;
+}
+
+/**
+ * @brief      Reads the payload.
+ *
+ * @param      data        The Data
+ * @param      formula     The formula
+ * @param      levels      Set to the ObjectiveLevel of each soft clause
+ * @param      hardGroups  Set to the range of the hard clauses of each group
+ * @param      hints       Set to the phase hints
+ * @param      greedy      Set to the hints of the greedy schedule
+ *
+ * @return     True if the payload is valid, False otherwise
+ */
+bool CompiledInstance::parse(Data &data, MaxSATFormula *formula,
+                             std::vector<int> &levels,
+                             std::vector<std::pair<int, int>> &hardGroups,
+                             std::vector<Lit> &hints,
+                             std::vector<Lit> &greedy) {
+    getData(data);
+    int vars = getWord();
+    for (int i = 0; i < vars; i++) {
+        formula->newVar();
+    }
+    bool valid = true;
+    vec<Lit> clause;
+    uint32_t count = getCount();
+    for (uint32_t i = 0; i < count && valid; i++) {
+        valid = getLits(clause, vars);
+        formula->addHardClause(clause);
+    }
+    count = getCount();
+    for (uint32_t i = 0; i < count && valid; i++) {
+        uint64_t weight = getWeight();
+        valid = getLits(clause, vars);
+        formula->addSoftClause(weight, clause);
+    }
+    levels = getInts();
+    count = getCount();
+    for (uint32_t i = 0; i < count; i++) {
+        int begin = getWord();
+        int groupEnd = getWord();
+        hardGroups.push_back(std::make_pair(begin, groupEnd));
+    }
+    valid = getHints(hints, vars) && valid;
+    valid = getHints(greedy, vars) && valid;
+    if (!valid || truncated || position != end) {
+        error = "the compiled instance is malformed";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief      Gets the error of the last read or write.
+ *
+ * @return     The error, empty if there is none
+ */
+std::string CompiledInstance::getError() { return error; }
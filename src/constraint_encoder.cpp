@@ -9,7 +9,7 @@
 #include <iostream>
 #include <vector>
 
-using namespace Minisat;
+using namespace NSPACE;
 
 /**
  * @brief      Constructs the ConstraintEncoder object.
@@ -0,0 +1,265 @@
+#include "csv_reader.h"
+
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @brief      Checks if the cell is empty.
+ *
+ * @return     True if empty, False otherwise
+ */
+bool CSVCell::empty() const { return length == 0; }
+
+/**
+ * @brief      Checks if the cell is equal to a string.
+ *
+ * @param[in]  other  The string
+ *
+ * @return     True if equal, False otherwise
+ */
+bool CSVCell::operator==(const char *other) const {
+    return std::strlen(other) == length &&
+           std::memcmp(data, other, length) == 0;
+}
+
+/**
+ * @brief      Checks if the cell is not equal to a string.
+ *
+ * @param[in]  other  The string
+ *
+ * @return     True if not equal, False otherwise
+ */
+bool CSVCell::operator!=(const char *other) const { return !(*this == other); }
+
+/**
+ * @brief      Constructs the CSVReader object, with no file open.
+ */
+CSVReader::CSVReader() {
+    mapped = nullptr;
+    size = 0;
+    position = nullptr;
+    end = nullptr;
+    line = 0;
+    nextLine = 1;
+}
+
+/**
+ * @brief      Destroys the CSVReader object, unmapping the file.
+ */
+CSVReader::~CSVReader() {
+    if (mapped != nullptr) {
+        munmap(const_cast<char *>(mapped), size);
+    }
+}
+
+/**
+ * @brief      Opens a file and reads its header row.
+ *
+ * @param[in]  file  The name of the file
+ *
+ * @return     True if the file was opened and has a header, False otherwise
+ */
+bool CSVReader::open(const std::string &file) {
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd == -1) {
+        fail("cannot open the file");
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1) {
+        ::close(fd);
+        fail("cannot read the file");
+        return false;
+    }
+    size = fileStat.st_size;
+    if (size > 0) {
+        void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            ::close(fd);
+            fail("cannot map the file");
+            return false;
+        }
+        madvise(map, size, MADV_SEQUENTIAL);
+        mapped = static_cast<const char *>(map);
+    }
+    // the mapping stays valid once the file is closed
+    ::close(fd);
+    position = mapped;
+    end = mapped + size;
+    if (!readRow()) {
+        if (!hasError()) {
+            fail("the file has no header");
+        }
+        return false;
+    }
+    for (int i = 0; i < cells.size(); i++) {
+        header.push_back(std::string(cells[i].data, cells[i].length));
+    }
+    return true;
+}
+
+/**
+ * @brief      Records an error, which stops the reading.
+ *
+ * @param[in]  message  The error
+ */
+void CSVReader::fail(const std::string &message) {
+    error = message;
+    position = end;
+}
+
+/**
+ * @brief      Reads the next line of the file into the cells, which is more
+ * than one line of the file if a quoted cell has newlines.
+ *
+ * @return     True if a line was read, False at the end of the file or on an
+ * error
+ */
+bool CSVReader::readRow() {
+    cells.clear();
+    unescaped.clear();
+    line = nextLine;
+    if (position == end) {
+        return false;
+    }
+    while (true) {
+        CSVCell cell;
+        if (position != end && *position == '"') {
+            const char *start = ++position;
+            bool escaped = false;
+            while (true) {
+                if (position == end) {
+                    fail("a quoted cell is not closed");
+                    return false;
+                }
+                if (*position == '"') {
+                    if (position + 1 == end || position[1] != '"') {
+                        break;
+                    }
+                    escaped = true;
+                    position++;
+                } else if (*position == '\n') {
+                    nextLine++;
+                }
+                position++;
+            }
+            cell.data = start;
+            cell.length = position - start;
+            position++;
+            if (escaped) {
+                unescaped.push_back(std::string());
+                std::string &value = unescaped.back();
+                for (size_t i = 0; i < cell.length; i++) {
+                    value.push_back(start[i]);
+                    if (start[i] == '"') {
+                        i++;
+                    }
+                }
+                cell.data = value.data();
+                cell.length = value.size();
+            }
+            if (position != end && *position == '\r') {
+                position++;
+            }
+            if (position != end && *position != ',' && *position != '\n') {
+                fail("a quoted cell is followed by more characters");
+                return false;
+            }
+        } else {
+            const char *start = position;
+            while (position != end && *position != ',' && *position != '\n') {
+                position++;
+            }
+            cell.data = start;
+            cell.length = position - start;
+            if (cell.length > 0 && start[cell.length - 1] == '\r' &&
+                (position == end || *position == '\n')) {
+                cell.length--;
+            }
+        }
+        cells.push_back(cell);
+        if (position == end) {
+            return true;
+        }
+        if (*position == '\n') {
+            position++;
+            nextLine++;
+            return true;
+        }
+        position++;
+    }
+}
+
+/**
+ * @brief      Finds a column by its name in the header.
+ *
+ * @param[in]  name  The name
+ *
+ * @return     The index of the column, -1 if there is none
+ */
+int CSVReader::findColumn(const std::string &name) {
+    for (int i = 0; i < header.size(); i++) {
+        if (header[i] == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief      Reads the next row, skipping blank lines.
+ *
+ * @return     True if a row was read, False at the end of the file or on an
+ * error, see hasError()
+ */
+bool CSVReader::next() {
+    while (readRow()) {
+        if (cells.size() == 1 && cells[0].empty()) {
+            continue;
+        }
+        if (cells.size() != header.size()) {
+            fail("expected " + std::to_string(header.size()) +
+                 " cells, found " + std::to_string(cells.size()));
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief      Gets a cell of the current row.
+ *
+ * @param[in]  column  The index of the column
+ *
+ * @return     The cell, valid until the next row is read
+ */
+const CSVCell &CSVReader::getCell(int column) { return cells[column]; }
+
+/**
+ * @brief      Gets the line on which the current row starts, or on which the
+ * error was found.
+ *
+ * @return     The line, counting from 1
+ */
+int CSVReader::getLine() { return line; }
+
+/**
+ * @brief      Checks if the reading stopped on an error.
+ *
+ * @return     True if there was an error, False otherwise
+ */
+bool CSVReader::hasError() { return !error.empty(); }
+
+/**
+ * @brief      Gets the error that stopped the reading.
+ *
+ * @return     The error, empty if there is none
+ */
+std::string CSVReader::getError() { return error; }
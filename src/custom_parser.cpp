@@ -55,6 +55,7 @@ struct classroomstr : TAOCPP_PEGTL_KEYWORD("CLASSROOM") {};
 template <> struct action<classroomstr> {
     template <typename Input> static void apply(const Input &in, Object &obj) {
         obj.fieldType = FieldValuesType::CLASSROOM;
+        obj.timeTabler->data.classroomCustomConstraints = true;
     }
 };
 
@@ -144,106 +145,56 @@ struct value
 template <> struct action<value> {
     template <typename Input> static void apply(const Input &in, Object &obj) {
         std::string val = in.string();
-        bool found = false;
+        Data &data = obj.timeTabler->data;
         if (obj.fieldType == FieldValuesType::INSTRUCTOR) {
-            for (int i = 0; i < obj.timeTabler->data.instructors.size(); i++) {
-                if (obj.timeTabler->data.instructors[i].getName() == val) {
-                    found = true;
-                    obj.instructorValues.push_back(i);
-                    break;
-                }
-            }
-            if (!found) {
-                std::cout << "Instructor " << val << " does not exist."
-                          << std::endl;
-                exit(1);
+            int index = data.findFieldValue(FieldType::instructor, val);
+            if (index == -1) {
+                obj.error = "Instructor " + val + " does not exist.";
+                return;
             }
-            found = false;
+            obj.instructorValues.push_back(index);
         } else if (obj.fieldType == FieldValuesType::COURSE) {
-            for (int i = 0; i < obj.timeTabler->data.courses.size(); i++) {
-                std::cout << obj.timeTabler->data.courses[i].getName()
-                          << std::endl;
-                if (obj.timeTabler->data.courses[i].getName() == val) {
-                    found = true;
-                    obj.courseValues.push_back(i);
-                    break;
-                }
+            int index = data.findCourse(val);
+            if (index == -1) {
+                obj.error = "Course " + val + " does not exist.";
+                return;
             }
-            if (!found) {
-                std::cout << "Course " << val << " does not exist."
-                          << std::endl;
-                exit(1);
-            }
-            found = false;
+            obj.courseValues.push_back(index);
         } else if (obj.fieldType == FieldValuesType::SEGMENT) {
-            for (int i = 0; i < obj.timeTabler->data.segments.size(); i++) {
-                if (obj.timeTabler->data.segments[i].getName() == val) {
-                    found = true;
-                    obj.segmentValues.push_back(i);
-                    break;
-                }
+            int index = data.findFieldValue(FieldType::segment, val);
+            if (index == -1) {
+                obj.error = "Segment " + val + " does not exist.";
+                return;
             }
-            if (!found) {
-                std::cout << "Segment " << val << " does not exist."
-                          << std::endl;
-                exit(1);
-            }
-            found = false;
+            obj.segmentValues.push_back(index);
         } else if (obj.fieldType == FieldValuesType::PROGRAM) {
-            for (int i = 0; i < obj.timeTabler->data.programs.size(); i++) {
-                if (obj.timeTabler->data.programs[i].getNameWithType() == val) {
-                    found = true;
-                    obj.programValues.push_back(i);
-                    break;
-                }
+            int index = data.findFieldValue(FieldType::program, val);
+            if (index == -1) {
+                obj.error = "Program " + val + " does not exist.";
+                return;
             }
-            if (!found) {
-                std::cout << "Program " << val << " does not exist."
-                          << std::endl;
-                exit(1);
-            }
-            found = false;
+            obj.programValues.push_back(index);
         } else if (obj.fieldType == FieldValuesType::ISMINOR) {
-            for (int i = 0; i < obj.timeTabler->data.isMinors.size(); i++) {
-                if (obj.timeTabler->data.isMinors[i].getName() == val) {
-                    found = true;
-                    obj.isMinorValues.push_back(i);
-                    break;
-                }
+            int index = data.findFieldValue(FieldType::isMinor, val);
+            if (index == -1) {
+                obj.error = "IsMinor " + val + " does not exist.";
+                return;
             }
-            if (!found) {
-                std::cout << "IsMinor " << val << " does not exist."
-                          << std::endl;
-                exit(1);
-            }
-            found = false;
+            obj.isMinorValues.push_back(index);
         } else if (obj.fieldType == FieldValuesType::CLASSROOM) {
-            for (int i = 0; i < obj.timeTabler->data.classrooms.size(); i++) {
-                if (obj.timeTabler->data.classrooms[i].getName() == val) {
-                    found = true;
-                    obj.classValues.push_back(i);
-                    break;
-                }
+            int index = data.findFieldValue(FieldType::classroom, val);
+            if (index == -1) {
+                obj.error = "Classroom " + val + " does not exist.";
+                return;
             }
-            if (!found) {
-                std::cout << "Classroom " << val << " does not exist."
-                          << std::endl;
-                exit(1);
-            }
-            found = false;
+            obj.classValues.push_back(index);
         } else if (obj.fieldType == FieldValuesType::SLOT) {
-            for (int i = 0; i < obj.timeTabler->data.slots.size(); i++) {
-                if (obj.timeTabler->data.slots[i].getName() == val) {
-                    found = true;
-                    obj.slotValues.push_back(i);
-                    break;
-                }
+            int index = data.findFieldValue(FieldType::slot, val);
+            if (index == -1) {
+                obj.error = "Slot " + val + " does not exist.";
+                return;
             }
-            if (!found) {
-                std::cout << "Slot " << val << " does not exist." << std::endl;
-                exit(1);
-            }
-            found = false;
+            obj.slotValues.push_back(index);
         }
     }
 };
@@ -561,6 +512,9 @@ struct wconstraint
                  pegtl::pad<integer, pegtl::space>> {};
 template <> struct action<wconstraint> {
     template <typename Input> static void apply(const Input &in, Object &obj) {
+        if (!obj.error.empty()) {
+            return;
+        }
         obj.timeTabler->addClauses(obj.constraint, obj.integer);
     }
 };
@@ -588,4 +542,60 @@ void parseCustomConstraints(std::string file,
     obj.timeTabler = timeTabler;
     pegtl::file_input<> in(file);
     pegtl::parse<grammar, action, control>(in, obj);
+    if (!obj.error.empty()) {
+        std::cout << obj.error << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * @brief      Parse constraints from a string, fail without raising an error
+ */
+struct string_grammar : pegtl::seq<pegtl::star<wconstraint>, pegtl::eof> {};
+
+/**
+ * @brief      Actions of the check of a string of constraints, which only
+ * look up the values of the fields
+ */
+template <typename Rule> struct check_action : pegtl::nothing<Rule> {};
+template <> struct check_action<coursestr> : action<coursestr> {};
+template <> struct check_action<slotstr> : action<slotstr> {};
+template <> struct check_action<instructorstr> : action<instructorstr> {};
+template <> struct check_action<segmentstr> : action<segmentstr> {};
+template <> struct check_action<isminorstr> : action<isminorstr> {};
+template <> struct check_action<programstr> : action<programstr> {};
+template <> struct check_action<classroomstr> {
+    template <typename Input> static void apply(const Input &in, Object &obj) {
+        obj.fieldType = FieldValuesType::CLASSROOM;
+    }
+};
+template <> struct check_action<value> : action<value> {};
+
+/**
+ * @brief      Parses the string once to check the syntax and that every value
+ * exists, before any of the constraints is added, and then again to add
+ * them.
+ */
+bool parseCustomConstraintString(std::string text,
+                                 ConstraintEncoder *constraintEncoder,
+                                 TimeTabler *timeTabler) {
+    Object check;
+    check.timeTabler = timeTabler;
+    try {
+        pegtl::memory_input<> in(text, "input");
+        if (!pegtl::parse<string_grammar, check_action>(in, check)) {
+            return false;
+        }
+    } catch (const pegtl::parse_error &e) {
+        return false;
+    }
+    if (!check.error.empty()) {
+        std::cout << check.error << std::endl;
+        return false;
+    }
+    Object obj;
+    obj.constraintEncoder = constraintEncoder;
+    obj.timeTabler = timeTabler;
+    pegtl::memory_input<> in(text, "input");
+    return pegtl::parse<string_grammar, action>(in, obj);
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "data.h"
 
 #include "global.h"
+#include <string>
+#include <vector>
 
 /**
  * @brief      Constructs the Data object.
@@ -17,4 +19,82 @@ Data::Data() {
     existingAssignmentWeights[FieldType::instructor] = -1;
     predefinedClausesWeights[PredefinedClauses::coreInMorningTime] = 1;
     predefinedClausesWeights[PredefinedClauses::electiveInNonMorningTime] = 1;
-}
\ No newline at end of file
+    classroomCustomConstraints = false;
+}
+
+/**
+ * @brief      Builds the indices from the ids of the names of the field values
+ * and the courses to their indices.
+ *
+ * This is called by the Parser once the fields are parsed, and again once
+ * the courses are. The names of the segments and IsMinor values, and of the
+ * programs with their course types, are interned here, as those objects do
+ * not store ids. If two values share a name, the first one is indexed.
+ */
+void Data::buildIndices() {
+    std::vector<std::vector<int>> ids(Global::FIELD_COUNT);
+    for (int i = 0; i < instructors.size(); i++) {
+        ids[FieldType::instructor].push_back(instructors[i].getNameId());
+    }
+    for (int i = 0; i < segments.size(); i++) {
+        ids[FieldType::segment].push_back(
+            symbols.intern(segments[i].getName()));
+    }
+    for (int i = 0; i < isMinors.size(); i++) {
+        ids[FieldType::isMinor].push_back(
+            symbols.intern(isMinors[i].getName()));
+    }
+    for (int i = 0; i < programs.size(); i++) {
+        ids[FieldType::program].push_back(
+            symbols.intern(programs[i].getNameWithType()));
+    }
+    for (int i = 0; i < classrooms.size(); i++) {
+        ids[FieldType::classroom].push_back(classrooms[i].getNameId());
+    }
+    for (int i = 0; i < slots.size(); i++) {
+        ids[FieldType::slot].push_back(slots[i].getNameId());
+    }
+    fieldValueIndices.assign(Global::FIELD_COUNT,
+                             std::vector<int>(symbols.size(), -1));
+    for (int i = 0; i < Global::FIELD_COUNT; i++) {
+        for (int j = ids[i].size() - 1; j >= 0; j--) {
+            fieldValueIndices[i][ids[i][j]] = j;
+        }
+    }
+    courseIndices.assign(symbols.size(), -1);
+    for (int i = courses.size() - 1; i >= 0; i--) {
+        courseIndices[courses[i].getNameId()] = i;
+    }
+}
+
+/**
+ * @brief      Finds a field value by its name.
+ *
+ * @param[in]  fieldType  The FieldType
+ * @param[in]  name       The name
+ *
+ * @return     The index of the field value, -1 if there is none
+ */
+int Data::findFieldValue(FieldType fieldType, const std::string &name) {
+    int id = symbols.find(name);
+    if (fieldType >= fieldValueIndices.size() || id == -1 ||
+        id >= fieldValueIndices[fieldType].size()) {
+        return -1;
+    }
+    return fieldValueIndices[fieldType][id];
+}
+
+/**
+ * @brief      Finds a Course by its name.
+ *
+ * @param[in]  name  The name
+ *
+ * @return     The index of the Course, -1 if there is none
+ */
+int Data::findCourse(const std::string &name) {
+    int id = symbols.find(name);
+    if (id == -1 || id >= courseIndices.size()) {
+        return -1;
+    }
+    return courseIndices[id];
+}
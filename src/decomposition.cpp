@@ -0,0 +1,315 @@
+#include "decomposition.h"
+
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * @brief      Constructs the Decomposition object, which propagates the hard
+ * unit clauses of the formula and finds its components.
+ *
+ * @param      formula  The formula
+ */
+Decomposition::Decomposition(MaxSATFormula *formula) {
+    this->formula = formula;
+    fixed.assign(formula->nVars(), l_Undef);
+    fixedCost = 0;
+    conflicting = !propagate();
+    if (!conflicting) {
+        findComponents();
+    }
+}
+
+/**
+ * @brief      Gets the value of a literal under the fixed values.
+ *
+ * @param[in]  l     The literal
+ *
+ * @return     The value, l_Undef if the variable is not fixed
+ */
+lbool Decomposition::value(Lit l) {
+    if (fixed[var(l)] == l_Undef) {
+        return l_Undef;
+    }
+    return (fixed[var(l)] == l_True) != sign(l) ? l_True : l_False;
+}
+
+/**
+ * @brief      Counts the literals of a clause that are not fixed.
+ *
+ * @param      clause  The clause
+ * @param      last    Set to the last literal that is not fixed
+ *
+ * @return     The number of literals not fixed, -1 if the clause is
+ * satisfied by the fixed values
+ */
+int Decomposition::remaining(vec<Lit> &clause, Lit &last) {
+    int count = 0;
+    for (int i = 0; i < clause.size(); i++) {
+        lbool v = value(clause[i]);
+        if (v == l_True) {
+            return -1;
+        }
+        if (v == l_Undef) {
+            count++;
+            last = clause[i];
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief      Fixes the variables implied by the hard clauses through unit
+ * propagation, until no more are implied.
+ *
+ * Every hard clause is checked once, and the literals fixed are then
+ * propagated from a queue, each checking only the hard clauses in which its
+ * negation occurs, instead of every hard clause being checked again after
+ * each change.
+ *
+ * @return     False if a hard clause is falsified, True otherwise
+ */
+bool Decomposition::propagate() {
+    std::vector<std::vector<int>> occurrences(2 * formula->nVars());
+    for (int i = 0; i < formula->nHard(); i++) {
+        vec<Lit> &clause = formula->getHardClause(i).clause;
+        for (int j = 0; j < clause.size(); j++) {
+            occurrences[toInt(clause[j])].push_back(i);
+        }
+    }
+    std::vector<Lit> queue;
+    // checks a hard clause, and fixes its literal if it is unit
+    auto check = [&](int index) {
+        Lit last = lit_Undef;
+        int count = remaining(formula->getHardClause(index).clause, last);
+        if (count == 1) {
+            fixed[var(last)] = sign(last) ? l_False : l_True;
+            queue.push_back(last);
+        }
+        return count != 0;
+    };
+    for (int i = 0; i < formula->nHard(); i++) {
+        if (!check(i)) {
+            return false;
+        }
+    }
+    for (int head = 0; head < queue.size(); head++) {
+        std::vector<int> &falsified = occurrences[toInt(~queue[head])];
+        for (int i = 0; i < falsified.size(); i++) {
+            if (!check(falsified[i])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief      Joins the variables of the remaining clauses into components,
+ * and sorts the clauses into them.
+ */
+void Decomposition::findComponents() {
+    int n = formula->nVars();
+    std::vector<Var> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](Var v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+    std::vector<bool> used(n, false);
+    auto join = [&](vec<Lit> &clause) {
+        Var first = var_Undef;
+        for (int i = 0; i < clause.size(); i++) {
+            if (value(clause[i]) != l_Undef) {
+                continue;
+            }
+            Var v = var(clause[i]);
+            used[v] = true;
+            if (first == var_Undef) {
+                first = v;
+            } else {
+                parent[find(v)] = find(first);
+            }
+        }
+        return first;
+    };
+    std::vector<Var> hardFirst(formula->nHard()), softFirst(formula->nSoft());
+    for (int i = 0; i < formula->nHard(); i++) {
+        Lit last;
+        vec<Lit> &clause = formula->getHardClause(i).clause;
+        hardFirst[i] = remaining(clause, last) > 0 ? join(clause) : var_Undef;
+    }
+    for (int i = 0; i < formula->nSoft(); i++) {
+        Lit last;
+        Soft &soft = formula->getSoftClause(i);
+        int count = remaining(soft.clause, last);
+        if (count == 0) {
+            fixedCost += soft.weight;
+        }
+        softFirst[i] = count > 0 ? join(soft.clause) : var_Undef;
+    }
+
+    std::vector<int> rootComponent(n, -1);
+    component.assign(n, -1);
+    localVar.assign(n, var_Undef);
+    for (Var v = 0; v < n; v++) {
+        if (!used[v]) {
+            continue;
+        }
+        Var root = find(v);
+        if (rootComponent[root] == -1) {
+            rootComponent[root] = componentVars.size();
+            componentVars.push_back(std::vector<Var>());
+        }
+        component[v] = rootComponent[root];
+        localVar[v] = componentVars[component[v]].size();
+        componentVars[component[v]].push_back(v);
+    }
+    componentHard.resize(componentVars.size());
+    componentSoft.resize(componentVars.size());
+    for (int i = 0; i < formula->nHard(); i++) {
+        if (hardFirst[i] != var_Undef) {
+            componentHard[component[hardFirst[i]]].push_back(i);
+        }
+    }
+    for (int i = 0; i < formula->nSoft(); i++) {
+        if (softFirst[i] != var_Undef) {
+            componentSoft[component[softFirst[i]]].push_back(i);
+        }
+    }
+}
+
+/**
+ * @brief      Checks if the hard clauses were found to be unsatisfiable
+ * while propagating them.
+ *
+ * @return     True if they are unsatisfiable, False if it is not known
+ */
+bool Decomposition::isConflicting() { return conflicting; }
+
+/**
+ * @brief      Gets the number of components.
+ *
+ * @return     The number of components
+ */
+int Decomposition::getComponentCount() { return componentVars.size(); }
+
+/**
+ * @brief      Gets the weight of the soft clauses falsified by the fixed
+ * values, which is part of the cost of every model.
+ *
+ * @return     The weight
+ */
+uint64_t Decomposition::getFixedCost() { return fixedCost; }
+
+/**
+ * @brief      Gets the hard clauses of a component.
+ *
+ * @param[in]  index  The index of the component
+ *
+ * @return     The indices of the hard clauses in the decomposed formula
+ */
+std::vector<int> Decomposition::getHardClauses(int index) {
+    return componentHard[index];
+}
+
+/**
+ * @brief      Adds the literals of a clause that are not fixed to a clause of
+ * a component formula, renamed to the variables of the component.
+ *
+ * @param      clause  The clause
+ * @param      local   The clause of the component formula
+ */
+void Decomposition::addLits(vec<Lit> &clause, vec<Lit> &local) {
+    for (int i = 0; i < clause.size(); i++) {
+        if (value(clause[i]) == l_Undef) {
+            local.push(mkLit(localVar[var(clause[i])], sign(clause[i])));
+        }
+    }
+}
+
+/**
+ * @brief      Builds the formula of a component, with the fixed literals
+ * removed from its clauses.
+ *
+ * @param[in]  index  The index of the component
+ *
+ * @return     The formula, owned by the caller
+ */
+MaxSATFormula *Decomposition::buildFormula(int index) {
+    MaxSATFormula *result = new MaxSATFormula();
+    result->setProblemType(_WEIGHTED_);
+    for (int i = 0; i < componentVars[index].size(); i++) {
+        result->newVar();
+    }
+    for (int i = 0; i < componentHard[index].size(); i++) {
+        vec<Lit> local;
+        addLits(formula->getHardClause(componentHard[index][i]).clause, local);
+        result->addHardClause(local);
+    }
+    for (int i = 0; i < componentSoft[index].size(); i++) {
+        Soft &soft = formula->getSoftClause(componentSoft[index][i]);
+        vec<Lit> local;
+        addLits(soft.clause, local);
+        result->addSoftClause(soft.weight, local);
+    }
+    return result;
+}
+
+/**
+ * @brief      Gets the phase hints that fall in a component, renamed to the
+ * variables of the component.
+ *
+ * @param[in]  index  The index of the component
+ * @param[in]  hints  The hints over the whole formula
+ *
+ * @return     The hints of the component
+ */
+std::vector<Lit> Decomposition::localHints(int index,
+                                           const std::vector<Lit> &hints) {
+    std::vector<Lit> result;
+    for (int i = 0; i < hints.size(); i++) {
+        if (component[var(hints[i])] == index) {
+            result.push_back(mkLit(localVar[var(hints[i])], sign(hints[i])));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief      Gets a model of the whole formula with the fixed values set,
+ * and all the other variables False.
+ *
+ * @return     The model
+ */
+std::vector<lbool> Decomposition::getFixedModel() {
+    std::vector<lbool> model(fixed.size(), l_False);
+    for (int i = 0; i < fixed.size(); i++) {
+        if (fixed[i] != l_Undef) {
+            model[i] = fixed[i];
+        }
+    }
+    return model;
+}
+
+/**
+ * @brief      Copies the model of a component formula into a model of the
+ * whole formula.
+ *
+ * @param[in]  index       The index of the component
+ * @param[in]  localModel  The model of the component formula
+ * @param      model       The model of the whole formula
+ */
+void Decomposition::mergeModel(int index, const std::vector<lbool> &localModel,
+                               std::vector<lbool> &model) {
+    for (int i = 0; i < componentVars[index].size(); i++) {
+        model[componentVars[index][i]] = localModel[i];
+    }
+}
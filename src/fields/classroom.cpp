@@ -6,11 +6,14 @@
 /**
  * @brief      Constructs the object.
  *
- * @param[in]  number  The Classroom number, a unique identifier
- * @param[in]  size    The number of students the Classroom can hold
+ * @param[in]  number   The Classroom number, a unique identifier
+ * @param[in]  size     The number of students the Classroom can hold
+ * @param      symbols  The table in which the number is interned
  */
-Classroom::Classroom(std::string number, unsigned size) {
-    this->number = number;
+Classroom::Classroom(const std::string &number, unsigned size,
+                     SymbolTable &symbols) {
+    this->number = symbols.intern(number);
+    this->symbols = &symbols;
     this->size = size;
 }
 
@@ -58,7 +61,14 @@ std::string Classroom::getTypeName() { return "Classroom"; }
  *
  * @return     The class number, which is unique identifier of the Classroom
  */
-std::string Classroom::getName() { return number; }
+std::string Classroom::getName() { return symbols->getName(number); }
+
+/**
+ * @brief      Gets the id of the class number of the Classroom.
+ *
+ * @return     The id, in the table in which the number is interned
+ */
+int Classroom::getNameId() { return number; }
 
 /**
  * @brief      Gets the size of the Classroom.
@@ -15,10 +15,12 @@
  * @param[in]  instructor  The instructor index of the course
  * @param[in]  segment     The segment index of the course
  * @param[in]  isMinor     Indicates if the course is a minor course
+ * @param      symbols     The table in which the name is interned
  */
-Course::Course(std::string name, unsigned classSize, int instructor,
-               int segment, int isMinor) {
-    this->name = name;
+Course::Course(const std::string &name, unsigned classSize, int instructor,
+               int segment, int isMinor, SymbolTable &symbols) {
+    this->name = symbols.intern(name);
+    this->symbols = &symbols;
     this->classSize = classSize;
     this->instructor = instructor;
     this->segment = segment;
@@ -35,10 +37,13 @@ Course::Course(std::string name, unsigned classSize, int instructor,
  * @param[in]  isMinor     Indicates if the course is a minor course
  * @param[in]  programs    The indices of the programs for which the course is
  * applicable
+ * @param      symbols     The table in which the name is interned
  */
-Course::Course(std::string name, unsigned classSize, int instructor,
-               int segment, int isMinor, std::vector<int> programs) {
-    this->name = name;
+Course::Course(const std::string &name, unsigned classSize, int instructor,
+               int segment, int isMinor, std::vector<int> programs,
+               SymbolTable &symbols) {
+    this->name = symbols.intern(name);
+    this->symbols = &symbols;
     this->classSize = classSize;
     this->instructor = instructor;
     this->segment = segment;
@@ -80,7 +85,14 @@ bool Course::operator==(const Course &other) {
  *
  * @return     The name.of the Course
  */
-std::string Course::getName() { return name; }
+std::string Course::getName() { return symbols->getName(name); }
+
+/**
+ * @brief      Gets the id of the name of the Course.
+ *
+ * @return     The id, in the table in which the name is interned
+ */
+int Course::getNameId() { return name; }
 
 /**
  * @brief      Gets the instructor index of the Course.
@@ -6,10 +6,14 @@
 /**
  * @brief      Constructs the Instructor object.
  *
- * @param[in]  name  The name of the Instructor, which uniquely identifies the
- * Instructor
+ * @param[in]  name     The name of the Instructor, which uniquely identifies
+ * the Instructor
+ * @param      symbols  The table in which the name is interned
  */
-Instructor::Instructor(std::string name) { this->name = name; }
+Instructor::Instructor(const std::string &name, SymbolTable &symbols) {
+    this->name = symbols.intern(name);
+    this->symbols = &symbols;
+}
 
 /**
  * @brief      Checks if two Instructor objects are identical, i.e., if both
@@ -35,7 +39,14 @@ FieldType Instructor::getType() { return FieldType::instructor; }
  *
  * @return     The name of the Instructor
  */
-std::string Instructor::getName() { return name; }
+std::string Instructor::getName() { return symbols->getName(name); }
+
+/**
+ * @brief      Gets the id of the name of the Instructor.
+ *
+ * @return     The id, in the table in which the name is interned
+ */
+int Instructor::getNameId() { return name; }
 
 /**
  * @brief      Gets the type name, which is "Instructor".
@@ -9,9 +9,12 @@
  * @param[in]  name        The name of the Program, which uniquely identifies
  * it. For example, it could be "B Tech 1".
  * @param[in]  courseType  The course type, which could be core or elective
+ * @param      symbols     The table in which the name is interned
  */
-Program::Program(std::string name, CourseType courseType) {
-    this->name = name;
+Program::Program(const std::string &name, CourseType courseType,
+                 SymbolTable &symbols) {
+    this->name = symbols.intern(name);
+    this->symbols = &symbols;
     this->courseType = courseType;
 }
 
@@ -40,7 +43,15 @@ FieldType Program::getType() { return FieldType::program; }
  *
  * @return     The name of the Program
  */
-std::string Program::getName() { return name; }
+std::string Program::getName() { return symbols->getName(name); }
+
+/**
+ * @brief      Gets the id of the name of the Program, which is shared by its
+ * core and elective Program objects.
+ *
+ * @return     The id, in the table in which the name is interned
+ */
+int Program::getNameId() { return name; }
 
 /**
  * @brief      Determines if the Program has a Course as core.
@@ -76,5 +87,5 @@ std::string Program::getCourseTypeName() {
  * @return     The name with type
  */
 std::string Program::getNameWithType() {
-    return name + " " + getCourseTypeName();
+    return getName() + " " + getCourseTypeName();
 }
\ No newline at end of file
@@ -39,6 +39,20 @@ bool Segment::operator==(const Segment &other) {
  */
 int Segment::length() { return (endSegment - startSegment + 1); }
 
+/**
+ * @brief      Gets the start segment ID of the Segment.
+ *
+ * @return     The start segment ID
+ */
+int Segment::getStartSegment() { return startSegment; }
+
+/**
+ * @brief      Gets the end segment ID of the Segment.
+ *
+ * @return     The end segment ID
+ */
+int Segment::getEndSegment() { return endSegment; }
+
 /**
  * @brief      Determines if two Segments are intersecting.
  *             Two segments are said to be intersecting if they contain a common
@@ -112,6 +112,20 @@ std::string Time::getTimeString() {
     return std::to_string(hours) + ":" + std::to_string(minutes);
 }
 
+/**
+ * @brief      Gets the hours.
+ *
+ * @return     The hours, in the 24 hour format
+ */
+unsigned Time::getHours() { return hours; }
+
+/**
+ * @brief      Gets the minutes.
+ *
+ * @return     The minutes
+ */
+unsigned Time::getMinutes() { return minutes; }
+
 /**
  * @brief      Determines if the Time is a morning time.
  *
@@ -170,17 +184,40 @@ bool SlotElement::isIntersecting(SlotElement &other) {
  */
 bool SlotElement::isMorningSlotElement() { return startTime.isMorningTime(); }
 
+/**
+ * @brief      Gets the Day of the SlotElement.
+ *
+ * @return     The day
+ */
+Day SlotElement::getDay() { return day; }
+
+/**
+ * @brief      Gets the start Time of the SlotElement.
+ *
+ * @return     The start time
+ */
+Time SlotElement::getStartTime() { return startTime; }
+
+/**
+ * @brief      Gets the end Time of the SlotElement.
+ *
+ * @return     The end time
+ */
+Time SlotElement::getEndTime() { return endTime; }
+
 /**
  * @brief      Constructs the Slot object.
  *
  * @param[in]  name          The name of the Slot
  * @param[in]  isMinor       Indicates if it is a minor Slot
  * @param[in]  slotElements  The slot elements in the Slot
+ * @param      symbols       The table in which the name is interned
  */
-Slot::Slot(std::string name, IsMinor isMinor,
-           std::vector<SlotElement> slotElements)
+Slot::Slot(const std::string &name, IsMinor isMinor,
+           std::vector<SlotElement> slotElements, SymbolTable &symbols)
     : isMinor(isMinor) {
-    this->name = name;
+    this->name = symbols.intern(name);
+    this->symbols = &symbols;
     this->slotElements = slotElements;
 }
 
@@ -240,6 +277,22 @@ bool Slot::isMinorSlot() {
     return isMinor.getMinorType() == MinorType::isMinorCourse;
 }
 
+/**
+ * @brief      Determines if the Slot has a SlotElement on a given Day.
+ *
+ * @param[in]  day   The day
+ *
+ * @return     True if the Slot meets on the day, False otherwise.
+ */
+bool Slot::isOnDay(Day day) {
+    for (int i = 0; i < slotElements.size(); i++) {
+        if (slotElements[i].getDay() == day) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief      Gets the type name, which is "Slot".
  *
@@ -252,7 +305,14 @@ std::string Slot::getTypeName() { return "Slot"; }
  *
  * @return     The name.
  */
-std::string Slot::getName() { return name; }
+std::string Slot::getName() { return symbols->getName(name); }
+
+/**
+ * @brief      Gets the id of the name of the Slot.
+ *
+ * @return     The id, in the table in which the name is interned
+ */
+int Slot::getNameId() { return name; }
 
 /**
  * @brief      Determines if the Slot is a morning Slot.
@@ -269,4 +329,11 @@ bool Slot::isMorningSlot() {
         }
     }
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief      Gets the slot elements that define the Slot.
+ *
+ * @return     The slot elements
+ */
+std::vector<SlotElement> Slot::getSlotElements() { return slotElements; }
\ No newline at end of file
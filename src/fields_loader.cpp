@@ -0,0 +1,579 @@
+#include "fields_loader.h"
+
+#include "data.h"
+#include "fields/classroom.h"
+#include "fields/instructor.h"
+#include "fields/is_minor.h"
+#include "fields/program.h"
+#include "fields/segment.h"
+#include "fields/slot.h"
+#include "global.h"
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <istream>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+/**
+ * The keys of the weights map
+ */
+static const char *WEIGHT_NAMES[] = {"instructor", "segment",   "is_minor",
+                                     "program",    "classroom", "slot"};
+
+/**
+ * The FieldType of each key of the weights map
+ */
+static const FieldType WEIGHT_FIELDS[] = {
+    FieldType::instructor, FieldType::segment,   FieldType::isMinor,
+    FieldType::program,    FieldType::classroom, FieldType::slot};
+
+/**
+ * The number of keys of the weights map
+ */
+static const int WEIGHT_COUNT = 6;
+
+/**
+ * The bit of segmentsSeen that is set once the segments are added
+ */
+static const unsigned SEGMENTS_ADDED = 4;
+
+/**
+ * @brief      Constructs the FieldsLoader object.
+ *
+ * @param      data  The Data to which the fields are added
+ */
+FieldsLoader::FieldsLoader(Data &data)
+    : data(data), periodStart(0, 0), periodEnd(0, 0) {
+    classroomSize = 0;
+    slotIsMinor = false;
+    periodDay = Day::Monday;
+    clause = 0;
+    clauseWeight = 0;
+    segmentStart = 0;
+    segmentEnd = 0;
+    classroomSeen = 0;
+    slotSeen = 0;
+    periodSeen = 0;
+    predefinedSeen = 0;
+    segmentsSeen = 0;
+}
+
+/**
+ * @brief      Loads the fields from a stream.
+ *
+ * @param      in    The stream
+ *
+ * @return     True if the fields are valid, False otherwise, see getError()
+ */
+bool FieldsLoader::load(std::istream &in) {
+    data.isMinors.push_back(IsMinor(MinorType::isMinorCourse));
+    data.isMinors.push_back(IsMinor(MinorType::isNotMinorCourse));
+    try {
+        YAML::Parser parser(in);
+        if (!parser.HandleNextDocument(*this)) {
+            fail(YAML::Mark(), "the file has no fields");
+        }
+    } catch (const YAML::ParserException &e) {
+        fail(e.mark, e.msg);
+    }
+    return error.empty();
+}
+
+/**
+ * @brief      Records an error, if none was recorded before.
+ *
+ * @param[in]  mark     The position of the error
+ * @param[in]  message  The error
+ */
+void FieldsLoader::fail(const YAML::Mark &mark, const std::string &message) {
+    if (error.empty()) {
+        error = message;
+        errorMark = mark;
+    }
+}
+
+/**
+ * @brief      Gets the error that stopped the loading.
+ *
+ * @return     The error, empty if there is none
+ */
+std::string FieldsLoader::getError() { return error; }
+
+/**
+ * @brief      Gets the line of the error.
+ *
+ * @return     The line, counting from 1
+ */
+int FieldsLoader::getErrorLine() { return errorMark.line + 1; }
+
+/**
+ * @brief      Gets the column of the error.
+ *
+ * @return     The column, counting from 1
+ */
+int FieldsLoader::getErrorColumn() { return errorMark.column + 1; }
+
+/**
+ * @brief      Sets the path of the value that the innermost node is at.
+ */
+void FieldsLoader::beginValue() {
+    valuePath = path;
+    valuePath += '/';
+    if (nodes.back().isMap) {
+        valuePath += nodes.back().key;
+    } else {
+        valuePath += '-';
+    }
+}
+
+/**
+ * @brief      Moves the innermost node on to its next key or element.
+ */
+void FieldsLoader::endValue() {
+    if (nodes.back().isMap) {
+        nodes.back().expectingKey = true;
+    } else {
+        nodes.back().index++;
+    }
+}
+
+/**
+ * @brief      Enters a map or sequence, and starts the item it holds.
+ *
+ * @param[in]  mark   The position of the node
+ * @param[in]  isMap  Whether the node is a map, rather than a sequence
+ */
+void FieldsLoader::beginNode(const YAML::Mark &mark, bool isMap) {
+    if (!error.empty()) {
+        return;
+    }
+    if (nodes.empty() && !isMap) {
+        fail(mark, "the fields must be a map");
+        return;
+    }
+    if (!nodes.empty() && nodes.back().isMap && nodes.back().expectingKey) {
+        fail(mark, "keys must be scalars");
+        return;
+    }
+    FieldsNode node;
+    node.isMap = isMap;
+    node.expectingKey = true;
+    node.index = 0;
+    node.parentPathLength = path.size();
+    node.mark = mark;
+    if (!nodes.empty()) {
+        beginValue();
+        path = valuePath;
+    }
+    nodes.push_back(node);
+    if (!isMap) {
+        return;
+    }
+    if (path == "/classrooms/-") {
+        classroomSeen = 0;
+    } else if (path == "/slots/-") {
+        slotSeen = 0;
+        slotElements.clear();
+    } else if (path == "/slots/-/time_periods/-") {
+        periodSeen = 0;
+    } else if (path == "/predefined_weights/-") {
+        predefinedSeen = 0;
+    } else if (path == "/segments") {
+        segmentsSeen = 0;
+    }
+}
+
+/**
+ * @brief      Leaves the innermost map or sequence, and adds the item it
+ * holds.
+ */
+void FieldsLoader::endNode() {
+    if (!error.empty()) {
+        return;
+    }
+    FieldsNode &node = nodes.back();
+    if (node.isMap) {
+        onMapEnd(node.mark);
+    } else if (path.compare(0, 9, "/weights/") == 0) {
+        for (int i = 0; i < WEIGHT_COUNT; i++) {
+            if (WEIGHT_FIELDS[i] != FieldType::program &&
+                path.compare(9, std::string::npos, WEIGHT_NAMES[i]) == 0) {
+                if (node.index != 2) {
+                    fail(node.mark, "the weights of " +
+                                        std::string(WEIGHT_NAMES[i]) +
+                                        " must be an assignment and a high "
+                                        "level weight");
+                }
+            }
+        }
+    }
+    path.resize(node.parentPathLength);
+    nodes.pop_back();
+    if (!nodes.empty()) {
+        endValue();
+    }
+}
+
+/**
+ * @brief      Handles a scalar value by its path.
+ *
+ * @param[in]  mark   The position of the value
+ * @param[in]  value  The value
+ */
+void FieldsLoader::onValue(const YAML::Mark &mark, const std::string &value) {
+    int number = 0;
+    if (valuePath == "/instructors/-") {
+        data.instructors.push_back(Instructor(value, data.symbols));
+    } else if (valuePath == "/programs/-") {
+        data.programs.push_back(
+            Program(value, CourseType::core, data.symbols));
+        data.programs.push_back(
+            Program(value, CourseType::elective, data.symbols));
+    } else if (valuePath == "/classrooms/-/number") {
+        classroomNumber = value;
+        classroomSeen |= 1;
+    } else if (valuePath == "/classrooms/-/size") {
+        if (!parseInt(value, number) || number < 0) {
+            fail(mark, "invalid classroom size " + value);
+        }
+        classroomSize = number;
+        classroomSeen |= 2;
+    } else if (valuePath == "/segments/start") {
+        if (!parseInt(value, number) || number < 0) {
+            fail(mark, "invalid segment start " + value);
+        }
+        segmentStart = number;
+        segmentsSeen |= 1;
+    } else if (valuePath == "/segments/end") {
+        if (!parseInt(value, number) || number < 0) {
+            fail(mark, "invalid segment end " + value);
+        }
+        segmentEnd = number;
+        segmentsSeen |= 2;
+    } else if (valuePath == "/slots/-/name") {
+        slotName = value;
+        slotSeen |= 1;
+    } else if (valuePath == "/slots/-/is_minor") {
+        if (!parseBool(value, slotIsMinor)) {
+            fail(mark, "invalid is_minor value " + value +
+                           " (should be true or false)");
+        }
+        slotSeen |= 2;
+    } else if (valuePath == "/slots/-/time_periods/-/day") {
+        if (!parseDay(value, periodDay)) {
+            fail(mark, "invalid day " + value);
+        }
+        periodSeen |= 1;
+    } else if (valuePath == "/slots/-/time_periods/-/start") {
+        if (!parseTime(value, periodStart)) {
+            fail(mark, "invalid time " + value + " (should be HH:MM)");
+        }
+        periodSeen |= 2;
+    } else if (valuePath == "/slots/-/time_periods/-/end") {
+        if (!parseTime(value, periodEnd)) {
+            fail(mark, "invalid time " + value + " (should be HH:MM)");
+        }
+        periodSeen |= 4;
+    } else if (valuePath == "/predefined_weights/-/clause") {
+        if (!parseInt(value, clause) || clause < 0 ||
+            clause >= data.predefinedClausesWeights.size()) {
+            fail(mark, "invalid predefined clause " + value);
+        }
+        predefinedSeen |= 1;
+    } else if (valuePath == "/predefined_weights/-/weight") {
+        if (!parseInt(value, clauseWeight)) {
+            fail(mark, "invalid weight " + value);
+        }
+        predefinedSeen |= 2;
+    } else if (valuePath.compare(0, 9, "/weights/") == 0) {
+        onWeight(mark, value, nodes.back().index);
+    }
+}
+
+/**
+ * @brief      Handles a value of the weights map. The program has a single
+ * assignment weight, and every other FieldType a sequence of an assignment
+ * weight and a high level weight.
+ *
+ * @param[in]  mark   The position of the value
+ * @param[in]  value  The value
+ * @param[in]  index  The index of the value in its sequence
+ */
+void FieldsLoader::onWeight(const YAML::Mark &mark, const std::string &value,
+                            int index) {
+    for (int i = 0; i < WEIGHT_COUNT; i++) {
+        std::string name = "/weights/" + std::string(WEIGHT_NAMES[i]);
+        FieldType fieldType = WEIGHT_FIELDS[i];
+        int weight;
+        if (fieldType == FieldType::program ? valuePath != name
+                                            : valuePath != name + "/-") {
+            continue;
+        }
+        if (!parseInt(value, weight)) {
+            fail(mark, "invalid weight " + value);
+        } else if (fieldType == FieldType::program) {
+            data.existingAssignmentWeights[fieldType] = weight;
+        } else if (index == 0) {
+            data.existingAssignmentWeights[fieldType] = weight;
+        } else if (index == 1) {
+            data.highLevelVarWeights[fieldType] = 2 * weight;
+        }
+        return;
+    }
+}
+
+/**
+ * @brief      Adds the item held by a map that ends, once all its values are
+ * read.
+ *
+ * @param[in]  mark  The position of the map
+ */
+void FieldsLoader::onMapEnd(const YAML::Mark &mark) {
+    if (path == "/classrooms/-") {
+        if (classroomSeen != 3) {
+            fail(mark, "a classroom needs a number and a size");
+            return;
+        }
+        data.classrooms.push_back(
+            Classroom(classroomNumber, classroomSize, data.symbols));
+    } else if (path == "/slots/-/time_periods/-") {
+        if (periodSeen != 7) {
+            fail(mark, "a time period needs a day, a start and an end");
+            return;
+        }
+        slotElements.push_back(SlotElement(periodStart, periodEnd, periodDay));
+    } else if (path == "/slots/-") {
+        if ((slotSeen & 3) != 3) {
+            fail(mark, "a slot needs a name and is_minor");
+            return;
+        }
+        IsMinor isMinor = slotIsMinor ? MinorType::isMinorCourse
+                                      : MinorType::isNotMinorCourse;
+        data.slots.push_back(
+            Slot(slotName, isMinor, slotElements, data.symbols));
+    } else if (path == "/predefined_weights/-") {
+        if (predefinedSeen != 3) {
+            fail(mark, "a predefined weight needs a clause and a weight");
+            return;
+        }
+        data.predefinedClausesWeights[clause] = clauseWeight;
+    } else if (path == "/segments") {
+        if (segmentsSeen != 3) {
+            fail(mark, "the segments need a start and an end");
+            return;
+        }
+        for (unsigned i = segmentStart; i <= segmentEnd; ++i) {
+            for (unsigned j = i; j <= segmentEnd; ++j) {
+                data.segments.push_back(Segment(i, j));
+            }
+        }
+        segmentsSeen |= SEGMENTS_ADDED;
+    }
+}
+
+/**
+ * @brief      Parses an integer.
+ *
+ * @param[in]  value   The string
+ * @param      result  Set to the integer
+ *
+ * @return     True if the string is an integer, False otherwise
+ */
+bool FieldsLoader::parseInt(const std::string &value, int &result) {
+    if (value.empty()) {
+        return false;
+    }
+    char *end;
+    errno = 0;
+    long number = std::strtol(value.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || number < INT_MIN ||
+        number > INT_MAX) {
+        return false;
+    }
+    result = number;
+    return true;
+}
+
+/**
+ * @brief      Parses a boolean, as YAML does.
+ *
+ * @param[in]  value   The string, such as "true", "yes", "false" or "no"
+ * @param      result  Set to the boolean
+ *
+ * @return     True if the string is a boolean, False otherwise
+ */
+bool FieldsLoader::parseBool(const std::string &value, bool &result) {
+    std::string lower = value;
+    for (int i = 0; i < lower.size(); i++) {
+        lower[i] = std::tolower((unsigned char)lower[i]);
+    }
+    if (lower == "true" || lower == "yes" || lower == "on" || lower == "y") {
+        result = true;
+        return true;
+    }
+    if (lower == "false" || lower == "no" || lower == "off" || lower == "n") {
+        result = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief      Parses a day, such as "Monday".
+ *
+ * @param[in]  value   The string
+ * @param      result  Set to the member of the Day enum
+ *
+ * @return     True if the string is a day, False otherwise
+ */
+bool FieldsLoader::parseDay(const std::string &value, Day &result) {
+    const char *days[] = {"Monday", "Tuesday",  "Wednesday", "Thursday",
+                          "Friday", "Saturday", "Sunday"};
+    for (int i = 0; i < 7; i++) {
+        if (value == days[i]) {
+            result = static_cast<Day>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief      Parses a time of the 24 hour format, such as "09:30".
+ *
+ * @param[in]  value   The string
+ * @param      result  Set to the Time
+ *
+ * @return     True if the string is a valid time, False otherwise
+ */
+bool FieldsLoader::parseTime(const std::string &value, Time &result) {
+    size_t colon = value.find(':');
+    if (colon < 1 || colon > 2 || value.size() != colon + 3) {
+        return false;
+    }
+    unsigned hours = 0, minutes = 0;
+    for (size_t i = 0; i < value.size(); i++) {
+        if (i == colon) {
+            continue;
+        }
+        if (!std::isdigit((unsigned char)value[i])) {
+            return false;
+        }
+        unsigned &part = i < colon ? hours : minutes;
+        part = 10 * part + (value[i] - '0');
+    }
+    if (hours > 23 || minutes > 59) {
+        return false;
+    }
+    result = Time(hours, minutes);
+    return true;
+}
+
+/**
+ * @brief      Starts the document.
+ *
+ * @param[in]  mark  The position of the document
+ */
+void FieldsLoader::OnDocumentStart(const YAML::Mark &mark) {
+    documentMark = mark;
+}
+
+/**
+ * @brief      Ends the document, checking that the segments were given. The
+ * weights that were not given keep their defaults.
+ */
+void FieldsLoader::OnDocumentEnd() {
+    if (error.empty() && !(segmentsSeen & SEGMENTS_ADDED)) {
+        fail(documentMark, "the fields have no segments");
+    }
+}
+
+/**
+ * @brief      Handles a null, as an empty scalar.
+ *
+ * @param[in]  mark    The position of the null
+ * @param[in]  anchor  The anchor of the null
+ */
+void FieldsLoader::OnNull(const YAML::Mark &mark, YAML::anchor_t anchor) {
+    OnScalar(mark, "", anchor, "");
+}
+
+/**
+ * @brief      Rejects an alias, as the fields are not built as a document
+ * that it could refer back to.
+ *
+ * @param[in]  mark    The position of the alias
+ * @param[in]  anchor  The anchor the alias refers to
+ */
+void FieldsLoader::OnAlias(const YAML::Mark &mark, YAML::anchor_t anchor) {
+    fail(mark, "aliases are not supported in the fields");
+}
+
+/**
+ * @brief      Handles a scalar, which is either a key of a map or a value.
+ *
+ * @param[in]  mark    The position of the scalar
+ * @param[in]  tag     The tag of the scalar
+ * @param[in]  anchor  The anchor of the scalar
+ * @param[in]  value   The scalar
+ */
+void FieldsLoader::OnScalar(const YAML::Mark &mark, const std::string &tag,
+                            YAML::anchor_t anchor, const std::string &value) {
+    if (!error.empty()) {
+        return;
+    }
+    if (nodes.empty()) {
+        fail(mark, "the fields must be a map");
+        return;
+    }
+    if (nodes.back().isMap && nodes.back().expectingKey) {
+        nodes.back().key = value;
+        nodes.back().expectingKey = false;
+        return;
+    }
+    beginValue();
+    onValue(mark, value);
+    endValue();
+}
+
+/**
+ * @brief      Starts a sequence.
+ *
+ * @param[in]  mark    The position of the sequence
+ * @param[in]  tag     The tag of the sequence
+ * @param[in]  anchor  The anchor of the sequence
+ * @param[in]  style   The style of the sequence
+ */
+void FieldsLoader::OnSequenceStart(const YAML::Mark &mark,
+                                   const std::string &tag,
+                                   YAML::anchor_t anchor,
+                                   YAML::EmitterStyle::value style) {
+    beginNode(mark, false);
+}
+
+/**
+ * @brief      Ends a sequence.
+ */
+void FieldsLoader::OnSequenceEnd() { endNode(); }
+
+/**
+ * @brief      Starts a map.
+ *
+ * @param[in]  mark    The position of the map
+ * @param[in]  tag     The tag of the map
+ * @param[in]  anchor  The anchor of the map
+ * @param[in]  style   The style of the map
+ */
+void FieldsLoader::OnMapStart(const YAML::Mark &mark, const std::string &tag,
+                              YAML::anchor_t anchor,
+                              YAML::EmitterStyle::value style) {
+    beginNode(mark, true);
+}
+
+/**
+ * @brief      Ends a map.
+ */
+void FieldsLoader::OnMapEnd() { endNode(); }
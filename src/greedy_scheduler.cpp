@@ -0,0 +1,455 @@
+#include "greedy_scheduler.h"
+
+#include "core/SolverTypes.h"
+#include "data.h"
+#include "global.h"
+#include <algorithm>
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * @brief      Constructs the GreedyScheduler object.
+ *
+ * @param      data  The data for which the schedule is made
+ */
+GreedyScheduler::GreedyScheduler(Data &data) : data(data) {}
+
+/**
+ * @brief      Checks if a predefined constraint is enabled, that is, if it
+ * has a non zero weight.
+ *
+ * @param[in]  clause  The predefined constraint
+ *
+ * @return     True if enabled, False otherwise
+ */
+bool GreedyScheduler::isEnabled(PredefinedClauses clause) {
+    return data.predefinedClausesWeights[clause] != 0;
+}
+
+/**
+ * @brief      Checks if a predefined constraint is hard.
+ *
+ * @param[in]  clause  The predefined constraint
+ *
+ * @return     True if hard, False otherwise
+ */
+bool GreedyScheduler::isHard(PredefinedClauses clause) {
+    return data.predefinedClausesWeights[clause] < 0;
+}
+
+/**
+ * @brief      Builds the conflicts between courses, and the intersection
+ * tables of slots and segments.
+ *
+ * Two courses conflict if they have the same Instructor, or if they are both
+ * core for some Program. Courses are bucketed by Instructor and core Program,
+ * so that only the pairs that actually conflict are looked at. The classrooms
+ * are also sorted by size here.
+ */
+void GreedyScheduler::buildConflicts() {
+    int courseCount = data.courses.size();
+    std::vector<std::vector<int>> buckets;
+    if (isEnabled(PredefinedClauses::instructorSingleCourseAtATime)) {
+        std::vector<std::vector<int>> instructorCourses(
+            data.instructors.size());
+        for (int i = 0; i < courseCount; i++) {
+            instructorCourses[data.courses[i].getInstructor()].push_back(i);
+        }
+        buckets.insert(buckets.end(), instructorCourses.begin(),
+                       instructorCourses.end());
+    }
+    if (isEnabled(PredefinedClauses::programSingleCoreCourseAtATime)) {
+        std::vector<std::vector<int>> programCourses(data.programs.size());
+        for (int i = 0; i < courseCount; i++) {
+            std::vector<int> programs = data.courses[i].getPrograms();
+            for (int j = 0; j < programs.size(); j++) {
+                if (data.programs[programs[j]].isCoreProgram()) {
+                    programCourses[programs[j]].push_back(i);
+                }
+            }
+        }
+        buckets.insert(buckets.end(), programCourses.begin(),
+                       programCourses.end());
+    }
+    neighbours.assign(courseCount, std::vector<int>());
+    for (int b = 0; b < buckets.size(); b++) {
+        for (int i = 0; i < buckets[b].size(); i++) {
+            for (int j = i + 1; j < buckets[b].size(); j++) {
+                neighbours[buckets[b][i]].push_back(buckets[b][j]);
+                neighbours[buckets[b][j]].push_back(buckets[b][i]);
+            }
+        }
+    }
+    for (int i = 0; i < courseCount; i++) {
+        std::sort(neighbours[i].begin(), neighbours[i].end());
+        neighbours[i].erase(
+            std::unique(neighbours[i].begin(), neighbours[i].end()),
+            neighbours[i].end());
+    }
+
+    slotIntersecting.assign(data.slots.size(),
+                            std::vector<bool>(data.slots.size(), false));
+    for (int i = 0; i < data.slots.size(); i++) {
+        for (int j = 0; j < data.slots.size(); j++) {
+            slotIntersecting[i][j] =
+                data.slots[i].isIntersecting(data.slots[j]);
+        }
+    }
+    segmentIntersecting.assign(
+        data.segments.size(), std::vector<bool>(data.segments.size(), false));
+    for (int i = 0; i < data.segments.size(); i++) {
+        for (int j = 0; j < data.segments.size(); j++) {
+            segmentIntersecting[i][j] =
+                data.segments[i].isIntersecting(data.segments[j]);
+        }
+    }
+    classroomsBySize.clear();
+    for (int i = 0; i < data.classrooms.size(); i++) {
+        classroomsBySize.push_back(i);
+    }
+    std::stable_sort(classroomsBySize.begin(), classroomsBySize.end(),
+                     [this](int a, int b) {
+                         return data.classrooms[a].getSize() <
+                                data.classrooms[b].getSize();
+                     });
+}
+
+/**
+ * @brief      Checks if two (Slot, Segment) times are intersecting.
+ *
+ * @param[in]  slot1     The slot 1
+ * @param[in]  segment1  The segment 1
+ * @param[in]  slot2     The slot 2
+ * @param[in]  segment2  The segment 2
+ *
+ * @return     True if intersecting, False otherwise
+ */
+bool GreedyScheduler::isIntersecting(int slot1, int segment1, int slot2,
+                                     int segment2) {
+    return slotIntersecting[slot1][slot2] &&
+           segmentIntersecting[segment1][segment2];
+}
+
+/**
+ * @brief      Determines if a Course is a minor course.
+ *
+ * @param[in]  course  The course
+ *
+ * @return     True if minor course, False otherwise
+ */
+bool GreedyScheduler::isMinorCourse(int course) {
+    return data.isMinors[data.courses[course].getIsMinor()].getMinorType() ==
+           MinorType::isMinorCourse;
+}
+
+/**
+ * @brief      Determines if a Course is core, or elective, for some Program.
+ *
+ * @param[in]  course  The course
+ * @param[in]  core    True to look for core programs, False for electives
+ *
+ * @return     True if such a Program exists, False otherwise
+ */
+bool GreedyScheduler::hasProgramOfType(int course, bool core) {
+    std::vector<int> programs = data.courses[course].getPrograms();
+    for (int i = 0; i < programs.size(); i++) {
+        if (data.programs[programs[i]].isCoreProgram() == core) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief      Gets the field value given in the input for a Course.
+ *
+ * @param[in]  course     The course
+ * @param[in]  fieldType  The field type
+ *
+ * @return     The index of the existing field value, -1 if none was given
+ */
+int GreedyScheduler::existingValue(int course, FieldType fieldType) {
+    std::vector<lbool> &existing =
+        data.existingAssignmentVars[course][fieldType];
+    for (int i = 0; i < existing.size(); i++) {
+        if (existing[i] == l_True) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief      Gets the cost of giving a Slot to a Course.
+ *
+ * The cost is the sum of the weights of the soft constraints that would be
+ * violated, which are changing the existing Slot and the morning and
+ * afternoon preferences of core and elective courses. The minor slot rule and
+ * hard constraints forbid the Slot instead.
+ *
+ * @param[in]  course  The course
+ * @param[in]  slot    The slot
+ *
+ * @return     The cost, or -1 if the Slot is forbidden for the Course
+ */
+long long GreedyScheduler::slotCost(int course, int slot) {
+    long long cost = 0;
+    if (isEnabled(PredefinedClauses::minorInMinorTime) &&
+        data.slots[slot].isMinorSlot() != isMinorCourse(course)) {
+        return -1;
+    }
+    int existing = existingValue(course, FieldType::slot);
+    int existingWeight = data.existingAssignmentWeights[FieldType::slot];
+    if (existing != -1 && existing != slot && existingWeight != 0) {
+        if (existingWeight < 0) {
+            return -1;
+        }
+        cost += existingWeight;
+    }
+    bool morning = data.slots[slot].isMorningSlot();
+    if (isEnabled(PredefinedClauses::coreInMorningTime) && !morning &&
+        hasProgramOfType(course, true)) {
+        if (isHard(PredefinedClauses::coreInMorningTime)) {
+            return -1;
+        }
+        cost += data.predefinedClausesWeights
+                    [PredefinedClauses::coreInMorningTime];
+    }
+    if (isEnabled(PredefinedClauses::electiveInNonMorningTime) && morning &&
+        hasProgramOfType(course, false)) {
+        if (isHard(PredefinedClauses::electiveInNonMorningTime)) {
+            return -1;
+        }
+        cost += data.predefinedClausesWeights
+                    [PredefinedClauses::electiveInNonMorningTime];
+    }
+    return cost;
+}
+
+/**
+ * @brief      Finds a free Classroom for a Course at a given time.
+ *
+ * The existing Classroom of the Course is tried first, followed by the others
+ * in increasing order of size, so that large classrooms are kept free for
+ * large courses.
+ *
+ * @param[in]  course   The course
+ * @param[in]  slot     The slot
+ * @param[in]  segment  The segment
+ *
+ * @return     The index of the Classroom, -1 if none is free
+ */
+int GreedyScheduler::findClassroom(int course, int slot, int segment) {
+    std::vector<int> order;
+    int existing = existingValue(course, FieldType::classroom);
+    if (existing != -1) {
+        order.push_back(existing);
+    }
+    if (existing == -1 ||
+        data.existingAssignmentWeights[FieldType::classroom] >= 0) {
+        for (int i = 0; i < classroomsBySize.size(); i++) {
+            if (classroomsBySize[i] != existing) {
+                order.push_back(classroomsBySize[i]);
+            }
+        }
+    }
+    for (int i = 0; i < order.size(); i++) {
+        int room = order[i];
+        if (data.classrooms[room].getSize() <
+            data.courses[course].getClassSize()) {
+            continue;
+        }
+        if (!isEnabled(PredefinedClauses::classroomSingleCourseAtATime)) {
+            return room;
+        }
+        bool free = true;
+        for (int j = 0; j < classroomCourses[room].size() && free; j++) {
+            int other = classroomCourses[room][j];
+            if (isIntersecting(slot, segment, slots[other], segments[other])) {
+                free = false;
+            }
+        }
+        if (free) {
+            return room;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief      Places a Course at its cheapest feasible time and Classroom.
+ *
+ * The Segment given in the input is tried first. Other segments are only
+ * tried if the Segment is allowed to change and no Slot is free with the
+ * given one.
+ *
+ * @param[in]  course  The course
+ *
+ * @return     True if the Course could be placed, False otherwise
+ */
+bool GreedyScheduler::placeCourse(int course) {
+    std::vector<int> segmentOrder;
+    segmentOrder.push_back(data.courses[course].getSegment());
+    if (data.existingAssignmentWeights[FieldType::segment] >= 0) {
+        for (int i = 0; i < data.segments.size(); i++) {
+            if (i != segmentOrder[0]) {
+                segmentOrder.push_back(i);
+            }
+        }
+    }
+    std::vector<std::pair<long long, int>> slotOrder;
+    for (int i = 0; i < data.slots.size(); i++) {
+        long long cost = slotCost(course, i);
+        if (cost >= 0) {
+            slotOrder.push_back(std::make_pair(cost, i));
+        }
+    }
+    std::stable_sort(slotOrder.begin(), slotOrder.end());
+    for (int g = 0; g < segmentOrder.size(); g++) {
+        int segment = segmentOrder[g];
+        for (int i = 0; i < slotOrder.size(); i++) {
+            int slot = slotOrder[i].second;
+            bool clash = false;
+            for (int j = 0; j < neighbours[course].size() && !clash; j++) {
+                int other = neighbours[course][j];
+                if (slots[other] != -1 &&
+                    isIntersecting(slot, segment, slots[other],
+                                   segments[other])) {
+                    clash = true;
+                }
+            }
+            if (clash) {
+                continue;
+            }
+            int room = findClassroom(course, slot, segment);
+            if (room == -1) {
+                continue;
+            }
+            slots[course] = slot;
+            segments[course] = segment;
+            classrooms[course] = room;
+            classroomCourses[room].push_back(course);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief      Schedules all the courses.
+ *
+ * Courses are picked in DSatur order. The saturation of a Course is the
+ * number of slots that are blocked for it, with its given Segment, by the
+ * conflicting courses already scheduled. The unscheduled Course with the
+ * highest saturation is picked next, with ties broken by the number of
+ * conflicting courses.
+ *
+ * @return     True if every Course could be scheduled, False otherwise
+ */
+bool GreedyScheduler::schedule() {
+    int courseCount = data.courses.size();
+    buildConflicts();
+    slots.assign(courseCount, -1);
+    segments.assign(courseCount, -1);
+    classrooms.assign(courseCount, -1);
+    classroomCourses.assign(data.classrooms.size(), std::vector<int>());
+
+    std::vector<std::vector<int>> blocked(
+        courseCount, std::vector<int>(data.slots.size(), 0));
+    std::vector<int> saturation(courseCount, 0);
+    std::vector<bool> done(courseCount, false);
+    bool complete = true;
+    for (int step = 0; step < courseCount; step++) {
+        int next = -1;
+        for (int i = 0; i < courseCount; i++) {
+            if (done[i]) {
+                continue;
+            }
+            if (next == -1 || saturation[i] > saturation[next] ||
+                (saturation[i] == saturation[next] &&
+                 neighbours[i].size() > neighbours[next].size())) {
+                next = i;
+            }
+        }
+        done[next] = true;
+        if (!placeCourse(next)) {
+            complete = false;
+            continue;
+        }
+        for (int j = 0; j < neighbours[next].size(); j++) {
+            int other = neighbours[next][j];
+            if (done[other]) {
+                continue;
+            }
+            int otherSegment = data.courses[other].getSegment();
+            if (!segmentIntersecting[segments[next]][otherSegment]) {
+                continue;
+            }
+            for (int s = 0; s < data.slots.size(); s++) {
+                if (slotIntersecting[slots[next]][s] &&
+                    blocked[other][s]++ == 0) {
+                    saturation[other]++;
+                }
+            }
+        }
+    }
+    return complete;
+}
+
+/**
+ * @brief      Gets the Slot given to a Course.
+ *
+ * @param[in]  course  The course
+ *
+ * @return     The index of the Slot, -1 if the Course could not be scheduled
+ */
+int GreedyScheduler::getSlot(int course) { return slots[course]; }
+
+/**
+ * @brief      Gets the Segment given to a Course.
+ *
+ * @param[in]  course  The course
+ *
+ * @return     The index of the Segment, -1 if the Course could not be
+ * scheduled
+ */
+int GreedyScheduler::getSegment(int course) { return segments[course]; }
+
+/**
+ * @brief      Gets the Classroom given to a Course.
+ *
+ * @param[in]  course  The course
+ *
+ * @return     The index of the Classroom, -1 if the Course could not be
+ * scheduled
+ */
+int GreedyScheduler::getClassroom(int course) { return classrooms[course]; }
+
+/**
+ * @brief      Gets the schedule as phase hints for the solver.
+ *
+ * For every scheduled Course, the variable of its Slot, Segment and Classroom
+ * is hinted True, and the other variables of the same FieldType are hinted
+ * False.
+ *
+ * @return     The hint literals
+ */
+std::vector<Lit> GreedyScheduler::getPhaseHints() {
+    std::vector<Lit> hints;
+    for (int i = 0; i < slots.size(); i++) {
+        if (slots[i] == -1) {
+            continue;
+        }
+        FieldType fieldTypes[] = {FieldType::slot, FieldType::segment,
+                                  FieldType::classroom};
+        int values[] = {slots[i], segments[i], classrooms[i]};
+        for (int f = 0; f < 3; f++) {
+            std::vector<Var> &vars = data.fieldValueVars[i][fieldTypes[f]];
+            for (int j = 0; j < vars.size(); j++) {
+                hints.push_back(mkLit(vars[j], j != values[f]));
+            }
+        }
+    }
+    return hints;
+}
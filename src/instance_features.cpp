@@ -0,0 +1,167 @@
+#include "instance_features.h"
+
+#include "MaxSATFormula.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * The number of entries of the clause length histograms. Clauses of this
+ * length and longer are counted together in the last entry.
+ */
+static const int LENGTH_BUCKETS = 9;
+
+/**
+ * @brief      Constructs the InstanceFeatures object by reading the features
+ * of a formula.
+ *
+ * @param      formula  The formula, before it is relaxed
+ */
+InstanceFeatures::InstanceFeatures(MaxSATFormula *formula) {
+    vars = formula->nVars();
+    hardClauses = formula->nHard();
+    softClauses = formula->nSoft();
+    softHardRatio = hardClauses > 0 ? double(softClauses) / hardClauses : 0;
+    hardLengths.assign(LENGTH_BUCKETS, 0);
+    softLengths.assign(LENGTH_BUCKETS, 0);
+    for (int i = 0; i < hardClauses; i++) {
+        int length = formula->getHardClause(i).clause.size();
+        hardLengths[std::min(std::max(length, 1), LENGTH_BUCKETS) - 1]++;
+    }
+    std::map<uint64_t, int, std::greater<uint64_t>> weightCounts;
+    for (int i = 0; i < softClauses; i++) {
+        Soft &soft = formula->getSoftClause(i);
+        int length = soft.clause.size();
+        softLengths[std::min(std::max(length, 1), LENGTH_BUCKETS) - 1]++;
+        weightCounts[soft.weight]++;
+    }
+    weights.clear();
+    for (auto it = weightCounts.begin(); it != weightCounts.end(); it++) {
+        weights.push_back(it->first);
+    }
+    // from the smallest weight up, each weight must exceed the total weight
+    // of the soft clauses below it
+    lexicographic = weights.size() > 1;
+    uint64_t below = 0;
+    for (auto it = weightCounts.rbegin(); it != weightCounts.rend(); it++) {
+        if (below > 0 && it->first <= below) {
+            lexicographic = false;
+            break;
+        }
+        uint64_t levelWeight = it->first * it->second;
+        if (levelWeight / it->second != it->first ||
+            below > UINT64_MAX - levelWeight) {
+            below = UINT64_MAX;
+        } else {
+            below += levelWeight;
+        }
+    }
+}
+
+/**
+ * @brief      Picks the algorithm for the instance.
+ *
+ * The decision table, checked from the top, is below. It can be overridden
+ * with TSolver::setAlgorithm(). MaxSATAlgorithm::CoreBoosted is only run when
+ * set there, as when it switches over is a budget rather than a feature of
+ * the instance.
+ *
+ * | Features                                    | Algorithm    |
+ * |---------------------------------------------|--------------|
+ * | one weight, no more soft than hard clauses  | MSU3         |
+ * | one weight, more soft than hard clauses     | OLL          |
+ * | lexicographic weights                       | LinearSearch |
+ * | more weights than half the soft clauses     | OLL          |
+ * | otherwise                                   | Stratified   |
+ *
+ * With a single weight, MSU3 keeps one totalizer over the relaxed soft
+ * clauses, which stays small when the cores are few, while OLL builds a
+ * totalizer per core and copes better with the many small cores of instances
+ * dominated by soft clauses. Lexicographic weights are solved one level at a
+ * time, which is exact for them. Stratification only pays off when there are
+ * strata of several clauses each.
+ *
+ * @return     The algorithm
+ */
+MaxSATAlgorithm InstanceFeatures::selectAlgorithm() {
+    if (weights.size() <= 1) {
+        if (softClauses <= hardClauses) {
+            return MaxSATAlgorithm::MSU3;
+        }
+        return MaxSATAlgorithm::OLL;
+    }
+    if (lexicographic) {
+        return MaxSATAlgorithm::LinearSearch;
+    }
+    if (2 * weights.size() > softClauses) {
+        return MaxSATAlgorithm::OLL;
+    }
+    return MaxSATAlgorithm::Stratified;
+}
+
+/**
+ * @brief      Prints the features.
+ */
+void InstanceFeatures::print() {
+    std::cout << "Instance: " << vars << " variables, " << hardClauses
+              << " hard clauses, " << softClauses << " soft clauses, "
+              << weights.size() << " distinct weights"
+              << (lexicographic ? " (lexicographic)" : "") << std::endl;
+    std::cout << "Clause lengths (hard/soft):";
+    for (int i = 0; i < LENGTH_BUCKETS; i++) {
+        std::cout << " " << i + 1 << (i + 1 == LENGTH_BUCKETS ? "+" : "")
+                  << ":" << hardLengths[i] << "/" << softLengths[i];
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief      Gets an algorithm by its name.
+ *
+ * @param[in]  name       The name, which is one of auto, oll, stratified, msu3,
+ * linear and core-boosted
+ * @param      algorithm  Set to the algorithm of the name
+ *
+ * @return     True if the name is valid, False otherwise
+ */
+bool parseAlgorithm(const std::string &name, MaxSATAlgorithm &algorithm) {
+    const MaxSATAlgorithm algorithms[] = {
+        MaxSATAlgorithm::Auto, MaxSATAlgorithm::OLL,
+        MaxSATAlgorithm::Stratified, MaxSATAlgorithm::MSU3,
+        MaxSATAlgorithm::LinearSearch, MaxSATAlgorithm::CoreBoosted};
+    for (int i = 0; i < 6; i++) {
+        if (algorithmName(algorithms[i]) == name) {
+            algorithm = algorithms[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief      Gets the name of an algorithm.
+ *
+ * @param[in]  algorithm  The algorithm
+ *
+ * @return     The name
+ */
+std::string algorithmName(MaxSATAlgorithm algorithm) {
+    switch (algorithm) {
+    case MaxSATAlgorithm::OLL:
+        return "oll";
+    case MaxSATAlgorithm::Stratified:
+        return "stratified";
+    case MaxSATAlgorithm::MSU3:
+        return "msu3";
+    case MaxSATAlgorithm::LinearSearch:
+        return "linear";
+    case MaxSATAlgorithm::CoreBoosted:
+        return "core-boosted";
+    default:
+        return "auto";
+    }
+}
@@ -0,0 +1,121 @@
+#include "interactive.h"
+
+#include "constraint_encoder.h"
+#include "custom_parser.h"
+#include "time_tabler.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief      Constructs the Interactive object.
+ *
+ * @param      timeTabler  The TimeTabler, which has solved once already
+ * @param      encoder     The ConstraintEncoder
+ * @param[in]  outputFile  The output file
+ */
+Interactive::Interactive(TimeTabler *timeTabler, ConstraintEncoder *encoder,
+                         std::string outputFile) {
+    this->timeTabler = timeTabler;
+    this->encoder = encoder;
+    this->outputFile = outputFile;
+}
+
+/**
+ * @brief      Reads the index of a constraint group from a command.
+ *
+ * @param      command  The rest of the command
+ * @param      index    Set to the index
+ *
+ * @return     True if a valid index was read, False otherwise
+ */
+bool Interactive::readGroup(std::istream &command, int &index) {
+    if (!(command >> index) || index < 0 ||
+        index >= timeTabler->getGroupCount()) {
+        std::cout << "No such group" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief      Prints the constraint groups.
+ */
+void Interactive::listGroups() {
+    for (int i = 0; i < timeTabler->getGroupCount(); i++) {
+        int weight = timeTabler->getGroupWeight(i);
+        std::cout << i << ": "
+                  << (weight < 0 ? "hard" : "weight " + std::to_string(weight))
+                  << (timeTabler->isGroupEnabled(i) ? "" : ", disabled")
+                  << std::endl;
+    }
+}
+
+/**
+ * @brief      Solves again, and writes the timetable if one is found.
+ */
+void Interactive::solve() {
+    SolverStatus status = timeTabler->resolve();
+    timeTabler->printResult(status);
+    if (status == SolverStatus::Solved) {
+        timeTabler->writeOutput(outputFile);
+    }
+}
+
+/**
+ * @brief      Runs commands until the input ends or quit is given.
+ *
+ * @param      in    The input the commands are read from
+ */
+void Interactive::run(std::istream &in) {
+    std::string line;
+    while (std::cout << "> " << std::flush, std::getline(in, line)) {
+        std::istringstream command(line);
+        std::string name;
+        if (!(command >> name)) {
+            continue;
+        }
+        int index, weight;
+        if (name == "quit") {
+            return;
+        } else if (name == "groups") {
+            listGroups();
+        } else if (name == "enable") {
+            if (readGroup(command, index)) {
+                timeTabler->enableGroup(index);
+            }
+        } else if (name == "disable") {
+            if (readGroup(command, index)) {
+                timeTabler->disableGroup(index);
+            }
+        } else if (name == "weight") {
+            if (!readGroup(command, index)) {
+                continue;
+            }
+            if (!(command >> weight) || weight == 0) {
+                std::cout << "Invalid weight" << std::endl;
+                continue;
+            }
+            timeTabler->setGroupWeight(index, weight);
+        } else if (name == "add") {
+            std::string constraint;
+            std::getline(command, constraint);
+            if (!parseCustomConstraintString(constraint, encoder,
+                                             timeTabler)) {
+                std::cout << "Invalid constraint" << std::endl;
+                continue;
+            }
+            std::cout << "Added as group " << timeTabler->getGroupCount() - 1
+                      << std::endl;
+        } else if (name == "solve") {
+            solve();
+        } else if (name == "write") {
+            std::string fileName;
+            if (command >> fileName) {
+                timeTabler->writeOutput(fileName);
+            }
+        } else {
+            std::cout << "Unknown command " << name << std::endl;
+        }
+    }
+}
@@ -0,0 +1,399 @@
+#include "local_search.h"
+
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace NSPACE;
+using namespace openwbo;
+
+/**
+ * The weight added to a falsified hard clause when the search is stuck
+ */
+static const int64_t hardWeightIncrement = 3;
+
+/**
+ * The number of good variables sampled when picking the variable to flip
+ */
+static const int sampleSize = 15;
+
+/**
+ * @brief      Constructs the LocalSearch object.
+ *
+ * This flattens the hard and soft clauses of the formula and builds the
+ * occurrence lists. The formula is not modified.
+ *
+ * @param      formula  The formula
+ * @param[in]  seed     The seed for the random number generator
+ */
+LocalSearch::LocalSearch(MaxSATFormula *formula, unsigned seed)
+    : generator(seed) {
+    nbVars = formula->nVars();
+    clauseStart.push_back(0);
+    for (int i = 0; i < formula->nHard(); i++) {
+        addClause(formula->getHardClause(i).clause, 0);
+    }
+    nbHard = softWeight.size();
+    for (int i = 0; i < formula->nSoft(); i++) {
+        addClause(formula->getSoftClause(i).clause,
+                  formula->getSoftClause(i).weight);
+    }
+
+    occurStart.assign(2 * nbVars + 1, 0);
+    for (int i = 0; i < clauseLits.size(); i++) {
+        occurStart[toInt(clauseLits[i]) + 1]++;
+    }
+    for (int i = 1; i < occurStart.size(); i++) {
+        occurStart[i] += occurStart[i - 1];
+    }
+    occurClauses.resize(clauseLits.size());
+    std::vector<int> next(occurStart.begin(), occurStart.end() - 1);
+    for (int c = 0; c + 1 < clauseStart.size(); c++) {
+        for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            occurClauses[next[toInt(clauseLits[i])]++] = c;
+        }
+    }
+
+    std::uniform_int_distribution<int> coin(0, 1);
+    initialValue.resize(nbVars);
+    for (int v = 0; v < nbVars; v++) {
+        initialValue[v] = coin(generator) == 1;
+    }
+    bestCost = UINT64_MAX;
+    flips = 0;
+}
+
+/**
+ * @brief      Adds a clause to the flat clause array.
+ *
+ * Repeated literals are removed, and tautologies are dropped as they can
+ * never be falsified.
+ *
+ * @param[in]  clause  The clause
+ * @param[in]  weight  The weight of the clause, zero if it is hard
+ */
+void LocalSearch::addClause(const vec<Lit> &clause, uint64_t weight) {
+    std::vector<Lit> lits;
+    for (int i = 0; i < clause.size(); i++) {
+        lits.push_back(clause[i]);
+    }
+    std::sort(lits.begin(), lits.end());
+    lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+    for (int i = 0; i + 1 < lits.size(); i++) {
+        if (var(lits[i]) == var(lits[i + 1])) {
+            return;
+        }
+    }
+    clauseLits.insert(clauseLits.end(), lits.begin(), lits.end());
+    clauseStart.push_back(clauseLits.size());
+    softWeight.push_back(weight);
+}
+
+/**
+ * @brief      Sets the initial assignment of the search.
+ *
+ * Variables without a given literal keep their random initial value.
+ *
+ * @param[in]  lits  The literals that are initially True
+ */
+void LocalSearch::setInitialAssignment(const std::vector<Lit> &lits) {
+    for (int i = 0; i < lits.size(); i++) {
+        if (var(lits[i]) < nbVars) {
+            initialValue[var(lits[i])] = !sign(lits[i]);
+        }
+    }
+}
+
+/**
+ * @brief      Checks if a literal is True in the current assignment.
+ *
+ * @param[in]  lit   The literal
+ *
+ * @return     True if the literal is True, False otherwise
+ */
+bool LocalSearch::isTrue(Lit lit) { return value[var(lit)] != sign(lit); }
+
+/**
+ * @brief      Adds or removes a clause from the falsified clauses.
+ *
+ * @param[in]  clause     The clause
+ * @param[in]  isFalsified  Whether the clause is now falsified
+ */
+void LocalSearch::setFalsified(int clause, bool isFalsified) {
+    bool hard = clause < nbHard;
+    if (isFalsified) {
+        falsifiedIndex[clause] = falsified.size();
+        falsified.push_back(clause);
+        if (hard) {
+            nbFalsifiedHard++;
+        } else {
+            softCost += softWeight[clause];
+        }
+    } else {
+        int index = falsifiedIndex[clause];
+        falsified[index] = falsified.back();
+        falsifiedIndex[falsified[index]] = index;
+        falsified.pop_back();
+        falsifiedIndex[clause] = -1;
+        if (hard) {
+            nbFalsifiedHard--;
+        } else {
+            softCost -= softWeight[clause];
+        }
+    }
+}
+
+/**
+ * @brief      Updates whether a variable is in the list of good variables,
+ * which are those with a positive score.
+ *
+ * @param[in]  v     The variable
+ */
+void LocalSearch::updateGoodVar(int v) {
+    if (score[v] > 0 && goodIndex[v] == -1) {
+        goodIndex[v] = goodVars.size();
+        goodVars.push_back(v);
+    } else if (score[v] <= 0 && goodIndex[v] != -1) {
+        int index = goodIndex[v];
+        goodVars[index] = goodVars.back();
+        goodIndex[goodVars[index]] = index;
+        goodVars.pop_back();
+        goodIndex[v] = -1;
+    }
+}
+
+/**
+ * @brief      Sets up the assignment, clause weights and scores before the
+ * search starts.
+ */
+void LocalSearch::initialize() {
+    int nbClauses = softWeight.size();
+    value = initialValue;
+    clauseWeight.assign(nbClauses, 1);
+    trueCount.assign(nbClauses, 0);
+    trueVar.assign(nbClauses, -1);
+    score.assign(nbVars, 0);
+    lastFlip.assign(nbVars, 0);
+    falsified.clear();
+    falsifiedIndex.assign(nbClauses, -1);
+    goodVars.clear();
+    goodIndex.assign(nbVars, -1);
+    nbFalsifiedHard = 0;
+    softCost = 0;
+    for (int c = 0; c < nbClauses; c++) {
+        for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            if (isTrue(clauseLits[i])) {
+                trueCount[c]++;
+                trueVar[c] = var(clauseLits[i]);
+            }
+        }
+        if (trueCount[c] == 0) {
+            setFalsified(c, true);
+            for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+                score[var(clauseLits[i])] += clauseWeight[c];
+            }
+        } else if (trueCount[c] == 1) {
+            score[trueVar[c]] -= clauseWeight[c];
+        }
+    }
+    for (int v = 0; v < nbVars; v++) {
+        updateGoodVar(v);
+    }
+}
+
+/**
+ * @brief      Flips a variable, updating the clause counts and the scores of
+ * the variables sharing a clause with it.
+ *
+ * @param[in]  v     The variable
+ */
+void LocalSearch::flip(int v) {
+    value[v] = !value[v];
+    Lit madeTrue = mkLit(v, !value[v]);
+    Lit madeFalse = ~madeTrue;
+
+    for (int o = occurStart[toInt(madeTrue)];
+         o < occurStart[toInt(madeTrue) + 1]; o++) {
+        int c = occurClauses[o];
+        int64_t weight = clauseWeight[c];
+        if (trueCount[c] == 0) {
+            // the clause is now satisfied, only by v
+            setFalsified(c, false);
+            for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+                int u = var(clauseLits[i]);
+                score[u] -= weight;
+                updateGoodVar(u);
+            }
+            trueVar[c] = v;
+            score[v] -= weight;
+            updateGoodVar(v);
+        } else if (trueCount[c] == 1) {
+            // the only true variable no longer breaks the clause
+            score[trueVar[c]] += weight;
+            updateGoodVar(trueVar[c]);
+        }
+        trueCount[c]++;
+    }
+
+    for (int o = occurStart[toInt(madeFalse)];
+         o < occurStart[toInt(madeFalse) + 1]; o++) {
+        int c = occurClauses[o];
+        int64_t weight = clauseWeight[c];
+        trueCount[c]--;
+        if (trueCount[c] == 0) {
+            // the clause is now falsified
+            setFalsified(c, true);
+            for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+                int u = var(clauseLits[i]);
+                score[u] += weight;
+                updateGoodVar(u);
+            }
+            score[v] += weight;
+            updateGoodVar(v);
+        } else if (trueCount[c] == 1) {
+            // the remaining true variable now breaks the clause
+            for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+                if (isTrue(clauseLits[i])) {
+                    trueVar[c] = var(clauseLits[i]);
+                    break;
+                }
+            }
+            score[trueVar[c]] -= weight;
+            updateGoodVar(trueVar[c]);
+        }
+    }
+}
+
+/**
+ * @brief      Increases the weights of the falsified clauses.
+ *
+ * Hard clauses are increased by a fixed step, and soft clauses by one as long
+ * as their weight stays below their weight in the formula, so that the hard
+ * clauses are pushed to be satisfied first while the soft clauses keep their
+ * relative importance.
+ */
+void LocalSearch::updateWeights() {
+    for (int f = 0; f < falsified.size(); f++) {
+        int c = falsified[f];
+        int64_t increment = 0;
+        if (c < nbHard) {
+            increment = hardWeightIncrement;
+        } else if (uint64_t(clauseWeight[c]) < softWeight[c]) {
+            increment = 1;
+        }
+        if (increment == 0) {
+            continue;
+        }
+        clauseWeight[c] += increment;
+        for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            int u = var(clauseLits[i]);
+            score[u] += increment;
+            updateGoodVar(u);
+        }
+    }
+}
+
+/**
+ * @brief      Picks the next variable to flip.
+ *
+ * If there are good variables, the best of a random sample of them is
+ * picked. Otherwise, the clause weights are updated, and the best variable of
+ * a random falsified clause, preferring hard clauses, is picked. Ties are
+ * broken in favour of the variable flipped least recently.
+ *
+ * @return     The variable
+ */
+int LocalSearch::pickVar() {
+    int best = -1;
+    if (goodVars.size() > 0) {
+        std::uniform_int_distribution<int> pick(0, goodVars.size() - 1);
+        int samples = std::min<int>(sampleSize, goodVars.size());
+        for (int i = 0; i < samples; i++) {
+            int v = goodVars[goodVars.size() <= sampleSize ? i
+                                                           : pick(generator)];
+            if (best == -1 || score[v] > score[best] ||
+                (score[v] == score[best] && lastFlip[v] < lastFlip[best])) {
+                best = v;
+            }
+        }
+        return best;
+    }
+
+    updateWeights();
+    std::uniform_int_distribution<int> pick(0, falsified.size() - 1);
+    int c = falsified[pick(generator)];
+    for (int i = 0; i < sampleSize && nbFalsifiedHard > 0 && c >= nbHard;
+         i++) {
+        c = falsified[pick(generator)];
+    }
+    for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+        int v = var(clauseLits[i]);
+        if (best == -1 || score[v] > score[best] ||
+            (score[v] == score[best] && lastFlip[v] < lastFlip[best])) {
+            best = v;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief      Runs the search.
+ *
+ * @param[in]  maxFlips  The maximum number of flips
+ *
+ * @return     True if an assignment satisfying all hard clauses was found,
+ * False otherwise
+ */
+bool LocalSearch::search(uint64_t maxFlips) {
+    initialize();
+    flips = 0;
+    while (true) {
+        if (nbFalsifiedHard == 0 && softCost < bestCost) {
+            bestCost = softCost;
+            bestValue = value;
+        }
+        if (falsified.size() == 0 || flips >= maxFlips) {
+            break;
+        }
+        int v = pickVar();
+        if (v == -1) {
+            // only empty clauses are falsified
+            break;
+        }
+        flip(v);
+        flips++;
+        lastFlip[v] = flips;
+    }
+    return bestCost != UINT64_MAX;
+}
+
+/**
+ * @brief      Gets the best assignment found that satisfies all hard clauses.
+ *
+ * @return     The model, which is empty if no such assignment was found
+ */
+std::vector<lbool> LocalSearch::getBestModel() {
+    std::vector<lbool> result;
+    for (int v = 0; v < bestValue.size(); v++) {
+        result.push_back(bestValue[v] ? l_True : l_False);
+    }
+    return result;
+}
+
+/**
+ * @brief      Gets the cost of the best assignment.
+ *
+ * @return     The cost, UINT64_MAX if no assignment satisfying all hard
+ * clauses was found
+ */
+uint64_t LocalSearch::getBestCost() { return bestCost; }
+
+/**
+ * @brief      Gets the number of flips made by the last search.
+ *
+ * @return     The number of flips
+ */
+uint64_t LocalSearch::getFlips() { return flips; }
@@ -3,31 +3,103 @@
 #include "core/Solver.h"
 #include "custom_parser.h"
 #include "global.h"
+#include "greedy_scheduler.h"
+#include "interactive.h"
 #include "mtl/Vec.h"
+#include "options.h"
 #include "parser.h"
 #include <iostream>
 
 int main(int argc, char const *argv[]) {
-    if (argc != 5) {
-        std::cout << "Run as " << argv[0]
-                  << " fields.yml input.csv custom.txt output.csv" << std::endl;
+    Options options;
+    if (!options.parse(argc, argv)) {
+        options.printUsage(argv[0]);
         return 0;
     }
     TimeTabler *timeTabler = new TimeTabler();
-    Parser parser(timeTabler);
-    parser.parseFields(std::string(argv[1]));
-    parser.parseInput(std::string(argv[2]));
-    parser.addVars();
+    if (!timeTabler->configure(options)) {
+        delete timeTabler;
+        return 0;
+    }
+    bool compiled = !options.compiledFile.empty();
+    if (compiled) {
+        if (!timeTabler->loadCompiled(options.compiledFile)) {
+            delete timeTabler;
+            return 1;
+        }
+    } else {
+        Parser parser(timeTabler);
+        if (options.fieldsBenchmark) {
+            parser.benchmarkFields(options.fieldsFile);
+            delete timeTabler;
+            return 0;
+        }
+        if (!parser.parseFields(options.fieldsFile)) {
+            delete timeTabler;
+            return 1;
+        }
+        if (!parser.parseInput(options.inputFile)) {
+            delete timeTabler;
+            return 1;
+        }
+        parser.addVars();
+    }
     ConstraintEncoder encoder(timeTabler);
-    ConstraintAdder constraintAdder(&encoder, timeTabler);
-    constraintAdder.addConstraints();
-    parseCustomConstraints(std::string(argv[3]), &encoder, timeTabler);
-    timeTabler->addHighLevelClauses();
-    timeTabler->addExistingAssignments();
+    if (!compiled) {
+        ConstraintAdder constraintAdder(&encoder, timeTabler);
+        constraintAdder.addConstraints();
+        parseCustomConstraints(options.customFile, &encoder, timeTabler);
+        timeTabler->addHighLevelClauses();
+        timeTabler->addExistingAssignments();
+        if (options.greedy && options.annealTimeLimit == 0) {
+            GreedyScheduler scheduler(timeTabler->data);
+            if (scheduler.schedule()) {
+                timeTabler->addGreedyHints(scheduler.getPhaseHints());
+            } else {
+                std::cout << "The greedy schedule could not place every "
+                             "course, and is not used"
+                          << std::endl;
+            }
+        }
+    }
+    if (options.annealTimeLimit > 0) {
+        SolverStatus solverStatus = timeTabler->anneal(
+            options.annealTimeLimit, options.seed, options.threads);
+        timeTabler->printResult(solverStatus);
+        if (solverStatus == SolverStatus::Solved) {
+            timeTabler->writeOutput(options.outputFile);
+        }
+        delete timeTabler;
+        return 0;
+    }
+    if (options.compile) {
+        bool written = timeTabler->writeCompiled(options.outputFile);
+        delete timeTabler;
+        return written ? 0 : 1;
+    }
+    if (options.satBenchmark) {
+        timeTabler->benchmarkSATSolver();
+        delete timeTabler;
+        return 0;
+    }
     SolverStatus solverStatus = timeTabler->solve();
+    if (options.lnsTimeLimit > 0) {
+        solverStatus =
+            timeTabler->improve(options.lnsTimeLimit, options.seed);
+    }
+    timeTabler->saveState();
     timeTabler->printResult(solverStatus);
     if (solverStatus == SolverStatus::Solved) {
-        timeTabler->writeOutput(std::string(argv[4]));
+        timeTabler->writeOutput(options.outputFile);
+        if (options.enumerateCount > 1) {
+            timeTabler->enumerate(options.enumerateCount,
+                                  options.enumerateDistance,
+                                  options.outputFile);
+        }
+    }
+    if (options.interactive && solverStatus != SolverStatus::Unsolved) {
+        Interactive interactive(timeTabler, &encoder, options.outputFile);
+        interactive.run(std::cin);
     }
     delete timeTabler;
     return 0;
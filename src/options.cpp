@@ -0,0 +1,302 @@
+#include "options.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief      Constructs the Options object with the default values.
+ */
+Options::Options() {
+    lnsTimeLimit = 0;
+    lnsBudget = 1000;
+    localSearchFlips = 0;
+    annealTimeLimit = 0;
+    threads = 1;
+    coreTrimming = false;
+    coreMinimization = false;
+    coreExhaustion = false;
+    coreBudget = 1000;
+    satBudget = 0;
+    satBudgetGrowth = 2;
+    satBudgetRetries = 3;
+    seedBudget = 10000;
+    algorithm = "auto";
+    coreBoostCores = 0;
+    coreBoostTime = 10;
+    lexicographic = false;
+    enumerateCount = 1;
+    enumerateDistance = 1;
+    satBenchmark = false;
+    fieldsBenchmark = false;
+    interactive = false;
+    decompose = false;
+    hierarchical = false;
+    roomMatching = false;
+    branching = false;
+    greedy = true;
+    seed = 0;
+    compile = false;
+}
+
+/**
+ * @brief      Parses the value of an option that is either on or off.
+ *
+ * @param[in]  value  The value, 1 for on and 0 for off
+ *
+ * @return     True if on, False if off
+ */
+bool Options::parseSwitch(std::string value) {
+    if (value != "0" && value != "1") {
+        throw std::invalid_argument(value);
+    }
+    return value == "1";
+}
+
+/**
+ * @brief      Parses the command line arguments.
+ *
+ * @param[in]  argc  The number of arguments
+ * @param      argv  The arguments
+ *
+ * @return     True if the arguments are valid, False otherwise
+ */
+bool Options::parse(int argc, char const *argv[]) {
+    int first;
+    if (argc >= 4 && std::string(argv[1]) == "--load-compiled") {
+        compiledFile = argv[2];
+        outputFile = argv[3];
+        first = 4;
+    } else {
+        compile = argc >= 2 && std::string(argv[1]) == "compile";
+        int paths = compile ? 2 : 1;
+        if (argc < paths + 4) {
+            return false;
+        }
+        fieldsFile = argv[paths];
+        inputFile = argv[paths + 1];
+        customFile = argv[paths + 2];
+        outputFile = argv[paths + 3];
+        first = paths + 4;
+    }
+    for (int i = first; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << flag << std::endl;
+            return false;
+        }
+        std::string value = argv[i + 1];
+        try {
+            if (flag == "--lns") {
+                lnsTimeLimit = std::stod(value);
+            } else if (flag == "--lns-budget") {
+                lnsBudget = std::stoll(value);
+                if (lnsBudget < 1) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--sls") {
+                localSearchFlips = std::stoull(value);
+            } else if (flag == "--anneal") {
+                annealTimeLimit = std::stod(value);
+            } else if (flag == "--threads") {
+                threads = std::stoi(value);
+                if (threads < 1) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--core-trim") {
+                coreTrimming = parseSwitch(value);
+            } else if (flag == "--core-minimize") {
+                coreMinimization = parseSwitch(value);
+            } else if (flag == "--core-exhaust") {
+                coreExhaustion = parseSwitch(value);
+            } else if (flag == "--core-budget") {
+                coreBudget = std::stoll(value);
+                if (coreBudget < 1) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--sat-budget") {
+                satBudget = std::stoll(value);
+                if (satBudget < 0) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--sat-budget-growth") {
+                satBudgetGrowth = std::stod(value);
+                if (satBudgetGrowth < 1) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--sat-budget-retries") {
+                satBudgetRetries = std::stoi(value);
+                if (satBudgetRetries < 0) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--seed-budget") {
+                seedBudget = std::stoll(value);
+                if (seedBudget < 1) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--algorithm") {
+                algorithm = value;
+            } else if (flag == "--core-boost-cores") {
+                coreBoostCores = std::stoi(value);
+                if (coreBoostCores < 0) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--core-boost-time") {
+                coreBoostTime = std::stod(value);
+                if (coreBoostTime < 0) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--lexicographic") {
+                lexicographic = parseSwitch(value);
+            } else if (flag == "--enumerate") {
+                enumerateCount = std::stoi(value);
+                if (enumerateCount < 1) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--enumerate-distance") {
+                enumerateDistance = std::stoi(value);
+                if (enumerateDistance < 1) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (flag == "--sat-benchmark") {
+                satBenchmark = parseSwitch(value);
+            } else if (flag == "--fields-benchmark") {
+                fieldsBenchmark = parseSwitch(value);
+            } else if (flag == "--interactive") {
+                interactive = parseSwitch(value);
+            } else if (flag == "--decompose") {
+                decompose = parseSwitch(value);
+            } else if (flag == "--hierarchical") {
+                hierarchical = parseSwitch(value);
+            } else if (flag == "--room-matching") {
+                roomMatching = parseSwitch(value);
+            } else if (flag == "--branching") {
+                branching = parseSwitch(value);
+            } else if (flag == "--greedy") {
+                greedy = parseSwitch(value);
+            } else if (flag == "--state") {
+                stateFile = value;
+            } else if (flag == "--seed") {
+                seed = unsigned(std::stoul(value));
+            } else {
+                std::cout << "Unknown option " << flag << std::endl;
+                return false;
+            }
+        } catch (const std::logic_error &) {
+            std::cout << "Invalid value " << value << " for " << flag
+                      << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief      Prints how the program is to be run.
+ *
+ * @param[in]  program  The name with which the program was run
+ */
+void Options::printUsage(std::string program) {
+    std::cout << "Run as " << program
+              << " fields.yml input.csv custom.txt output.csv [options]"
+              << std::endl;
+    std::cout << "    or " << program
+              << " compile fields.yml input.csv custom.txt compiled.bin"
+              << std::endl;
+    std::cout << "    or " << program
+              << " --load-compiled compiled.bin output.csv [options]"
+              << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --lns <seconds>        Improve the solved timetable with "
+                 "large neighbourhood search"
+              << std::endl;
+    std::cout << "  --lns-budget <n>       Conflict budget of each SAT call of "
+                 "the large neighbourhood search"
+              << std::endl;
+    std::cout << "  --sls <flips>          Run a local search for an initial "
+                 "timetable before solving"
+              << std::endl;
+    std::cout << "  --anneal <seconds>     Make the timetable with simulated "
+                 "annealing instead of the MaxSAT solver"
+              << std::endl;
+    std::cout << "  --threads <n>          Number of annealing chains or "
+                 "components solved in parallel"
+              << std::endl;
+    std::cout << "  --core-trim <0|1>      Trim cores by solving them again"
+              << std::endl;
+    std::cout << "  --core-minimize <0|1>  Minimize cores by deleting literals"
+              << std::endl;
+    std::cout << "  --core-exhaust <0|1>   Raise core bounds while they are "
+                 "implied"
+              << std::endl;
+    std::cout << "  --core-budget <n>      Conflict budget of each core "
+                 "reduction call"
+              << std::endl;
+    std::cout << "  --sat-budget <n>       Conflict budget of each core "
+                 "guided SAT call, 0 for none"
+              << std::endl;
+    std::cout << "  --sat-budget-growth <factor>"
+              << std::endl
+              << "                         Growth of the budget each time it "
+                 "runs out"
+              << std::endl;
+    std::cout << "  --sat-budget-retries <n>"
+              << std::endl
+              << "                         Budgets run out in a row before "
+                 "the best timetable is kept"
+              << std::endl;
+    std::cout << "  --seed-budget <n>      Conflict budget of each call "
+                 "seeding the upper bound"
+              << std::endl;
+    std::cout << "  --algorithm <name>     MaxSAT algorithm: auto, oll, "
+                 "stratified, msu3, linear or core-boosted"
+              << std::endl;
+    std::cout << "  --core-boost-cores <n> Cores before core-boosted switches "
+                 "to linear search"
+              << std::endl;
+    std::cout << "  --core-boost-time <seconds>"
+              << std::endl
+              << "                         Time before core-boosted switches "
+                 "to linear search"
+              << std::endl;
+    std::cout << "  --lexicographic <0|1>  Optimize high level, assignment "
+                 "and constraint costs in turn"
+              << std::endl;
+    std::cout << "  --enumerate <k>        Write the k best timetables"
+              << std::endl;
+    std::cout << "  --enumerate-distance <n>"
+              << std::endl
+              << "                         Slot and classroom changes between "
+                 "enumerated timetables"
+              << std::endl;
+    std::cout << "  --sat-benchmark <0|1>  Time the SAT solver on the "
+                 "instance instead of solving it"
+              << std::endl;
+    std::cout << "  --fields-benchmark <0|1>" << std::endl
+              << "                         Time loading the fields file "
+                 "instead of solving"
+              << std::endl;
+    std::cout << "  --interactive <0|1>    Change the constraints and solve "
+                 "again from standard input"
+              << std::endl;
+    std::cout << "  --decompose <0|1>      Solve independent parts of the "
+                 "timetable separately"
+              << std::endl;
+    std::cout << "  --hierarchical <0|1>   Solve the times first and the "
+                 "classrooms second"
+              << std::endl;
+    std::cout << "  --room-matching <0|1>  Solve hierarchically and assign the "
+                 "classrooms by matching"
+              << std::endl;
+    std::cout << "  --branching <0|1>      Decide slots, segments and then "
+                 "classrooms first"
+              << std::endl;
+    std::cout << "  --greedy <0|1>         Start the search from a greedy "
+                 "schedule, on by default"
+              << std::endl;
+    std::cout << "  --state <file>         Reuse the solver state saved in "
+                 "the file, and save it after solving"
+              << std::endl;
+    std::cout << "  --seed <n>             Seed for randomized choices"
+              << std::endl;
+}
@@ -1,6 +1,10 @@
 #include "parser.h"
 
+#include "fields_loader.h"
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 
 /**
@@ -14,242 +18,233 @@ Parser::Parser(TimeTabler *timeTabler) { this->timeTabler = timeTabler; }
  * @brief      Parse the fields given in a file.
  *
  * @param[in]  file  The file containing the fields
+ *
+ * @return     True if the fields are valid, False otherwise, in which case the
+ * error is printed with the line and column it is at
  */
-void Parser::parseFields(std::string file) {
-    YAML::Node config = YAML::LoadFile(file);
-
-    YAML::Node instructorsConfig = config["instructors"];
-    for (YAML::Node instructorNode : instructorsConfig) {
-        Instructor instructor(instructorNode.as<std::string>());
-        timeTabler->data.instructors.push_back(instructor);
-    }
-
-    YAML::Node classroomsConfig = config["classrooms"];
-    for (YAML::Node classroomNode : classroomsConfig) {
-        Classroom classroom(classroomNode["number"].as<std::string>(),
-                            classroomNode["size"].as<unsigned>());
-        timeTabler->data.classrooms.push_back(classroom);
-    }
-
-    YAML::Node segmentsConfig = config["segments"];
-    unsigned segmentStart = segmentsConfig["start"].as<unsigned>();
-    unsigned segmentEnd = segmentsConfig["end"].as<unsigned>();
-    for (unsigned i = segmentStart; i <= segmentEnd; ++i) {
-        for (unsigned j = i; j <= segmentEnd; ++j) {
-            timeTabler->data.segments.push_back(Segment(i, j));
-        }
-    }
-
-    YAML::Node slotsConfig = config["slots"];
-    for (YAML::Node slotNode : slotsConfig) {
-        std::vector<SlotElement> slotElements;
-        IsMinor isMinor = (slotNode["is_minor"].as<bool>())
-                              ? MinorType::isMinorCourse
-                              : MinorType::isNotMinorCourse;
-        for (YAML::Node periodNode : slotNode["time_periods"]) {
-            Time start(periodNode["start"].as<std::string>());
-            Time end(periodNode["end"].as<std::string>());
-            Day day = getDayFromString(periodNode["day"].as<std::string>());
-            slotElements.push_back(SlotElement(start, end, day));
-        }
-        timeTabler->data.slots.push_back(
-            Slot(slotNode["name"].as<std::string>(), isMinor, slotElements));
+bool Parser::parseFields(std::string file) {
+    std::ifstream in(file);
+    if (!in) {
+        std::cout << file << ": cannot open the file" << std::endl;
+        return false;
     }
-
-    timeTabler->data.isMinors.push_back(IsMinor(MinorType::isMinorCourse));
-    timeTabler->data.isMinors.push_back(IsMinor(MinorType::isNotMinorCourse));
-
-    YAML::Node programsConfig = config["programs"];
-    for (YAML::Node programNode : programsConfig) {
-        std::string name = programNode.as<std::string>();
-        timeTabler->data.programs.push_back(Program(name, CourseType::core));
-        timeTabler->data.programs.push_back(
-            Program(name, CourseType::elective));
+    FieldsLoader loader(timeTabler->data);
+    if (!loader.load(in)) {
+        std::cout << file << ":" << loader.getErrorLine() << ":"
+                  << loader.getErrorColumn() << ": " << loader.getError()
+                  << std::endl;
+        return false;
     }
+    timeTabler->data.buildIndices();
+    return true;
+}
 
-    YAML::Node weightsConfig = config["weights"];
-    timeTabler->data.existingAssignmentWeights[FieldType::instructor] =
-        weightsConfig["instructor"][0].as<int>();
-    timeTabler->data.highLevelVarWeights[FieldType::instructor] =
-        2 * weightsConfig["instructor"][1].as<int>();
-    timeTabler->data.existingAssignmentWeights[FieldType::segment] =
-        weightsConfig["segment"][0].as<int>();
-    timeTabler->data.highLevelVarWeights[FieldType::segment] =
-        2 * weightsConfig["segment"][1].as<int>();
-    timeTabler->data.existingAssignmentWeights[FieldType::isMinor] =
-        weightsConfig["is_minor"][0].as<int>();
-    timeTabler->data.highLevelVarWeights[FieldType::isMinor] =
-        2 * weightsConfig["is_minor"][1].as<int>();
-    timeTabler->data.existingAssignmentWeights[FieldType::program] =
-        weightsConfig["program"].as<int>();
-    timeTabler->data.existingAssignmentWeights[FieldType::classroom] =
-        weightsConfig["classroom"][0].as<int>();
-    timeTabler->data.highLevelVarWeights[FieldType::classroom] =
-        2 * weightsConfig["classroom"][1].as<int>();
-    timeTabler->data.existingAssignmentWeights[FieldType::slot] =
-        weightsConfig["slot"][0].as<int>();
-    timeTabler->data.highLevelVarWeights[FieldType::slot] =
-        2 * weightsConfig["slot"][1].as<int>();
-
-    YAML::Node predefinedWeightsConfig = config["predefined_weights"];
-    for (YAML::Node predefinedWeightNode : predefinedWeightsConfig) {
-        unsigned clauseNo = predefinedWeightNode["clause"].as<int>();
-        int weight = predefinedWeightNode["weight"].as<int>();
-        timeTabler->data.predefinedClausesWeights[clauseNo] = weight;
+/**
+ * @brief      Times loading the fields with the FieldsLoader against building
+ * the whole YAML document of the fields, which is what loading them took
+ * before the document was walked.
+ *
+ * @param[in]  file  The file containing the fields
+ */
+void Parser::benchmarkFields(std::string file) {
+    const int runs = 20;
+    double streamSeconds = 0, documentSeconds = 0;
+    for (int i = 0; i < runs; i++) {
+        auto start = std::chrono::steady_clock::now();
+        std::ifstream in(file);
+        Data data;
+        FieldsLoader loader(data);
+        loader.load(in);
+        streamSeconds += std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        start = std::chrono::steady_clock::now();
+        YAML::Node config = YAML::LoadFile(file);
+        documentSeconds += std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
     }
+    std::cout << "fields stream: " << streamSeconds / runs << " s"
+              << std::endl;
+    std::cout << "fields document (without walking it): "
+              << documentSeconds / runs << " s" << std::endl;
 }
 
 /**
- * @brief      Gets the day from the string as a member of the Day enum.
+ * @brief      Prints an error in the input, with the line it is on.
  *
- * For example, the input "Monday" returns Day::Monday.
+ * @param[in]  file     The file containing the input
+ * @param[in]  line     The line
+ * @param[in]  message  The error
  *
- * @param[in]  day   The day as a string
- *
- * @return     A member of the Day enum, corresponding the the day the string
- * represented
+ * @return     False, to be returned by the caller
  */
-Day Parser::getDayFromString(std::string day) {
-    if (day == "Monday")
-        return Day::Monday;
-    if (day == "Tuesday")
-        return Day::Tuesday;
-    if (day == "Wednesday")
-        return Day::Wednesday;
-    if (day == "Thursday")
-        return Day::Thursday;
-    if (day == "Friday")
-        return Day::Friday;
-    if (day == "Saturday")
-        return Day::Saturday;
-    if (day == "Sunday")
-        return Day::Sunday;
-    assert(false && "Incorrect day");
-    return Day::Monday;
+static bool inputError(const std::string &file, int line,
+                       const std::string &message) {
+    std::cout << file << ":" << line << ": " << message << std::endl;
+    return false;
 }
 
 /**
  * @brief      Parses the input given in a file.
  *
+ * The file is read in a single pass, with the column of each header looked up
+ * once. The courses are added to the Data as their rows are read.
+ *
  * @param[in]  file  The file containig the input
+ *
+ * @return     True if the input is valid, False otherwise, in which case the
+ * error is printed with the line it is on
  */
-void Parser::parseInput(std::string file) {
-    csv::Parser parser(file);
-    timeTabler->data.existingAssignmentVars.clear();
-    for (unsigned i = 0; i < parser.rowCount(); ++i) {
+bool Parser::parseInput(std::string file) {
+    Data &data = timeTabler->data;
+    CSVReader reader;
+    if (!reader.open(file)) {
+        return inputError(file, reader.getLine(), reader.getError());
+    }
+    const char *columnNames[] = {"name",    "class_size", "instructor",
+                                 "segment", "is_minor",   "classroom",
+                                 "slot"};
+    int columns[7];
+    for (int i = 0; i < 7; i++) {
+        columns[i] = reader.findColumn(columnNames[i]);
+        if (columns[i] == -1) {
+            return inputError(file, 1,
+                              "Input has no column " +
+                                  std::string(columnNames[i]));
+        }
+    }
+    int nameColumn = columns[0], classSizeColumn = columns[1],
+        instructorColumn = columns[2], segmentColumn = columns[3],
+        isMinorColumn = columns[4], classroomColumn = columns[5],
+        slotColumn = columns[6];
+    std::vector<int> programColumns;
+    for (unsigned j = 0; j < data.programs.size(); j += 2) {
+        programColumns.push_back(reader.findColumn(data.programs[j].getName()));
+        if (programColumns.back() == -1) {
+            return inputError(file, 1,
+                              "Input has no column for Program " +
+                                  data.programs[j].getName());
+        }
+    }
+    data.existingAssignmentVars.clear();
+    // reused for every cell that is looked up, to not allocate for each
+    std::string value;
+    while (reader.next()) {
+        int line = reader.getLine();
         std::vector<std::vector<lbool>> assignmentsThisCourse(
             Global::FIELD_COUNT);
 
-        std::string name = parser[i]["name"];
-        std::string classSizeStr = parser[i]["class_size"];
-        unsigned classSize = unsigned(std::stoi(classSizeStr));
-
-        std::string instructorStr = parser[i]["instructor"];
-        int instructor = -1;
-        for (unsigned j = 0; j < timeTabler->data.instructors.size(); j++) {
-            if (timeTabler->data.instructors[j].getName() == instructorStr) {
-                instructor = j;
-                assignmentsThisCourse[FieldType::instructor].push_back(l_True);
-                continue;
-            }
-            assignmentsThisCourse[FieldType::instructor].push_back(l_False);
+        const CSVCell &classSizeCell = reader.getCell(classSizeColumn);
+        bool validClassSize =
+            !classSizeCell.empty() && classSizeCell.length < 10;
+        unsigned classSize = 0;
+        for (size_t j = 0; j < classSizeCell.length && validClassSize; j++) {
+            char digit = classSizeCell.data[j];
+            validClassSize = digit >= '0' && digit <= '9';
+            classSize = 10 * classSize + (digit - '0');
         }
-        if (instructor == -1) {
-            std::cout << "Input contains invalid Instructor name" << std::endl;
-            exit(1);
+        if (!validClassSize) {
+            return inputError(file, line, "Input contains invalid class size");
         }
-        std::string segmentStr = parser[i]["segment"];
-        int segment = -1;
-        for (unsigned j = 0; j < timeTabler->data.segments.size(); j++) {
-            if (timeTabler->data.segments[j].getName() == segmentStr) {
-                segment = j;
-                assignmentsThisCourse[FieldType::segment].push_back(l_True);
-                continue;
-            }
-            assignmentsThisCourse[FieldType::segment].push_back(l_False);
+
+        const CSVCell &instructorCell = reader.getCell(instructorColumn);
+        value.assign(instructorCell.data, instructorCell.length);
+        int instructor = data.findFieldValue(FieldType::instructor, value);
+        if (instructor == -1) {
+            return inputError(file, line,
+                              "Input contains invalid Instructor name " +
+                                  value);
         }
+        assignmentsThisCourse[FieldType::instructor].resize(
+            data.instructors.size(), l_False);
+        assignmentsThisCourse[FieldType::instructor][instructor] = l_True;
+        const CSVCell &segmentCell = reader.getCell(segmentColumn);
+        value.assign(segmentCell.data, segmentCell.length);
+        int segment = data.findFieldValue(FieldType::segment, value);
         if (segment == -1) {
-            std::cout << "Input contains invalid Segment name" << std::endl;
-            exit(1);
+            return inputError(file, line,
+                              "Input contains invalid Segment name " + value);
         }
-        std::string isMinorStr = parser[i]["is_minor"];
+        assignmentsThisCourse[FieldType::segment].resize(data.segments.size(),
+                                                         l_False);
+        assignmentsThisCourse[FieldType::segment][segment] = l_True;
+        const CSVCell &isMinorCell = reader.getCell(isMinorColumn);
         int isMinor;
-        if (isMinorStr == "Yes") {
+        if (isMinorCell == "Yes") {
             isMinor = 0;
             assignmentsThisCourse[FieldType::isMinor].push_back(l_True);
-        } else if (isMinorStr == "No") {
+        } else if (isMinorCell == "No") {
             isMinor = 1;
             assignmentsThisCourse[FieldType::isMinor].push_back(l_False);
         } else {
-            std::cout << "Input contains invalid IsMinor value (should be "
-                         "'Yes' or 'No')"
-                      << std::endl;
-            exit(1);
+            return inputError(file, line,
+                              "Input contains invalid IsMinor value (should "
+                              "be 'Yes' or 'No')");
         }
-        Course course(name, classSize, instructor, segment, isMinor);
+        const CSVCell &nameCell = reader.getCell(nameColumn);
+        value.assign(nameCell.data, nameCell.length);
+        Course course(value, classSize, instructor, segment, isMinor,
+                      data.symbols);
 
-        for (unsigned j = 0; j < timeTabler->data.programs.size(); j += 2) {
-            std::string s = timeTabler->data.programs[j].getName();
-            if (parser[i][s] == "Core") {
-                course.addProgram(j);
+        for (unsigned j = 0; j < programColumns.size(); j++) {
+            const CSVCell &programCell = reader.getCell(programColumns[j]);
+            if (programCell == "Core") {
+                course.addProgram(2 * j);
                 assignmentsThisCourse[FieldType::program].push_back(l_True);
                 assignmentsThisCourse[FieldType::program].push_back(l_False);
-            } else if (parser[i][s] == "Elective") {
-                course.addProgram(j + 1);
+            } else if (programCell == "Elective") {
+                course.addProgram(2 * j + 1);
                 assignmentsThisCourse[FieldType::program].push_back(l_False);
                 assignmentsThisCourse[FieldType::program].push_back(l_True);
-            } else if (parser[i][s] == "No") {
+            } else if (programCell == "No") {
                 assignmentsThisCourse[FieldType::program].push_back(l_False);
                 assignmentsThisCourse[FieldType::program].push_back(l_False);
             } else {
-                std::cout << "Input contains invalid Program type (should be "
-                             "'Core', 'Elective', or 'No')"
-                          << std::endl;
-                exit(1);
+                return inputError(file, line,
+                                  "Input contains invalid Program type "
+                                  "(should be 'Core', 'Elective', or 'No')");
             }
         }
 
-        std::string classroomStr = parser[i]["classroom"];
-        std::string slotStr = parser[i]["slot"];
-        bool foundClassroom = false;
-        bool foundSlot = false;
+        const CSVCell &classroomCell = reader.getCell(classroomColumn);
+        const CSVCell &slotCell = reader.getCell(slotColumn);
         assignmentsThisCourse[FieldType::classroom].resize(
-            timeTabler->data.classrooms.size(), l_Undef);
-        assignmentsThisCourse[FieldType::slot].resize(
-            timeTabler->data.slots.size(), l_Undef);
-        if (classroomStr != "") {
-            for (unsigned j = 0; j < timeTabler->data.classrooms.size(); j++) {
-                if (timeTabler->data.classrooms[j].getName() == classroomStr) {
-                    assignmentsThisCourse[FieldType::classroom][j] = l_True;
-                    foundClassroom = true;
-                    continue;
-                }
-                assignmentsThisCourse[FieldType::classroom][j] = l_False;
-            }
-            if (!foundClassroom) {
-                std::cout << "Input contains invalid Classroom name"
-                          << std::endl;
-                exit(1);
+            data.classrooms.size(), l_Undef);
+        assignmentsThisCourse[FieldType::slot].resize(data.slots.size(),
+                                                      l_Undef);
+        if (!classroomCell.empty()) {
+            value.assign(classroomCell.data, classroomCell.length);
+            int classroom = data.findFieldValue(FieldType::classroom, value);
+            if (classroom == -1) {
+                return inputError(file, line,
+                                  "Input contains invalid Classroom name " +
+                                      value);
             }
+            std::fill(assignmentsThisCourse[FieldType::classroom].begin(),
+                      assignmentsThisCourse[FieldType::classroom].end(),
+                      l_False);
+            assignmentsThisCourse[FieldType::classroom][classroom] = l_True;
         }
-        if (slotStr != "") {
-            for (unsigned j = 0; j < timeTabler->data.slots.size(); j++) {
-                if (timeTabler->data.slots[j].getName() == slotStr) {
-                    assignmentsThisCourse[FieldType::slot][j] = l_True;
-                    foundSlot = true;
-                    continue;
-                }
-                assignmentsThisCourse[FieldType::slot][j] = l_False;
-            }
-            if (!foundSlot) {
-                std::cout << "Input contains invalid Slot name" << std::endl;
-                exit(1);
+        if (!slotCell.empty()) {
+            value.assign(slotCell.data, slotCell.length);
+            int slot = data.findFieldValue(FieldType::slot, value);
+            if (slot == -1) {
+                return inputError(file, line,
+                                  "Input contains invalid Slot name " + value);
             }
+            std::fill(assignmentsThisCourse[FieldType::slot].begin(),
+                      assignmentsThisCourse[FieldType::slot].end(), l_False);
+            assignmentsThisCourse[FieldType::slot][slot] = l_True;
         }
-        timeTabler->data.courses.push_back(course);
-        timeTabler->data.existingAssignmentVars.push_back(
-            assignmentsThisCourse);
+        data.courses.push_back(course);
+        data.existingAssignmentVars.push_back(assignmentsThisCourse);
+    }
+    if (reader.hasError()) {
+        return inputError(file, reader.getLine(), reader.getError());
     }
+    data.buildIndices();
+    return true;
 }
 
 /**
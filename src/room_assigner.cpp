@@ -0,0 +1,290 @@
+#include "room_assigner.h"
+
+#include "core/SolverTypes.h"
+#include "data.h"
+#include "global.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * @brief      Constructs the RoomAssigner object, finding the cost of each
+ * Classroom for each Course.
+ *
+ * A Classroom cannot be given to a Course if it is too small, or if it breaks
+ * a hard existing assignment.
+ *
+ * @param      data  The data
+ */
+RoomAssigner::RoomAssigner(Data &data) : data(data) {
+    int weight = data.existingAssignmentWeights[FieldType::classroom];
+    roomCost.assign(data.courses.size(),
+                    std::vector<long long>(data.classrooms.size(), 0));
+    for (int i = 0; i < data.courses.size(); i++) {
+        std::vector<lbool> &existing =
+            data.existingAssignmentVars[i][FieldType::classroom];
+        for (int r = 0; r < data.classrooms.size(); r++) {
+            if (data.classrooms[r].getSize() < data.courses[i].getClassSize()) {
+                roomCost[i][r] = -1;
+                continue;
+            }
+            // the existing assignments broken by giving Classroom r
+            int broken = 0;
+            for (int q = 0; q < existing.size(); q++) {
+                if ((q == r && existing[q] == l_False) ||
+                    (q != r && existing[q] == l_True)) {
+                    broken++;
+                }
+            }
+            if (weight < 0 && broken > 0) {
+                roomCost[i][r] = -1;
+            } else if (weight > 0) {
+                roomCost[i][r] = (long long)weight * broken;
+            }
+        }
+    }
+    slotIntersecting.assign(data.slots.size(),
+                            std::vector<bool>(data.slots.size(), false));
+    for (int i = 0; i < data.slots.size(); i++) {
+        for (int j = 0; j < data.slots.size(); j++) {
+            slotIntersecting[i][j] =
+                data.slots[i].isIntersecting(data.slots[j]);
+        }
+    }
+    segmentIntersecting.assign(data.segments.size(),
+                               std::vector<bool>(data.segments.size(), false));
+    for (int i = 0; i < data.segments.size(); i++) {
+        for (int j = 0; j < data.segments.size(); j++) {
+            segmentIntersecting[i][j] =
+                data.segments[i].isIntersecting(data.segments[j]);
+        }
+    }
+}
+
+/**
+ * @brief      Checks if the classrooms can be assigned by matching without
+ * losing any timetable.
+ *
+ * This needs the constraints that a Course has exactly one Classroom and that
+ * a Classroom has one Course at a time to be hard, and no custom constraint
+ * to mention classrooms.
+ *
+ * @return     True if the matching is exact, False otherwise
+ */
+bool RoomAssigner::isApplicable() {
+    std::vector<int> &weights = data.predefinedClausesWeights;
+    return weights[PredefinedClauses::classroomSingleCourseAtATime] < 0 &&
+           weights[PredefinedClauses::exactlyOneClassroomPerCourse] < 0 &&
+           !data.classroomCustomConstraints;
+}
+
+/**
+ * @brief      Checks if two courses meet at intersecting times, in the same
+ * way as ConstraintEncoder::notIntersectingTime(), which is if both a pair of
+ * their slots and a pair of their segments intersect.
+ *
+ * @param[in]  course1  The course 1
+ * @param[in]  course2  The course 2
+ *
+ * @return     True if their times intersect, False otherwise
+ */
+bool RoomAssigner::isClashing(int course1, int course2) {
+    bool slot = false, segment = false;
+    for (int a : slotsOf[course1]) {
+        for (int b : slotsOf[course2]) {
+            slot = slot || slotIntersecting[a][b];
+        }
+    }
+    for (int a : segmentsOf[course1]) {
+        for (int b : segmentsOf[course2]) {
+            segment = segment || segmentIntersecting[a][b];
+        }
+    }
+    return slot && segment;
+}
+
+/**
+ * @brief      Gives distinct classrooms to a group of courses at the minimum
+ * cost, with the Hungarian algorithm.
+ *
+ * This is the successive shortest path algorithm for min-cost bipartite
+ * matching, with potentials on both sides.
+ *
+ * @param[in]  courses  The courses
+ * @param      rooms    Set to the Classroom of each Course of the group
+ * @param      cost     Set to the cost of the classrooms
+ *
+ * @return     True if every Course got a Classroom, False otherwise
+ */
+bool RoomAssigner::match(const std::vector<int> &courses,
+                         std::vector<int> &rooms, long long &cost) {
+    int n = courses.size(), m = data.classrooms.size();
+    if (n > m) {
+        return false;
+    }
+    // a forbidden pair costs more than any matching of allowed pairs
+    long long forbidden = 1;
+    for (int i = 0; i < n; i++) {
+        for (int r = 0; r < m; r++) {
+            forbidden += std::max(0LL, roomCost[courses[i]][r]);
+        }
+    }
+    auto pairCost = [&](int i, int r) {
+        long long c = roomCost[courses[i - 1]][r - 1];
+        return c < 0 ? forbidden : c;
+    };
+    const long long infinity = std::numeric_limits<long long>::max() / 4;
+    // 1-indexed, with matchedCourse[r] the Course row matched to Classroom r
+    std::vector<long long> u(n + 1, 0), v(m + 1, 0);
+    std::vector<int> matchedCourse(m + 1, 0), way(m + 1, 0);
+    for (int i = 1; i <= n; i++) {
+        matchedCourse[0] = i;
+        int r0 = 0;
+        std::vector<long long> minv(m + 1, infinity);
+        std::vector<bool> used(m + 1, false);
+        do {
+            used[r0] = true;
+            int i0 = matchedCourse[r0], r1 = 0;
+            long long delta = infinity;
+            for (int r = 1; r <= m; r++) {
+                if (used[r]) {
+                    continue;
+                }
+                long long current = pairCost(i0, r) - u[i0] - v[r];
+                if (current < minv[r]) {
+                    minv[r] = current;
+                    way[r] = r0;
+                }
+                if (minv[r] < delta) {
+                    delta = minv[r];
+                    r1 = r;
+                }
+            }
+            for (int r = 0; r <= m; r++) {
+                if (used[r]) {
+                    u[matchedCourse[r]] += delta;
+                    v[r] -= delta;
+                } else {
+                    minv[r] -= delta;
+                }
+            }
+            r0 = r1;
+        } while (matchedCourse[r0] != 0);
+        do {
+            int r1 = way[r0];
+            matchedCourse[r0] = matchedCourse[r1];
+            r0 = r1;
+        } while (r0 != 0);
+    }
+    rooms.assign(n, -1);
+    cost = 0;
+    for (int r = 1; r <= m; r++) {
+        if (matchedCourse[r] == 0) {
+            continue;
+        }
+        int i = matchedCourse[r] - 1;
+        if (roomCost[courses[i]][r - 1] < 0) {
+            return false;
+        }
+        rooms[i] = r - 1;
+        cost += roomCost[courses[i]][r - 1];
+    }
+    return true;
+}
+
+/**
+ * @brief      Assigns the classrooms for the slots and segments of a model.
+ *
+ * Only the courses whose classroom high level variable is True are given a
+ * Classroom.
+ *
+ * @param[in]  model       The model, of which the slot, segment and high
+ * level variables are used
+ * @param      rooms       Set to the Classroom of each Course, -1 if none
+ * @param      infeasible  Set to the groups of courses that meet at
+ * intersecting times and for which there are no valid classrooms
+ * @param      cost        Set to the cost of the classrooms
+ *
+ * @return     True if every group was either assigned or found infeasible,
+ * False if a group needs the SAT solver
+ */
+bool RoomAssigner::assign(const std::vector<lbool> &model,
+                          std::vector<int> &rooms,
+                          std::vector<std::vector<int>> &infeasible,
+                          long long &cost) {
+    int n = data.courses.size();
+    slotsOf.assign(n, std::vector<int>());
+    segmentsOf.assign(n, std::vector<int>());
+    std::vector<int> needing;
+    for (int i = 0; i < n; i++) {
+        std::vector<Var> &slots = data.fieldValueVars[i][FieldType::slot];
+        for (int j = 0; j < slots.size(); j++) {
+            if (model[slots[j]] == l_True) {
+                slotsOf[i].push_back(j);
+            }
+        }
+        std::vector<Var> &segments = data.fieldValueVars[i][FieldType::segment];
+        for (int j = 0; j < segments.size(); j++) {
+            if (model[segments[j]] == l_True) {
+                segmentsOf[i].push_back(j);
+            }
+        }
+        if (model[data.highLevelVars[i][FieldType::classroom]] == l_True) {
+            needing.push_back(i);
+        }
+    }
+
+    std::vector<int> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    for (int a = 0; a < needing.size(); a++) {
+        for (int b = a + 1; b < needing.size(); b++) {
+            if (isClashing(needing[a], needing[b])) {
+                parent[find(needing[b])] = find(needing[a]);
+            }
+        }
+    }
+    std::vector<std::vector<int>> groups;
+    std::vector<int> groupOf(n, -1);
+    for (int i : needing) {
+        int root = find(i);
+        if (groupOf[root] == -1) {
+            groupOf[root] = groups.size();
+            groups.push_back(std::vector<int>());
+        }
+        groups[groupOf[root]].push_back(i);
+    }
+
+    rooms.assign(n, -1);
+    infeasible.clear();
+    cost = 0;
+    for (int g = 0; g < groups.size(); g++) {
+        std::vector<int> groupRooms;
+        long long groupCost;
+        if (match(groups[g], groupRooms, groupCost)) {
+            for (int k = 0; k < groups[g].size(); k++) {
+                rooms[groups[g][k]] = groupRooms[k];
+            }
+            cost += groupCost;
+            continue;
+        }
+        for (int a = 0; a < groups[g].size(); a++) {
+            for (int b = a + 1; b < groups[g].size(); b++) {
+                if (!isClashing(groups[g][a], groups[g][b])) {
+                    return false;
+                }
+            }
+        }
+        infeasible.push_back(groups[g]);
+    }
+    return true;
+}
@@ -0,0 +1,309 @@
+#include "solver_state.h"
+
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * The first line of a state file, which changes with its format
+ */
+static const std::string STATE_HEADER = "timetabler-state 2";
+
+/**
+ * @brief      Mixes the bits of a hash, so that sums of hashes stay spread
+ * out.
+ *
+ * @param[in]  x     The hash
+ *
+ * @return     The mixed hash
+ */
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief      Constructs the SolverState object, which hashes the clauses of a
+ * formula.
+ *
+ * This is done before the formula is solved, as solving splits its soft
+ * clauses.
+ *
+ * @param[in]  names       The name of each variable of the formula
+ * @param      formula     The formula
+ * @param[in]  hardGroups  The range of the hard clauses of each group
+ */
+SolverState::SolverState(const std::vector<std::string> &names,
+                         MaxSATFormula *formula,
+                         const std::vector<std::pair<int, int>> &hardGroups) {
+    this->names = names;
+    this->names.resize(formula->nVars());
+    std::vector<uint64_t> varHashes;
+    for (int i = 0; i < this->names.size(); i++) {
+        varHashes.push_back(hashName(this->names[i]));
+    }
+    for (int i = 0; i < hardGroups.size(); i++) {
+        uint64_t hash = mix(hardGroups[i].second - hardGroups[i].first);
+        std::unordered_map<Var, int> unnamed;
+        for (int j = hardGroups[i].first; j < hardGroups[i].second; j++) {
+            hash += hashClause(formula->getHardClause(j).clause, varHashes,
+                               unnamed);
+        }
+        groupHashes.push_back(hash);
+    }
+    std::sort(groupHashes.begin(), groupHashes.end());
+    softHash = mix(formula->nSoft());
+    std::unordered_map<Var, int> unnamed;
+    for (int i = 0; i < formula->nSoft(); i++) {
+        Soft &soft = formula->getSoftClause(i);
+        softHash += mix(hashClause(soft.clause, varHashes, unnamed) ^
+                        mix(soft.weight));
+    }
+    savedSoftHash = 0;
+    savedLowerBound = 0;
+}
+
+/**
+ * @brief      Hashes the name of a variable with FNV-1a.
+ *
+ * @param[in]  name  The name
+ *
+ * @return     The hash
+ */
+uint64_t SolverState::hashName(const std::string &name) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < name.size(); i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief      Hashes a clause by the names of its literals, regardless of the
+ * order of the literals.
+ *
+ * The variables without a name, such as those added by the encoding of a
+ * constraint, are hashed by the order in which they first occur in the
+ * clauses of their group, so that a group hashes the same in two runs only
+ * if its unnamed variables are used the same way.
+ *
+ * @param[in]  clause     The clause
+ * @param[in]  varHashes  The hash of the name of each variable
+ * @param      unnamed    The position of each unnamed variable met so far in
+ * the group, to which those of the clause are added
+ *
+ * @return     The hash
+ */
+uint64_t SolverState::hashClause(const vec<Lit> &clause,
+                                 const std::vector<uint64_t> &varHashes,
+                                 std::unordered_map<Var, int> &unnamed) {
+    std::vector<uint64_t> litHashes;
+    for (int i = 0; i < clause.size(); i++) {
+        Var v = var(clause[i]);
+        uint64_t varHash = varHashes[v];
+        if (names[v].empty()) {
+            int position = unnamed.size();
+            varHash = mix(unnamed.emplace(v, position).first->second + 1);
+        }
+        litHashes.push_back(mix(varHash ^ sign(clause[i])));
+    }
+    std::sort(litHashes.begin(), litHashes.end());
+    uint64_t hash = 0;
+    for (int i = 0; i < litHashes.size(); i++) {
+        hash = mix(hash ^ litHashes[i]);
+    }
+    return hash;
+}
+
+/**
+ * @brief      Reads a saved state, and maps its variables to the variables of
+ * the formula with the same names.
+ *
+ * @param[in]  fileName  The name of the state file
+ *
+ * @return     True if the file was read, False if it does not exist or is
+ * not a state file
+ */
+bool SolverState::read(const std::string &fileName) {
+    std::ifstream file(fileName);
+    std::string line;
+    if (!std::getline(file, line) || line != STATE_HEADER) {
+        return false;
+    }
+    std::unordered_map<std::string, Var> current;
+    for (int i = 0; i < names.size(); i++) {
+        if (!names[i].empty()) {
+            current[names[i]] = i;
+        }
+    }
+    std::string word;
+    int count;
+    if (!(file >> word >> count) || word != "vars" || count < 0) {
+        return false;
+    }
+    std::getline(file, line);
+    std::vector<Var> mapped(count, var_Undef);
+    for (int i = 0; i < count && std::getline(file, line); i++) {
+        auto it = current.find(line);
+        if (!line.empty() && it != current.end()) {
+            mapped[i] = it->second;
+        }
+    }
+    int groupCount;
+    if (!(file >> word >> groupCount) || word != "groups") {
+        return false;
+    }
+    savedGroupHashes.assign(std::max(groupCount, 0), 0);
+    for (int i = 0; i < savedGroupHashes.size(); i++) {
+        file >> savedGroupHashes[i];
+    }
+    std::sort(savedGroupHashes.begin(), savedGroupHashes.end());
+    if (!(file >> word >> savedSoftHash) || word != "soft" ||
+        !(file >> word >> savedLowerBound) || word != "lower-bound" ||
+        !(file >> word >> line) || word != "model" ||
+        line.size() != count + 1) {
+        return false;
+    }
+    savedModel.assign(names.size(), l_Undef);
+    for (int i = 0; i < count; i++) {
+        if (mapped[i] != var_Undef && line[i + 1] != '?') {
+            savedModel[mapped[i]] = line[i + 1] == '1' ? l_True : l_False;
+        }
+    }
+    int learntCount;
+    if (!(file >> word >> learntCount) || word != "learnts") {
+        return false;
+    }
+    for (int i = 0; i < learntCount; i++) {
+        int length;
+        if (!(file >> length)) {
+            return false;
+        }
+        std::vector<Lit> clause;
+        for (int j = 0; j < length; j++) {
+            int lit;
+            file >> lit;
+            Var v = lit / 2;
+            if (v >= 0 && v < count && mapped[v] != var_Undef) {
+                clause.push_back(mkLit(mapped[v], lit % 2 == 1));
+            }
+        }
+        if (clause.size() == length && length > 0) {
+            savedLearnts.push_back(clause);
+        }
+    }
+    return !file.fail();
+}
+
+/**
+ * @brief      Writes the state of the formula to a file.
+ *
+ * @param[in]  fileName    The name of the state file
+ * @param[in]  model       The best model
+ * @param[in]  lowerBound  The lower bound proven on the optimal cost
+ * @param[in]  learnts     The clauses learnt over the variables of the
+ * formula, which the hard clauses imply
+ *
+ * @return     True if the file was written, False otherwise
+ */
+bool SolverState::write(const std::string &fileName,
+                        const std::vector<lbool> &model, uint64_t lowerBound,
+                        const std::vector<std::vector<Lit>> &learnts) {
+    std::ofstream file(fileName);
+    file << STATE_HEADER << "\n";
+    file << "vars " << names.size() << "\n";
+    for (int i = 0; i < names.size(); i++) {
+        file << names[i] << "\n";
+    }
+    file << "groups " << groupHashes.size();
+    for (int i = 0; i < groupHashes.size(); i++) {
+        file << " " << groupHashes[i];
+    }
+    file << "\n";
+    file << "soft " << softHash << "\n";
+    file << "lower-bound " << lowerBound << "\n";
+    // the model is prefixed so that it is a single word even when empty
+    file << "model m";
+    for (int i = 0; i < names.size(); i++) {
+        if (i >= model.size() || model[i] == l_Undef) {
+            file << "?";
+        } else {
+            file << (model[i] == l_True ? "1" : "0");
+        }
+    }
+    file << "\n";
+    file << "learnts " << learnts.size() << "\n";
+    for (int i = 0; i < learnts.size(); i++) {
+        file << learnts[i].size();
+        for (int j = 0; j < learnts[i].size(); j++) {
+            file << " " << toInt(learnts[i][j]);
+        }
+        file << "\n";
+    }
+    file.close();
+    return !file.fail();
+}
+
+/**
+ * @brief      Checks if every group of hard clauses of the saved state is
+ * still in the formula, so that the saved learnt clauses still hold.
+ *
+ * @return     True if the saved groups are kept, False otherwise
+ */
+bool SolverState::keepsHardClauses() {
+    return std::includes(groupHashes.begin(), groupHashes.end(),
+                         savedGroupHashes.begin(), savedGroupHashes.end());
+}
+
+/**
+ * @brief      Checks if the hard and soft clauses are the same as in the
+ * saved state, so that the saved lower bound still holds.
+ *
+ * @return     True if the clauses are unchanged, False otherwise
+ */
+bool SolverState::isUnchanged() {
+    return groupHashes == savedGroupHashes && softHash == savedSoftHash;
+}
+
+/**
+ * @brief      Gets the saved model as phase hints.
+ *
+ * @return     The literal of each saved variable that is True in the model
+ */
+std::vector<Lit> SolverState::getModelHints() {
+    std::vector<Lit> hints;
+    for (int i = 0; i < savedModel.size(); i++) {
+        if (savedModel[i] != l_Undef) {
+            hints.push_back(mkLit(i, savedModel[i] == l_False));
+        }
+    }
+    return hints;
+}
+
+/**
+ * @brief      Gets the saved learnt clauses.
+ *
+ * @return     The clauses, over the variables of the formula
+ */
+std::vector<std::vector<Lit>> SolverState::getLearnts() {
+    return savedLearnts;
+}
+
+/**
+ * @brief      Gets the saved lower bound.
+ *
+ * @return     The lower bound
+ */
+uint64_t SolverState::getLowerBound() { return savedLowerBound; }
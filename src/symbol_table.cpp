@@ -0,0 +1,48 @@
+#include "symbol_table.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief      Interns a name, giving it the next id if it is new.
+ *
+ * @param[in]  name  The name
+ *
+ * @return     The id of the name
+ */
+int SymbolTable::intern(const std::string &name) {
+    auto it = ids.emplace(name, int(names.size()));
+    if (it.second) {
+        names.push_back(name);
+    }
+    return it.first->second;
+}
+
+/**
+ * @brief      Finds the id of a name, without interning it.
+ *
+ * @param[in]  name  The name
+ *
+ * @return     The id of the name, -1 if it was never interned
+ */
+int SymbolTable::find(const std::string &name) const {
+    auto it = ids.find(name);
+    return it == ids.end() ? -1 : it->second;
+}
+
+/**
+ * @brief      Gets the name of an id.
+ *
+ * @param[in]  id    The id
+ *
+ * @return     The name
+ */
+const std::string &SymbolTable::getName(int id) const { return names[id]; }
+
+/**
+ * @brief      Gets the number of interned names.
+ *
+ * @return     The number of names, which is one more than the largest id
+ */
+int SymbolTable::size() const { return names.size(); }
@@ -1,18 +1,38 @@
 #include "time_tabler.h"
 
 #include "MaxSATFormula.h"
+#include "annealer.h"
 #include "cclause.h"
 #include "clauses.h"
+#include "compiled_instance.h"
 #include "core/SolverTypes.h"
+#include "decomposition.h"
+#include "instance_features.h"
 #include "mtl/Vec.h"
+#include "room_assigner.h"
+#include "solver_state.h"
 #include "tsolver.h"
 #include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
+#include <initializer_list>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
-using namespace Minisat;
+using namespace NSPACE;
+
+/**
+ * The maximum length of the learnt clauses saved in the state file, as longer
+ * ones rarely prune the search of a later run
+ */
+static const int SAVED_LEARNT_LENGTH = 8;
 
 /**
  * @brief      Constructs the TimeTabler object.
@@ -21,6 +41,101 @@ TimeTabler::TimeTabler() {
     solver = new TSolver(1, _CARD_TOTALIZER_);
     formula = new MaxSATFormula();
     formula->setProblemType(_WEIGHTED_);
+    lexicographic = false;
+    incremental = false;
+    solverLoaded = false;
+    state = NULL;
+}
+
+/**
+ * @brief      Passes the solver settings given as command line options to the
+ * solver.
+ *
+ * @param[in]  options  The options
+ *
+ * @return     True if the settings are valid, False if the algorithm named
+ * does not exist, or the settings conflict
+ */
+bool TimeTabler::configure(const Options &options) {
+    this->options = options;
+    // the classrooms are only matched after the times are solved
+    this->options.hierarchical = options.hierarchical || options.roomMatching;
+    lexicographic = options.lexicographic;
+    if (lexicographic && options.enumerateCount > 1) {
+        std::cout << "Timetables cannot be enumerated in lexicographic mode"
+                  << std::endl;
+        return false;
+    }
+    if (lexicographic && options.lnsTimeLimit > 0) {
+        std::cout << "The large neighbourhood search cannot be lexicographic, "
+                     "as it compares timetables by their total cost"
+                  << std::endl;
+        return false;
+    }
+    incremental = options.interactive;
+    if (lexicographic && incremental) {
+        std::cout << "The interactive mode cannot be lexicographic"
+                  << std::endl;
+        return false;
+    }
+    if ((options.decompose || this->options.hierarchical) &&
+        (lexicographic || incremental || options.enumerateCount > 1 ||
+         options.lnsTimeLimit > 0)) {
+        std::cout << "Decomposition and the hierarchical mode cannot be "
+                     "combined with the lexicographic, enumeration, "
+                     "interactive or large neighbourhood search modes"
+                  << std::endl;
+        return false;
+    }
+    if ((options.compile || !options.compiledFile.empty()) && incremental) {
+        std::cout << "The interactive mode cannot be used with a compiled "
+                     "instance"
+                  << std::endl;
+        return false;
+    }
+    if (options.compile && options.annealTimeLimit > 0) {
+        std::cout << "An instance solved by annealing cannot be compiled"
+                  << std::endl;
+        return false;
+    }
+    if (!options.stateFile.empty() &&
+        (lexicographic || incremental || options.enumerateCount > 1 ||
+         options.decompose || this->options.hierarchical)) {
+        std::cout << "A state file cannot be used in the lexicographic, "
+                     "enumeration, interactive, decomposition or "
+                     "hierarchical modes"
+                  << std::endl;
+        return false;
+    }
+    return configureSolver(solver);
+}
+
+/**
+ * @brief      Passes the solver settings given as command line options to a
+ * solver, which is the main solver or the solver of a component.
+ *
+ * @param      target  The solver
+ *
+ * @return     True if the settings are valid, False if the algorithm named
+ * does not exist
+ */
+bool TimeTabler::configureSolver(TSolver *target) {
+    target->setLocalSearch(options.localSearchFlips, options.seed);
+    target->setCoreOptions(options.coreTrimming, options.coreMinimization,
+                           options.coreExhaustion, options.coreBudget);
+    target->setSATBudget(options.satBudget, options.satBudgetGrowth,
+                         options.satBudgetRetries, options.seed);
+    target->setResumable(options.enumerateCount > 1 || incremental);
+    target->setPersistent(!options.stateFile.empty());
+    MaxSATAlgorithm algorithm;
+    if (!parseAlgorithm(options.algorithm, algorithm)) {
+        std::cout << "Unknown algorithm " << options.algorithm << std::endl;
+        return false;
+    }
+    target->setAlgorithm(algorithm);
+    target->setCoreBoost(options.coreBoostCores, options.coreBoostTime);
+    target->setSeedBudget(options.seedBudget);
+    return true;
 }
 
 /**
@@ -29,10 +144,27 @@ TimeTabler::TimeTabler() {
  * A negative weight implies that the clauses are had, and a zero weight implies
  * that the clauses are not added to the solver.
  *
+ * In incremental mode, the clauses form a new ConstraintGroup, which starts
+ * enabled.
+ *
  * @param[in]  clauses  The clauses
  * @param[in]  weight   The weight
+ *
+ * @return     The index of the ConstraintGroup, -1 if no group was made
  */
-void TimeTabler::addClauses(const std::vector<CClause> &clauses, int weight) {
+int TimeTabler::addClauses(const std::vector<CClause> &clauses, int weight) {
+    if (incremental && weight != 0) {
+        ConstraintGroup group;
+        for (int i = 0; i < clauses.size(); i++) {
+            group.clauses.push_back(clauses[i].getLits());
+        }
+        group.weight = weight;
+        group.enabled = true;
+        groups.push_back(group);
+        addGroupClauses(groups.size() - 1);
+        return groups.size() - 1;
+    }
+    int begin = formula->nHard();
     for (int i = 0; i < clauses.size(); i++) {
         vec<Lit> clauseVec;
         std::vector<Lit> clauseVector = clauses[i].getLits();
@@ -41,6 +173,128 @@ void TimeTabler::addClauses(const std::vector<CClause> &clauses, int weight) {
         }
         addToFormula(clauseVec, weight);
     }
+    addHardGroup(begin);
+    return -1;
+}
+
+/**
+ * @brief      Adds the clauses of a ConstraintGroup with its weight, guarded
+ * by a new selector.
+ *
+ * @param[in]  index  The index of the group
+ */
+void TimeTabler::addGroupClauses(int index) {
+    ConstraintGroup &group = groups[index];
+    group.selector = newLiteral(false);
+    for (int i = 0; i < group.clauses.size(); i++) {
+        vec<Lit> clauseVec;
+        for (int j = 0; j < group.clauses[i].size(); j++) {
+            clauseVec.push(group.clauses[i][j]);
+        }
+        clauseVec.push(~group.selector);
+        addToFormula(clauseVec, group.weight);
+    }
+}
+
+/**
+ * @brief      Gets the number of constraint groups.
+ *
+ * @return     The number of groups
+ */
+int TimeTabler::getGroupCount() {
+    return groups.size();
+}
+
+/**
+ * @brief      Gets the weight of a constraint group.
+ *
+ * @param[in]  index  The index of the group
+ *
+ * @return     The weight, negative if the group is hard
+ */
+int TimeTabler::getGroupWeight(int index) {
+    return groups[index].weight;
+}
+
+/**
+ * @brief      Checks if a constraint group is enabled.
+ *
+ * @param[in]  index  The index of the group
+ *
+ * @return     True if the group is enabled, False otherwise
+ */
+bool TimeTabler::isGroupEnabled(int index) {
+    return groups[index].enabled;
+}
+
+/**
+ * @brief      Enables a constraint group from the next solve on.
+ *
+ * @param[in]  index  The index of the group
+ */
+void TimeTabler::enableGroup(int index) {
+    groups[index].enabled = true;
+}
+
+/**
+ * @brief      Disables a constraint group from the next solve on.
+ *
+ * The selector of the group is no longer assumed, so the solver is free to
+ * set it False and satisfy all the clauses of the group.
+ *
+ * @param[in]  index  The index of the group
+ */
+void TimeTabler::disableGroup(int index) {
+    groups[index].enabled = false;
+}
+
+/**
+ * @brief      Changes the weight of a constraint group from the next solve on.
+ *
+ * The clauses cannot be reweighted in place, so the old selector is retired
+ * by a hard unit clause, and the clauses are added again under a new one.
+ *
+ * @param[in]  index   The index of the group
+ * @param[in]  weight  The new weight, negative if the group is hard
+ */
+void TimeTabler::setGroupWeight(int index, int weight) {
+    if (weight == 0 || weight == groups[index].weight) {
+        return;
+    }
+    vec<Lit> retired;
+    retired.push(~groups[index].selector);
+    addToFormula(retired, -1);
+    groups[index].weight = weight;
+    addGroupClauses(index);
+}
+
+/**
+ * @brief      Solves again after the constraint groups were changed or
+ * constraints were added, carrying on from the previous search where
+ * possible.
+ *
+ * @return     The status of the new timetable
+ */
+SolverStatus TimeTabler::resolve() {
+    assert(incremental && solverLoaded);
+    solver->setSelectors(enabledSelectors());
+    model = solver->resumeSearch();
+    return getStatus();
+}
+
+/**
+ * @brief      Gets the selectors of the enabled constraint groups.
+ *
+ * @return     The selectors
+ */
+std::vector<Lit> TimeTabler::enabledSelectors() {
+    std::vector<Lit> selectors;
+    for (int i = 0; i < groups.size(); i++) {
+        if (groups[i].enabled) {
+            selectors.push_back(groups[i].selector);
+        }
+    }
+    return selectors;
 }
 
 /**
@@ -48,21 +302,29 @@ void TimeTabler::addClauses(const std::vector<CClause> &clauses, int weight) {
  * solver.
  */
 void TimeTabler::addHighLevelClauses() {
+    int begin = formula->nHard();
     for (int i = 0; i < Global::FIELD_COUNT; i++) {
         for (int j = 0; j < data.highLevelVars.size(); j++) {
             vec<Lit> highLevelClause;
             highLevelClause.clear();
             highLevelClause.push(mkLit(data.highLevelVars[j][i], false));
-            addToFormula(highLevelClause, data.highLevelVarWeights[i]);
+            addToFormula(highLevelClause, data.highLevelVarWeights[i],
+                         ObjectiveLevel::HighLevelObjective);
+            phaseHints.push_back(highLevelClause[0]);
         }
     }
+    addHardGroup(begin);
 }
 
 /**
  * @brief      Adds unit clauses corresponding to existing assignments given in
  * the input to the solver.
+ *
+ * The same literals are also recorded as phase hints, so that the solver
+ * starts its search from the existing assignment.
  */
 void TimeTabler::addExistingAssignments() {
+    int begin = formula->nHard();
     for (int i = 0; i < data.existingAssignmentVars.size(); i++) {
         for (int j = 0; j < data.existingAssignmentVars[i].size(); j++) {
             for (int k = 0; k < data.existingAssignmentVars[i][j].size(); k++) {
@@ -76,10 +338,25 @@ void TimeTabler::addExistingAssignments() {
                 } else {
                     clause.push(~mkLit(data.fieldValueVars[i][j][k]));
                 }
-                addToFormula(clause, data.existingAssignmentWeights[j]);
+                addToFormula(clause, data.existingAssignmentWeights[j],
+                             ObjectiveLevel::AssignmentObjective);
+                phaseHints.push_back(clause[0]);
             }
         }
     }
+    addHardGroup(begin);
+}
+
+/**
+ * @brief      Records the hard clauses added to the formula since a given
+ * count as a group, if there are any.
+ *
+ * @param[in]  begin  The number of hard clauses before the group was added
+ */
+void TimeTabler::addHardGroup(int begin) {
+    if (!solverLoaded && formula->nHard() > begin) {
+        hardGroups.push_back(std::make_pair(begin, formula->nHard()));
+    }
 }
 
 /**
@@ -92,13 +369,60 @@ void TimeTabler::addExistingAssignments() {
  * @param[in]  weight  The weight
  */
 void TimeTabler::addToFormula(vec<Lit> &input, int weight) {
+    addToFormula(input, weight, ObjectiveLevel::ConstraintObjective);
+}
+
+/**
+ * @brief      Add a given vec of literals with the given weight to the
+ * formula, at the given objective level if it is soft.
+ *
+ * @param      input   The input
+ * @param[in]  weight  The weight
+ * @param[in]  level   The objective level
+ */
+void TimeTabler::addToFormula(vec<Lit> &input, int weight,
+                              ObjectiveLevel level) {
+    if (solverLoaded) {
+        if (weight < 0) {
+            solver->addHardClause(input);
+        } else if (weight > 0) {
+            solver->addSoftClause(weight, input);
+        }
+        return;
+    }
     if (weight < 0) {
         formula->addHardClause(input);
     } else if (weight > 0) {
         formula->addSoftClause(weight, input);
+        softClauseLevels.push_back(level);
     }
 }
 
+/**
+ * @brief      Adds phase hints for the solver.
+ *
+ * If a variable is hinted more than once, the last hint given for it is used.
+ *
+ * @param[in]  hints  The hint literals
+ */
+void TimeTabler::addPhaseHints(const std::vector<Lit> &hints) {
+    phaseHints.insert(phaseHints.end(), hints.begin(), hints.end());
+}
+
+/**
+ * @brief      Adds the phase hints of the greedy schedule, which are also the
+ * seed of the upper bound that the solver tries after the existing
+ * assignments.
+ *
+ * The greedy hints come before all the other hints, so that a variable hinted
+ * by an existing assignment keeps that hint.
+ *
+ * @param[in]  hints  The hint literals
+ */
+void TimeTabler::addGreedyHints(const std::vector<Lit> &hints) {
+    greedyHints.insert(greedyHints.end(), hints.begin(), hints.end());
+}
+
 /**
  * @brief      Adds clauses to the solver with specified weights.
  *
@@ -107,9 +431,145 @@ void TimeTabler::addToFormula(vec<Lit> &input, int weight) {
  *
  * @param[in]  clauses  The clauses
  * @param[in]  weight   The weight
+ *
+ * @return     The index of the ConstraintGroup, -1 if no group was made
+ */
+int TimeTabler::addClauses(const Clauses &clauses, int weight) {
+    return addClauses(clauses.getClauses(), weight);
+}
+
+/**
+ * @brief      Gets the greedy hints followed by the phase hints, with only the
+ * last hint kept for each variable.
+ *
+ * @return     The hints
+ */
+std::vector<Lit> TimeTabler::uniqueHints() {
+    std::vector<Lit> allHints(greedyHints);
+    allHints.insert(allHints.end(), phaseHints.begin(), phaseHints.end());
+    std::vector<int> lastHint(formula->nVars(), -1);
+    for (int i = 0; i < allHints.size(); i++) {
+        lastHint[var(allHints[i])] = i;
+    }
+    std::vector<Lit> hints;
+    for (int i = 0; i < allHints.size(); i++) {
+        if (lastHint[var(allHints[i])] == i) {
+            hints.push_back(allHints[i]);
+        }
+    }
+    return hints;
+}
+
+/**
+ * @brief      Gets the literals of the existing assignments, which are the
+ * phase hints that the solver assumes to seed its upper bound. The hints of
+ * the high level variables are left out, as some high level clause is
+ * violated in most timetables.
+ *
+ * @return     The literals
+ */
+std::vector<Lit> TimeTabler::assignmentHints() {
+    std::vector<Lit> hints;
+    for (int i = 0; i < data.existingAssignmentVars.size(); i++) {
+        for (int j = 0; j < data.existingAssignmentVars[i].size(); j++) {
+            for (int k = 0; k < data.existingAssignmentVars[i][j].size(); k++) {
+                lbool value = data.existingAssignmentVars[i][j][k];
+                if (value != l_Undef) {
+                    hints.push_back(
+                        mkLit(data.fieldValueVars[i][j][k], value == l_False));
+                }
+            }
+        }
+    }
+    return hints;
+}
+
+/**
+ * @brief      Loads the formula into the solver, along with the phase hints,
+ * the existing assignments and the greedy schedule as seeds of the upper bound
+ * and the branching priorities if they are enabled.
+ *
+ * If a variable is hinted more than once, only the last hint for it is given.
+ */
+void TimeTabler::loadSolver() {
+    solver->loadFormula(formula);
+    solver->setPhaseHints(uniqueHints());
+    solver->addSeed("the existing assignments", assignmentHints());
+    solver->addSeed("the greedy schedule", greedyHints);
+    if (options.branching) {
+        solver->setBranchingPriorities(branchingPriorities());
+    }
+    if (lexicographic) {
+        solver->setObjectiveLevels(softClauseLevels);
+    }
+    if (incremental) {
+        solver->setSelectors(enabledSelectors());
+    }
+    solverLoaded = true;
+}
+
+/**
+ * @brief      Gets the branching priorities of the variables.
+ *
+ * The slot variables come first, then the segment variables and then the
+ * classroom variables, as fixing the time of a Course decides most of its
+ * clauses while its classroom is usually free once the time is known. Within
+ * a field, the courses that share their Instructor or a core Program with the
+ * most other courses come first, as those are the most constrained. The other
+ * variables, whose values the input mostly fixes, the high level variables
+ * and the auxiliary variables of the solver are left to the SAT solver.
+ *
+ * @return     The priority of each variable, zero if it has none
+ */
+std::vector<double> TimeTabler::branchingPriorities() {
+    int courseCount = data.courses.size();
+    std::vector<int> instructorCourses(data.instructors.size(), 0);
+    std::vector<int> programCourses(data.programs.size(), 0);
+    for (int i = 0; i < courseCount; i++) {
+        instructorCourses[data.courses[i].getInstructor()]++;
+        std::vector<int> programs = data.courses[i].getPrograms();
+        for (int j = 0; j < programs.size(); j++) {
+            if (data.programs[programs[j]].isCoreProgram()) {
+                programCourses[programs[j]]++;
+            }
+        }
+    }
+    std::vector<int> degree(courseCount, 0);
+    int maxDegree = 0;
+    for (int i = 0; i < courseCount; i++) {
+        degree[i] = instructorCourses[data.courses[i].getInstructor()] - 1;
+        std::vector<int> programs = data.courses[i].getPrograms();
+        for (int j = 0; j < programs.size(); j++) {
+            if (data.programs[programs[j]].isCoreProgram()) {
+                degree[i] += programCourses[programs[j]] - 1;
+            }
+        }
+        maxDegree = std::max(maxDegree, degree[i]);
+    }
+    const std::pair<FieldType, double> fieldRanks[] = {
+        std::make_pair(FieldType::slot, 3.0),
+        std::make_pair(FieldType::segment, 2.0),
+        std::make_pair(FieldType::classroom, 1.0)};
+    std::vector<double> priorities(formula->nVars(), 0);
+    for (int i = 0; i < courseCount; i++) {
+        double courseRank = double(degree[i]) / (maxDegree + 1);
+        for (int f = 0; f < 3; f++) {
+            std::vector<Var> &vars = data.fieldValueVars[i][fieldRanks[f].first];
+            for (int k = 0; k < vars.size(); k++) {
+                priorities[vars[k]] = fieldRanks[f].second + courseRank;
+            }
+        }
+    }
+    return priorities;
+}
+
+/**
+ * @brief      Runs the same SAT calls on the formula with the SAT solver that
+ * was built in, and prints the time each takes, without solving the formula.
  */
-void TimeTabler::addClauses(const Clauses &clauses, int weight) {
-    addClauses(clauses.getClauses(), weight);
+void TimeTabler::benchmarkSATSolver() {
+    loadSolver();
+    solver->benchmarkSATSolver();
 }
 
 /**
@@ -118,8 +578,736 @@ void TimeTabler::addClauses(const Clauses &clauses, int weight) {
  * @return     True, if all high level variables were satisfied, False otherwise
  */
 SolverStatus TimeTabler::solve() {
-    solver->loadFormula(formula);
+    if (options.decompose) {
+        Decomposition decomposition(formula);
+        if (!decomposition.isConflicting() &&
+            decomposition.getComponentCount() > 1) {
+            std::cout << "Decomposed into "
+                      << decomposition.getComponentCount()
+                      << " independent components" << std::endl;
+            uint64_t cost = decomposition.getFixedCost();
+            std::vector<std::vector<lbool>> models =
+                solveComponents(decomposition, uniqueHints(), cost);
+            model = decomposition.getFixedModel();
+            for (int i = 0; i < models.size(); i++) {
+                if (models[i].size() == 0) {
+                    model.clear();
+                    break;
+                }
+                decomposition.mergeModel(i, models[i], model);
+            }
+            if (model.size() > 0) {
+                std::cout << "Cost: " << cost << std::endl;
+            }
+            return getStatus();
+        }
+    }
+    if (options.hierarchical) {
+        solveHierarchical();
+        return getStatus();
+    }
+    if (!options.stateFile.empty()) {
+        loadState();
+    }
+    loadSolver();
     model = solver->tSearch();
+    solver->printCoreStatistics();
+    if (lexicographic) {
+        const char *levelNames[] = {"High level", "Existing assignments",
+                                    "Constraints"};
+        std::vector<uint64_t> costs = solver->getLevelCosts();
+        for (int i = 0; i < costs.size(); i++) {
+            std::cout << levelNames[i] << " cost: " << costs[i] << std::endl;
+        }
+    }
+    return getStatus();
+}
+
+/**
+ * @brief      Gets the name of a field value.
+ *
+ * @param[in]  fieldType  The FieldType
+ * @param[in]  index      The index of the value
+ *
+ * @return     The name
+ */
+std::string TimeTabler::fieldValueName(FieldType fieldType, int index) {
+    switch (fieldType) {
+    case FieldType::instructor:
+        return data.instructors[index].getName();
+    case FieldType::segment:
+        return data.segments[index].getName();
+    case FieldType::isMinor:
+        return data.isMinors[index].getName();
+    case FieldType::program:
+        return data.programs[index].getNameWithType();
+    case FieldType::classroom:
+        return data.classrooms[index].getName();
+    default:
+        return data.slots[index].getName();
+    }
+}
+
+/**
+ * @brief      Gets the names of the variables of the formula, which stay the
+ * same between runs on inputs that differ in other courses or field values.
+ *
+ * A field value variable is named by its Course, FieldType and field value,
+ * and a high level variable by its Course and FieldType.
+ *
+ * @return     The name of each variable, empty if it has none
+ */
+std::vector<std::string> TimeTabler::variableNames() {
+    std::vector<std::string> names(formula->nVars());
+    for (int i = 0; i < data.courses.size(); i++) {
+        for (int j = 0; j < Global::FIELD_COUNT; j++) {
+            std::string field = data.courses[i].getName() + "\t" +
+                                Utils::getFieldTypeName(FieldType(j));
+            names[data.highLevelVars[i][j]] = field;
+            for (int k = 0; k < data.fieldValueVars[i][j].size(); k++) {
+                names[data.fieldValueVars[i][j][k]] =
+                    field + "\t" + fieldValueName(FieldType(j), k);
+            }
+        }
+    }
+    return names;
+}
+
+/**
+ * @brief      Reads the state saved by an earlier run, and passes what still
+ * holds to the solver.
+ *
+ * The saved model is added as the last phase hints. The saved learnt clauses
+ * are added as hard clauses if the saved groups of hard clauses are all
+ * unchanged, and the saved lower bound is given to the solver if the formula
+ * is unchanged.
+ */
+void TimeTabler::loadState() {
+    state = new SolverState(variableNames(), formula, hardGroups);
+    if (!state->read(options.stateFile)) {
+        std::cout << "No saved state read from " << options.stateFile
+                  << std::endl;
+        return;
+    }
+    addPhaseHints(state->getModelHints());
+    int learnts = 0;
+    if (state->keepsHardClauses()) {
+        std::vector<std::vector<Lit>> clauses = state->getLearnts();
+        for (int i = 0; i < clauses.size(); i++) {
+            vec<Lit> clauseVec;
+            for (int j = 0; j < clauses[i].size(); j++) {
+                clauseVec.push(clauses[i][j]);
+            }
+            formula->addHardClause(clauseVec);
+        }
+        learnts = clauses.size();
+    }
+    std::cout << "Read the saved state with " << learnts
+              << " learnt clauses";
+    if (state->isUnchanged()) {
+        solver->setKnownLowerBound(state->getLowerBound());
+        std::cout << " and the lower bound " << state->getLowerBound();
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief      Saves the state of the solver, which is the best model, the
+ * lower bound on its cost and the short learnt clauses, for the next run.
+ */
+void TimeTabler::saveState() {
+    if (state == NULL) {
+        return;
+    }
+    if (!state->write(options.stateFile, model, solver->getLowerBound(),
+                      solver->getLearnts(SAVED_LEARNT_LENGTH))) {
+        std::cout << "Could not write the state to " << options.stateFile
+                  << std::endl;
+    }
+}
+
+/**
+ * @brief      Writes the parsed Data and the encoded formula to a compiled
+ * instance, to be solved later without parsing and encoding them again.
+ *
+ * @param[in]  fileName  The name of the file
+ *
+ * @return     True if the file was written, False otherwise
+ */
+bool TimeTabler::writeCompiled(std::string fileName) {
+    CompiledInstance compiled;
+    if (!compiled.write(fileName, data, formula, softClauseLevels, hardGroups,
+                        phaseHints, greedyHints)) {
+        std::cout << fileName << ": " << compiled.getError() << std::endl;
+        return false;
+    }
+    std::cout << "Compiled " << formula->nVars() << " variables, "
+              << formula->nHard() << " hard clauses and " << formula->nSoft()
+              << " soft clauses to " << fileName << std::endl;
+    return true;
+}
+
+/**
+ * @brief      Loads the Data and the formula from a compiled instance, in
+ * place of parsing the input files and encoding the constraints.
+ *
+ * @param[in]  fileName  The name of the file
+ *
+ * @return     True if the file was loaded, False otherwise
+ */
+bool TimeTabler::loadCompiled(std::string fileName) {
+    CompiledInstance compiled;
+    if (!compiled.read(fileName, data, formula, softClauseLevels, hardGroups,
+                       phaseHints, greedyHints)) {
+        std::cout << fileName << ": " << compiled.getError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief      Solves the components of a formula independently, on a pool of
+ * threads.
+ *
+ * The components are handed out to the threads largest first, so that the
+ * time taken is close to the time of the largest component.
+ *
+ * @param      decomposition  The decomposition of the formula
+ * @param[in]  hints          The phase hints over the whole formula
+ * @param      cost           The cost of each component solved is added to it
+ *
+ * @return     The model of each component formula, empty if its hard clauses
+ * are unsatisfiable
+ */
+std::vector<std::vector<lbool>>
+TimeTabler::solveComponents(Decomposition &decomposition,
+                            const std::vector<Lit> &hints, uint64_t &cost) {
+    int count = decomposition.getComponentCount();
+    std::vector<TSolver *> solvers(count);
+    std::vector<std::pair<int, int>> order;
+    for (int i = 0; i < count; i++) {
+        MaxSATFormula *componentFormula = decomposition.buildFormula(i);
+        order.push_back(std::make_pair(
+            -(componentFormula->nHard() + componentFormula->nSoft()), i));
+        solvers[i] = new TSolver(1, _CARD_TOTALIZER_);
+        configureSolver(solvers[i]);
+        solvers[i]->loadFormula(componentFormula);
+        solvers[i]->setPhaseHints(decomposition.localHints(i, hints));
+        solvers[i]->addSeed("the existing assignments",
+                            decomposition.localHints(i, assignmentHints()));
+        solvers[i]->addSeed("the greedy schedule",
+                            decomposition.localHints(i, greedyHints));
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<std::vector<lbool>> models(count);
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int k = next++; k < count; k = next++) {
+            int i = order[k].second;
+            models[i] = solvers[i]->tSearch();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < std::min(options.threads, count); t++) {
+        threads.push_back(std::thread(worker));
+    }
+    for (int t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (models[i].size() > 0) {
+            cost += solvers[i]->getCost();
+        }
+        delete solvers[i];
+    }
+    return models;
+}
+
+/**
+ * @brief      Gets which variables of the formula are classroom variables.
+ *
+ * @return     For each variable, whether it is a classroom variable
+ */
+std::vector<bool> TimeTabler::classroomVars() {
+    std::vector<bool> result(formula->nVars(), false);
+    for (int i = 0; i < data.courses.size(); i++) {
+        std::vector<Var> &vars = data.fieldValueVars[i][FieldType::classroom];
+        for (int j = 0; j < vars.size(); j++) {
+            result[vars[j]] = true;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief      Adds hard clauses to a formula that allow at most a given
+ * number of the literals to be True, with the sequential counter encoding.
+ *
+ * @param      target  The formula
+ * @param[in]  lits    The literals
+ * @param[in]  bound   The bound
+ */
+void TimeTabler::addAtMost(MaxSATFormula *target, const std::vector<Lit> &lits,
+                           int bound) {
+    int n = lits.size();
+    auto add = [target](std::initializer_list<Lit> clause) {
+        vec<Lit> clauseVec;
+        for (Lit l : clause) {
+            clauseVec.push(l);
+        }
+        target->addHardClause(clauseVec);
+    };
+    if (n <= bound) {
+        return;
+    }
+    if (bound == 0) {
+        for (int i = 0; i < n; i++) {
+            add({~lits[i]});
+        }
+        return;
+    }
+    // counter[i][j] is True if at least j + 1 of the first i + 1 literals are
+    std::vector<std::vector<Lit>> counter(n - 1, std::vector<Lit>(bound));
+    for (int i = 0; i < n - 1; i++) {
+        for (int j = 0; j < bound; j++) {
+            counter[i][j] = target->newLiteral();
+        }
+    }
+    add({~lits[0], counter[0][0]});
+    for (int j = 1; j < bound; j++) {
+        add({~counter[0][j]});
+    }
+    for (int i = 1; i < n - 1; i++) {
+        add({~lits[i], counter[i][0]});
+        add({~counter[i - 1][0], counter[i][0]});
+        for (int j = 1; j < bound; j++) {
+            add({~lits[i], ~counter[i - 1][j - 1], counter[i][j]});
+            add({~counter[i - 1][j], counter[i][j]});
+        }
+        add({~lits[i], ~counter[i - 1][bound - 1]});
+    }
+    add({~lits[n - 1], ~counter[n - 2][bound - 1]});
+}
+
+/**
+ * @brief      Adds the aggregate classroom capacity constraints to the formula
+ * of the time assignment.
+ *
+ * For every class size k, the number of courses of size at least k that
+ * have the same Slot and Segment, and so need different classrooms, must not
+ * exceed the number of classrooms of size at least k. This holds in every
+ * timetable in which a Course that is given a Classroom gets exactly one
+ * large enough for it and no two courses at intersecting times share one,
+ * so it is only added when both of these constraints are hard.
+ *
+ * @param      target  The formula of the time assignment
+ */
+void TimeTabler::addCapacityConstraints(MaxSATFormula *target) {
+    std::vector<int> &weights = data.predefinedClausesWeights;
+    if (weights[PredefinedClauses::classroomSingleCourseAtATime] >= 0 ||
+        weights[PredefinedClauses::exactlyOneClassroomPerCourse] >= 0) {
+        return;
+    }
+    std::vector<unsigned> sizes;
+    for (int i = 0; i < data.courses.size(); i++) {
+        sizes.push_back(data.courses[i].getClassSize());
+    }
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    // the thresholds at which more courses than classrooms are large enough
+    std::vector<unsigned> thresholds;
+    std::vector<int> roomCounts;
+    for (int k = 0; k < sizes.size(); k++) {
+        int courses = 0, rooms = 0;
+        for (int i = 0; i < data.courses.size(); i++) {
+            courses += data.courses[i].getClassSize() >= sizes[k];
+        }
+        for (int i = 0; i < data.classrooms.size(); i++) {
+            rooms += data.classrooms[i].getSize() >= sizes[k];
+        }
+        if (courses > rooms) {
+            thresholds.push_back(sizes[k]);
+            roomCounts.push_back(rooms);
+        }
+    }
+    if (thresholds.size() == 0) {
+        return;
+    }
+    for (int s = 0; s < data.slots.size(); s++) {
+        for (int g = 0; g < data.segments.size(); g++) {
+            // meets[i] is True if Course i is given a Classroom, Slot s and
+            // Segment g
+            std::vector<Lit> meets(data.courses.size(), lit_Undef);
+            for (int i = 0; i < data.courses.size(); i++) {
+                if (data.courses[i].getClassSize() < thresholds[0]) {
+                    continue;
+                }
+                meets[i] = target->newLiteral();
+                vec<Lit> clause;
+                clause.push(~mkLit(data.fieldValueVars[i][FieldType::slot][s]));
+                clause.push(
+                    ~mkLit(data.fieldValueVars[i][FieldType::segment][g]));
+                clause.push(
+                    ~mkLit(data.highLevelVars[i][FieldType::classroom]));
+                clause.push(meets[i]);
+                target->addHardClause(clause);
+            }
+            for (int k = 0; k < thresholds.size(); k++) {
+                std::vector<Lit> lits;
+                for (int i = 0; i < data.courses.size(); i++) {
+                    if (data.courses[i].getClassSize() >= thresholds[k]) {
+                        lits.push_back(meets[i]);
+                    }
+                }
+                addAtMost(target, lits, roomCounts[k]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief      Builds the formula of the time assignment, which is the first
+ * phase of the hierarchical solve.
+ *
+ * This has the clauses of the formula without classroom variables, and the
+ * aggregate capacity constraints in their place.
+ *
+ * @param[in]  roomVar  Whether each variable is a classroom variable
+ *
+ * @return     The formula, owned by the caller
+ */
+MaxSATFormula *TimeTabler::buildTimeFormula(const std::vector<bool> &roomVar) {
+    MaxSATFormula *result = new MaxSATFormula();
+    result->setProblemType(_WEIGHTED_);
+    for (int i = 0; i < formula->nVars(); i++) {
+        result->newVar();
+    }
+    auto hasRoomVar = [&roomVar](vec<Lit> &clause) {
+        for (int i = 0; i < clause.size(); i++) {
+            if (roomVar[var(clause[i])]) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (int i = 0; i < formula->nHard(); i++) {
+        vec<Lit> &clause = formula->getHardClause(i).clause;
+        if (!hasRoomVar(clause)) {
+            vec<Lit> copy;
+            clause.copyTo(copy);
+            result->addHardClause(copy);
+        }
+    }
+    for (int i = 0; i < formula->nSoft(); i++) {
+        Soft &soft = formula->getSoftClause(i);
+        if (!hasRoomVar(soft.clause)) {
+            vec<Lit> copy;
+            soft.clause.copyTo(copy);
+            result->addSoftClause(soft.weight, copy);
+        }
+    }
+    addCapacityConstraints(result);
+    return result;
+}
+
+/**
+ * @brief      Builds the formula of the classroom assignment for a time
+ * assignment, which is the second phase of the hierarchical solve.
+ *
+ * This has the clauses of the formula with classroom variables, in which the
+ * other literals are replaced by their values in the time assignment.
+ *
+ * @param[in]  timeModel  The time assignment
+ * @param[in]  roomVar    Whether each variable is a classroom variable
+ * @param      reasons    Set to the literals removed from each hard clause,
+ * which are False in the time assignment
+ *
+ * @return     The formula, owned by the caller
+ */
+MaxSATFormula *
+TimeTabler::buildRoomFormula(const std::vector<lbool> &timeModel,
+                             const std::vector<bool> &roomVar,
+                             std::vector<std::vector<Lit>> &reasons) {
+    MaxSATFormula *result = new MaxSATFormula();
+    result->setProblemType(_WEIGHTED_);
+    for (int i = 0; i < formula->nVars(); i++) {
+        result->newVar();
+    }
+    // gets the classroom literals of a clause and the other literals, unless
+    // one of these is True
+    auto reduce = [&](vec<Lit> &clause, vec<Lit> &rooms,
+                      std::vector<Lit> &others) {
+        bool hasRoom = false;
+        for (int i = 0; i < clause.size(); i++) {
+            if (roomVar[var(clause[i])]) {
+                rooms.push(clause[i]);
+                hasRoom = true;
+            } else if ((timeModel[var(clause[i])] == l_True) !=
+                       sign(clause[i])) {
+                return false;
+            } else {
+                others.push_back(clause[i]);
+            }
+        }
+        return hasRoom;
+    };
+    for (int i = 0; i < formula->nHard(); i++) {
+        vec<Lit> rooms;
+        std::vector<Lit> others;
+        if (reduce(formula->getHardClause(i).clause, rooms, others)) {
+            result->addHardClause(rooms);
+            reasons.push_back(others);
+        }
+    }
+    for (int i = 0; i < formula->nSoft(); i++) {
+        Soft &soft = formula->getSoftClause(i);
+        vec<Lit> rooms;
+        std::vector<Lit> others;
+        if (reduce(soft.clause, rooms, others)) {
+            result->addSoftClause(soft.weight, rooms);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief      Solves in two phases, first the times and then the classrooms.
+ *
+ * The first phase solves the formula without the classroom variables, with
+ * aggregate capacity constraints in their place, see
+ * addCapacityConstraints(). The second phase fixes the times found, which
+ * splits the classroom assignment into independent components of courses
+ * meeting at intersecting times, and solves these on a pool of threads. If
+ * a component has no valid classroom assignment, the first phase is resumed
+ * with a clause that rules out the times that made it fail, so that the
+ * timetable is found whenever the formula has one.
+ *
+ * With room matching, the classrooms are assigned by the RoomAssigner where
+ * that is exact, and the classroom variables are then never given to a SAT
+ * solver.
+ */
+void TimeTabler::solveHierarchical() {
+    std::vector<bool> roomVar = classroomVars();
+    std::vector<Lit> hints = uniqueHints();
+    std::vector<Lit> timeHints, roomHints;
+    for (int i = 0; i < hints.size(); i++) {
+        (roomVar[var(hints[i])] ? roomHints : timeHints).push_back(hints[i]);
+    }
+    TSolver *timeSolver = new TSolver(1, _CARD_TOTALIZER_);
+    configureSolver(timeSolver);
+    timeSolver->setResumable(true);
+    timeSolver->loadFormula(buildTimeFormula(roomVar));
+    timeSolver->setPhaseHints(timeHints);
+    std::vector<Lit> assignments = assignmentHints();
+    std::vector<Lit> timeAssignments, timeGreedy;
+    for (int i = 0; i < assignments.size(); i++) {
+        if (!roomVar[var(assignments[i])]) {
+            timeAssignments.push_back(assignments[i]);
+        }
+    }
+    for (int i = 0; i < greedyHints.size(); i++) {
+        if (!roomVar[var(greedyHints[i])]) {
+            timeGreedy.push_back(greedyHints[i]);
+        }
+    }
+    timeSolver->addSeed("the existing assignments", timeAssignments);
+    timeSolver->addSeed("the greedy schedule", timeGreedy);
+    std::vector<lbool> timeModel = timeSolver->tSearch();
+
+    RoomAssigner assigner(data);
+    bool matching = options.roomMatching && assigner.isApplicable();
+    if (options.roomMatching && !matching) {
+        std::cout << "Classrooms are assigned by the SAT solver, as the "
+                     "classroom constraints are soft or a custom constraint "
+                     "mentions classrooms"
+                  << std::endl;
+    }
+    model.clear();
+    for (int round = 1; timeModel.size() > 0; round++) {
+        timeModel.resize(formula->nVars());
+        for (int i = 0; i < timeModel.size(); i++) {
+            if (timeModel[i] == l_Undef) {
+                timeModel[i] = l_False;
+            }
+        }
+        std::vector<int> rooms;
+        std::vector<std::vector<int>> infeasible;
+        long long roomCost;
+        if (matching && assigner.assign(timeModel, rooms, infeasible,
+                                        roomCost)) {
+            if (infeasible.size() == 0) {
+                model = timeModel;
+                for (int i = 0; i < data.courses.size(); i++) {
+                    std::vector<Var> &vars =
+                        data.fieldValueVars[i][FieldType::classroom];
+                    for (int j = 0; j < vars.size(); j++) {
+                        model[vars[j]] = j == rooms[i] ? l_True : l_False;
+                    }
+                }
+                std::cout << "Classrooms matched in " << round
+                          << (round == 1 ? " round" : " rounds") << ", cost "
+                          << timeSolver->getCost() + roomCost << std::endl;
+                break;
+            }
+            // the courses of each group keep meeting at intersecting times
+            // and needing classrooms as long as these literals hold
+            for (int g = 0; g < infeasible.size(); g++) {
+                vec<Lit> nogood;
+                for (int i : infeasible[g]) {
+                    FieldType timeFields[] = {FieldType::slot,
+                                              FieldType::segment};
+                    for (int f = 0; f < 2; f++) {
+                        std::vector<Var> &vars =
+                            data.fieldValueVars[i][timeFields[f]];
+                        for (int j = 0; j < vars.size(); j++) {
+                            if (timeModel[vars[j]] == l_True) {
+                                nogood.push(~mkLit(vars[j]));
+                            }
+                        }
+                    }
+                    nogood.push(
+                        ~mkLit(data.highLevelVars[i][FieldType::classroom]));
+                }
+                timeSolver->addHardClause(nogood);
+            }
+            timeModel = timeSolver->resumeSearch();
+            continue;
+        }
+        std::vector<std::vector<Lit>> reasons;
+        MaxSATFormula *roomFormula =
+            buildRoomFormula(timeModel, roomVar, reasons);
+        Decomposition decomposition(roomFormula);
+        // the hard clauses whose reasons are added to the clause ruling out
+        // the times, which are those of the failed component and those
+        // satisfied or fixed by propagation
+        std::vector<bool> blamed(reasons.size(), true);
+        if (!decomposition.isConflicting()) {
+            uint64_t cost = timeSolver->getCost() +
+                            decomposition.getFixedCost();
+            std::vector<std::vector<lbool>> models =
+                solveComponents(decomposition, roomHints, cost);
+            int failed = -1;
+            for (int c = 0; c < models.size() && failed == -1; c++) {
+                if (models[c].size() == 0) {
+                    failed = c;
+                }
+            }
+            if (failed == -1) {
+                model = decomposition.getFixedModel();
+                for (int c = 0; c < models.size(); c++) {
+                    decomposition.mergeModel(c, models[c], model);
+                }
+                for (int i = 0; i < model.size(); i++) {
+                    if (!roomVar[i]) {
+                        model[i] = timeModel[i];
+                    }
+                }
+                std::cout << "Classrooms assigned in " << round
+                          << (round == 1 ? " round" : " rounds") << ", cost "
+                          << cost << std::endl;
+                delete roomFormula;
+                break;
+            }
+            for (int c = 0; c < models.size(); c++) {
+                if (c == failed) {
+                    continue;
+                }
+                std::vector<int> clauses = decomposition.getHardClauses(c);
+                for (int i = 0; i < clauses.size(); i++) {
+                    blamed[clauses[i]] = false;
+                }
+            }
+        }
+        delete roomFormula;
+        std::vector<bool> inNogood(formula->nVars(), false);
+        vec<Lit> nogood;
+        for (int i = 0; i < reasons.size(); i++) {
+            for (int j = 0; blamed[i] && j < reasons[i].size(); j++) {
+                if (!inNogood[var(reasons[i][j])]) {
+                    inNogood[var(reasons[i][j])] = true;
+                    nogood.push(reasons[i][j]);
+                }
+            }
+        }
+        timeSolver->addHardClause(nogood);
+        timeModel = timeSolver->resumeSearch();
+    }
+    delete timeSolver;
+}
+
+/**
+ * @brief      Finds the next best timetable, after blocking the current one.
+ *
+ * The current timetable is blocked over the slot and classroom variables
+ * only, so that the next timetable differs from it in where or when at least
+ * one Course meets. The solver carries on from the cores of the previous
+ * searches.
+ *
+ * @param[in]  minChanged  The minimum number of slot and classroom
+ * assignments of courses in which the next timetable must differ from the
+ * current one
+ *
+ * @return     The status of the next timetable
+ */
+SolverStatus TimeTabler::nextSolution(int minChanged) {
+    if (model.size() == 0) {
+        return SolverStatus::Unsolved;
+    }
+    FieldType blockedFields[] = {FieldType::slot, FieldType::classroom};
+    std::vector<Lit> kept;
+    for (int i = 0; i < data.courses.size(); i++) {
+        for (int f = 0; f < 2; f++) {
+            std::vector<Var> &vars = data.fieldValueVars[i][blockedFields[f]];
+            for (int j = 0; j < vars.size(); j++) {
+                if (isVarTrue(vars[j])) {
+                    kept.push_back(mkLit(vars[j]));
+                }
+            }
+        }
+    }
+    solver->blockModel(kept, minChanged);
+    model = solver->resumeSearch();
+    return getStatus();
+}
+
+/**
+ * @brief      Enumerates the best timetables after the one already solved,
+ * and writes each to a numbered output file.
+ *
+ * Each timetable differs from all those before it in at least the given
+ * number of slot and classroom assignments, see nextSolution(). The
+ * enumeration stops early if no timetable is left.
+ *
+ * @param[in]  count       The total number of timetables, including the one
+ * already solved
+ * @param[in]  minChanged  The minimum number of changed assignments
+ * @param[in]  fileName    The output file name, which is numbered for each
+ * timetable after the first
+ */
+void TimeTabler::enumerate(int count, int minChanged, std::string fileName) {
+    std::cout << "Timetable 1: cost " << modelCost(model) << ", written to "
+              << fileName << std::endl;
+    for (int k = 2; k <= count; k++) {
+        SolverStatus status = nextSolution(minChanged);
+        if (status != SolverStatus::Solved) {
+            std::cout << "No timetable " << k << " was found" << std::endl;
+            return;
+        }
+        std::string numberedFileName = Utils::getNumberedFileName(fileName, k);
+        writeOutput(numberedFileName);
+        std::cout << "Timetable " << k << ": cost " << solver->getCost()
+                  << ", written to " << numberedFileName << std::endl;
+    }
+}
+
+/**
+ * @brief      Gets the status of the current model.
+ *
+ * @return     The solver status
+ */
+SolverStatus TimeTabler::getStatus() {
     if (model.size() == 0) {
         return SolverStatus::Unsolved;
     }
@@ -129,6 +1317,356 @@ SolverStatus TimeTabler::solve() {
     return SolverStatus::HighLevelFailed;
 }
 
+/**
+ * @brief      Picks the courses of a neighbourhood to be rescheduled by the
+ * large neighbourhood search.
+ *
+ * The neighbourhood is one of the following, chosen by its kind: all the
+ * courses of a random Program, all the courses of a random Instructor, all the
+ * courses meeting on a random Day, or a random subset of a tenth of the
+ * courses.
+ *
+ * @param[in]  kind       The kind of the neighbourhood, from 0 to 3
+ * @param      generator  The random number generator
+ *
+ * @return     For each Course, whether it is in the neighbourhood
+ */
+std::vector<bool> TimeTabler::pickNeighbourhood(int kind,
+                                                std::mt19937 &generator) {
+    std::vector<bool> freed(data.courses.size(), false);
+    if (kind == 0 && data.programs.size() > 0) {
+        int program = std::uniform_int_distribution<int>(
+            0, data.programs.size() - 1)(generator);
+        for (int i = 0; i < data.courses.size(); i++) {
+            freed[i] = isVarTrue(data.fieldValueVars[i][FieldType::program]
+                                                    [program]);
+        }
+    } else if (kind == 1 && data.instructors.size() > 0) {
+        int instructor = std::uniform_int_distribution<int>(
+            0, data.instructors.size() - 1)(generator);
+        for (int i = 0; i < data.courses.size(); i++) {
+            freed[i] = isVarTrue(
+                data.fieldValueVars[i][FieldType::instructor][instructor]);
+        }
+    } else if (kind == 2) {
+        Day day = Day(std::uniform_int_distribution<int>(0, 6)(generator));
+        for (int i = 0; i < data.courses.size(); i++) {
+            for (int j = 0; j < data.slots.size(); j++) {
+                if (isVarTrue(data.fieldValueVars[i][FieldType::slot][j]) &&
+                    data.slots[j].isOnDay(day)) {
+                    freed[i] = true;
+                }
+            }
+        }
+    } else if (data.courses.size() > 0) {
+        int count = std::max<int>(1, data.courses.size() / 10);
+        std::uniform_int_distribution<int> pick(0, data.courses.size() - 1);
+        for (int i = 0; i < count; i++) {
+            freed[pick(generator)] = true;
+        }
+    }
+    return freed;
+}
+
+/**
+ * @brief      Builds the formula left once some variables are fixed, in which
+ * the fixed variables are replaced by their values.
+ *
+ * Clauses satisfied by the fixed values are left out, and the False literals
+ * are removed from the others.
+ *
+ * @param[in]  fixedValue  The value of each fixed variable, l_Undef for the
+ * variables that are not fixed
+ * @param      fixedCost   Set to the weight of the soft clauses falsified by
+ * the fixed values
+ *
+ * @return     The formula, owned by the caller
+ */
+MaxSATFormula *
+TimeTabler::buildNeighbourhoodFormula(const std::vector<lbool> &fixedValue,
+                                      uint64_t &fixedCost) {
+    MaxSATFormula *result = new MaxSATFormula();
+    result->setProblemType(_WEIGHTED_);
+    for (int i = 0; i < formula->nVars(); i++) {
+        result->newVar();
+    }
+    // gets the literals of a clause that are not fixed, unless one of the
+    // fixed literals is True
+    auto reduce = [&fixedValue](vec<Lit> &clause, vec<Lit> &free) {
+        for (int i = 0; i < clause.size(); i++) {
+            lbool value = fixedValue[var(clause[i])];
+            if (value == l_Undef) {
+                free.push(clause[i]);
+            } else if ((value == l_True) != sign(clause[i])) {
+                return false;
+            }
+        }
+        return true;
+    };
+    fixedCost = 0;
+    for (int i = 0; i < formula->nHard(); i++) {
+        vec<Lit> free;
+        if (reduce(formula->getHardClause(i).clause, free)) {
+            result->addHardClause(free);
+        }
+    }
+    for (int i = 0; i < formula->nSoft(); i++) {
+        Soft &soft = formula->getSoftClause(i);
+        vec<Lit> free;
+        if (!reduce(soft.clause, free)) {
+            continue;
+        }
+        if (free.size() == 0) {
+            fixedCost += soft.weight;
+        } else {
+            result->addSoftClause(soft.weight, free);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief      Solves the formula with some variables fixed, as a MaxSAT
+ * problem with its own solver.
+ *
+ * The formula with the fixed variables replaced by their values, see
+ * buildNeighbourhoodFormula(), is solved with stratified OLL, and seeded
+ * with the given literals.
+ *
+ * @param[in]  fixedValue  The value of each fixed variable, l_Undef for the
+ * variables that are not fixed
+ * @param[in]  seedLits    The literals of the seed, also used as phase hints
+ * @param[in]  budget      The conflict budget of each SAT call, zero for no
+ * budget
+ * @param[in]  seed        The seed of the budget retries
+ * @param      cost        Set to the cost of the model found over the whole
+ * formula
+ *
+ * @return     The model over the variables of the formula, the fixed ones
+ * included, which is empty if the hard clauses are unsatisfiable
+ */
+std::vector<lbool>
+TimeTabler::solveNeighbourhood(const std::vector<lbool> &fixedValue,
+                               const std::vector<Lit> &seedLits,
+                               int64_t budget, unsigned seed, uint64_t &cost) {
+    uint64_t fixedCost;
+    TSolver *neighbourhood = new TSolver(1, _CARD_TOTALIZER_);
+    configureSolver(neighbourhood);
+    neighbourhood->setAlgorithm(MaxSATAlgorithm::Stratified);
+    // the seed already gives a model at least as good as the local search
+    neighbourhood->setLocalSearch(0, seed);
+    neighbourhood->setResumable(false);
+    neighbourhood->setPersistent(false);
+    neighbourhood->setSATBudget(budget, options.satBudgetGrowth,
+                                options.satBudgetRetries, seed);
+    neighbourhood->setQuiet(true);
+    neighbourhood->loadFormula(
+        buildNeighbourhoodFormula(fixedValue, fixedCost));
+    neighbourhood->setPhaseHints(seedLits);
+    neighbourhood->addSeed("the seed", seedLits);
+    std::vector<lbool> found = neighbourhood->tSearch();
+    std::vector<lbool> result;
+    if (found.size() > 0) {
+        result = fixedValue;
+        for (int v = 0; v < result.size(); v++) {
+            if (result[v] == l_Undef) {
+                result[v] = v < found.size() ? found[v] : l_False;
+            }
+        }
+        cost = fixedCost + neighbourhood->getCost();
+    }
+    delete neighbourhood;
+    return result;
+}
+
+/**
+ * @brief      Gets the cost of a model, which is the weight of the soft
+ * clauses of the formula that it falsifies.
+ *
+ * @param[in]  values  The model
+ *
+ * @return     The cost
+ */
+uint64_t TimeTabler::modelCost(const std::vector<lbool> &values) {
+    uint64_t cost = 0;
+    for (int i = 0; i < formula->nSoft(); i++) {
+        Soft &soft = formula->getSoftClause(i);
+        bool satisfied = false;
+        for (int j = 0; j < soft.clause.size() && !satisfied; j++) {
+            Lit l = soft.clause[j];
+            satisfied = var(l) < values.size() &&
+                        values[var(l)] == (sign(l) ? l_False : l_True);
+        }
+        if (!satisfied) {
+            cost += soft.weight;
+        }
+    }
+    return cost;
+}
+
+/**
+ * @brief      Improves the solved timetable using large neighbourhood search.
+ *
+ * In each iteration, a neighbourhood of courses is picked, and the Slot,
+ * Segment and Classroom variables of every other Course are fixed to their
+ * values in the current model, as are the selectors of the enabled groups.
+ * The neighbourhood is solved as a MaxSAT problem by the solver of the first
+ * search, with the fixed values assumed, see TSolver::searchNeighbourhood(),
+ * so that it keeps what the solver learnt. It is seeded with the current
+ * model so that its upper bound starts at the current cost, and each SAT call
+ * is given the conflict budget of the large neighbourhood search. The solver
+ * stops with the best model found once the budget is exhausted. Improvements
+ * are kept, and the search stops once the time limit is reached.
+ *
+ * @param[in]  timeLimit  The time limit in seconds
+ * @param[in]  seed       The seed for picking the neighbourhoods
+ *
+ * @return     The status of the improved model
+ */
+SolverStatus TimeTabler::improve(double timeLimit, unsigned seed) {
+    if (model.size() == 0) {
+        return SolverStatus::Unsolved;
+    }
+    FieldType fixedFields[] = {FieldType::slot, FieldType::segment,
+                               FieldType::classroom};
+    std::mt19937 generator(seed);
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    std::vector<Lit> selectors = enabledSelectors();
+    uint64_t initialCost = modelCost(model);
+    uint64_t cost = initialCost;
+    int iterations = 0;
+    int improvements = 0;
+    while (cost > 0 &&
+           std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+                   .count() < timeLimit) {
+        std::vector<bool> freed = pickNeighbourhood(iterations % 4, generator);
+        iterations++;
+        if (std::find(freed.begin(), freed.end(), true) == freed.end()) {
+            continue;
+        }
+        std::vector<bool> isFixed(formula->nVars(), false);
+        std::vector<Lit> fixed(selectors);
+        for (int i = 0; i < selectors.size(); i++) {
+            isFixed[var(selectors[i])] = true;
+        }
+        for (int i = 0; i < data.courses.size(); i++) {
+            if (freed[i]) {
+                continue;
+            }
+            for (int f = 0; f < 3; f++) {
+                std::vector<Var> &vars = data.fieldValueVars[i][fixedFields[f]];
+                for (int j = 0; j < vars.size(); j++) {
+                    fixed.push_back(mkLit(vars[j], !isVarTrue(vars[j])));
+                    isFixed[vars[j]] = true;
+                }
+            }
+        }
+        std::vector<Lit> current;
+        for (int v = 0; v < formula->nVars() && v < model.size(); v++) {
+            if (!isFixed[v]) {
+                current.push_back(mkLit(v, model[v] == l_False));
+            }
+        }
+
+        std::vector<lbool> found =
+            solver->searchNeighbourhood(fixed, current, options.lnsBudget);
+        uint64_t foundCost = found.size() > 0 ? modelCost(found) : cost;
+        if (foundCost < cost) {
+            for (int v = 0; v < formula->nVars() && v < model.size(); v++) {
+                model[v] = found[v];
+            }
+            cost = foundCost;
+            improvements++;
+        }
+    }
+    std::cout << "Large neighbourhood search: " << iterations
+              << " neighbourhoods, " << improvements << " improvements, cost "
+              << initialCost << " -> " << cost << std::endl;
+    return getStatus();
+}
+
+/**
+ * @brief      Makes a timetable with the annealer instead of the MaxSAT
+ * solver.
+ *
+ * The annealer only takes into account the predefined constraints and the
+ * existing assignments. Its timetable fixes the Slot, Segment and Classroom
+ * of each Course, and the Instructor, IsMinor and Program given in the
+ * input, each with its high level variable True. The rest of the variables,
+ * such as those of the fields the annealer leaves unassigned and those added
+ * by the encoding of the constraints, are then found by solving the formula
+ * with these fixed, see solveNeighbourhood(). This checks the timetable
+ * against every hard clause, the custom constraints included, and gives a
+ * model over all the variables of the formula, which can be displayed and
+ * written like a solver model.
+ *
+ * @param[in]  timeLimit   The time limit of each chain in seconds
+ * @param[in]  seed        The seed
+ * @param[in]  chainCount  The number of chains run in parallel
+ *
+ * @return     The status of the timetable, Unsolved if it violates some hard
+ * clause
+ */
+SolverStatus TimeTabler::anneal(double timeLimit, unsigned seed,
+                                int chainCount) {
+    Annealer annealer(data);
+    annealer.run(timeLimit, seed, chainCount);
+    Penalty penalty = annealer.getPenalty();
+    std::cout << "Annealing: " << annealer.getMoves() << " moves, "
+              << penalty.hard << " hard violations, soft cost "
+              << penalty.soft << std::endl;
+    model.clear();
+    if (penalty.hard > 0) {
+        return getStatus();
+    }
+    std::vector<lbool> fixedValue(formula->nVars(), l_Undef);
+    std::vector<Lit> hints;
+    // fixes every value of a field, with the given ones True
+    auto fix = [&](int course, int field, const std::vector<int> &trueValues) {
+        std::vector<Var> &vars = data.fieldValueVars[course][field];
+        for (int k = 0; k < vars.size(); k++) {
+            fixedValue[vars[k]] = l_False;
+        }
+        for (int k = 0; k < trueValues.size(); k++) {
+            fixedValue[vars[trueValues[k]]] = l_True;
+        }
+        fixedValue[data.highLevelVars[course][field]] = l_True;
+    };
+    for (int i = 0; i < data.courses.size(); i++) {
+        int values[Global::FIELD_COUNT];
+        values[FieldType::instructor] = data.courses[i].getInstructor();
+        values[FieldType::segment] = annealer.getSegment(i);
+        values[FieldType::isMinor] = data.courses[i].getIsMinor();
+        values[FieldType::program] = -1;
+        values[FieldType::classroom] = annealer.getClassroom(i);
+        values[FieldType::slot] = annealer.getSlot(i);
+        for (int j = 0; j < Global::FIELD_COUNT; j++) {
+            if (j == FieldType::program) {
+                fix(i, j, data.courses[i].getPrograms());
+            } else if (values[j] != -1) {
+                fix(i, j, std::vector<int>(1, values[j]));
+            } else {
+                // left to the solver, which prefers the high level variable
+                // True
+                hints.push_back(mkLit(data.highLevelVars[i][j]));
+            }
+        }
+    }
+    uint64_t cost;
+    model = solveNeighbourhood(fixedValue, hints, options.satBudget, seed,
+                               cost);
+    if (model.size() == 0) {
+        std::cout << "The annealed timetable violates the hard clauses"
+                  << std::endl;
+    } else {
+        std::cout << "The annealed timetable satisfies the hard clauses, cost "
+                  << cost << std::endl;
+    }
+    return getStatus();
+}
+
 /**
  * @brief      Checks if a given set of variables are true in the model returned
  * by the solver.
@@ -170,9 +1708,15 @@ bool TimeTabler::isVarTrue(const Var &v) {
 /**
  * @brief      Calls the formula to issue a new variable and returns it.
  *
+ * Once the formula is loaded into the solver, the variable is also made in
+ * the SAT solver.
+ *
  * @return     The new Var added to the formula
  */
 Var TimeTabler::newVar() {
+    if (solverLoaded) {
+        return solver->newVar();
+    }
     Var var = formula->nVars();
     formula->newVar();
     return var;
@@ -181,12 +1725,18 @@ Var TimeTabler::newVar() {
 /**
  * @brief      Calls the formula to issue a new literal and returns it.
  *
+ * Once the formula is loaded into the solver, the variable is also made in
+ * the SAT solver.
+ *
  * @param[in]  sign  The sign, whether the literal contains a sign with the
  * variable
  *
  * @return     The Lit corresponding to the new Var added to the formula
  */
 Lit TimeTabler::newLiteral(bool sign = false) {
+    if (solverLoaded) {
+        return mkLit(solver->newVar(), sign);
+    }
     Lit p = mkLit(formula->nVars(), sign);
     formula->newVar();
     return p;
@@ -371,6 +1921,9 @@ void TimeTabler::displayUnsatisfiedOutputReasons() {
 }
 
 /**
- * @brief      Destroys the object, and deletes the solver.
+ * @brief      Destroys the object, and deletes the solver and the state.
  */
-TimeTabler::~TimeTabler() { delete solver; }
+TimeTabler::~TimeTabler() {
+    delete solver;
+    delete state;
+}
@@ -0,0 +1,64 @@
+#include "tsat_solver.h"
+
+#include "core/Solver.h"
+#include "core/SolverTypes.h"
+#include <vector>
+
+using namespace NSPACE;
+
+/**
+ * @brief      Gets the learnt clauses over the first variables.
+ *
+ * The literals fixed at the top level are given as unit clauses, followed by
+ * the learnt clauses of at most the given length. Clauses with a literal of a
+ * later variable, such as a relaxation variable or a totalizer output, are
+ * left out.
+ *
+ * @param[in]  maxLength  The maximum length of a learnt clause
+ * @param[in]  varCount   The number of variables that the clauses may use
+ *
+ * @return     The clauses
+ */
+std::vector<std::vector<Lit>> TSATSolver::getLearnts(int maxLength,
+                                                     Var varCount) {
+    std::vector<std::vector<Lit>> result;
+    int units = trail_lim.size() > 0 ? trail_lim[0] : trail.size();
+    for (int i = 0; i < units; i++) {
+        if (var(trail[i]) < varCount) {
+            result.push_back(std::vector<Lit>(1, trail[i]));
+        }
+    }
+    for (int i = 0; i < learnts.size(); i++) {
+        const Clause &c = ca[learnts[i]];
+        if (c.size() > maxLength) {
+            continue;
+        }
+        std::vector<Lit> clause;
+        for (int j = 0; j < c.size() && var(c[j]) < varCount; j++) {
+            clause.push_back(c[j]);
+        }
+        if (clause.size() == c.size()) {
+            result.push_back(clause);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief      Sets the VSIDS activity of a variable, which moves it in the
+ * order in which the variables are decided.
+ *
+ * @param[in]  v      The variable
+ * @param[in]  value  The activity
+ */
+void TSATSolver::setActivity(Var v, double value) {
+    bool raised = value > activity[v];
+    activity[v] = value;
+    if (order_heap.inHeap(v)) {
+        if (raised) {
+            order_heap.decrease(v);
+        } else {
+            order_heap.increase(v);
+        }
+    }
+}
@@ -33,46 +33,1886 @@
 #include "tsolver.h"
 
 #include "algorithms/Alg_OLL.h"
+#include "instance_features.h"
+#include "local_search.h"
 #include "mtl/Vec.h"
+#include "tsat_solver.h"
 #include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifndef SAT_SOLVER_NAME
+#define SAT_SOLVER_NAME "minisat2.2"
+#endif
+
+using namespace NSPACE;
+using namespace openwbo;
+
+/**
+ * @brief      Constructs the TSolver object.
+ *
+ * @param[in]  verb  The verbosity value to be given to the OLL object
+ * @param[in]  enc   The encoding value to be given to the OLL object
+ */
+TSolver::TSolver(int verb = _VERBOSITY_MINIMAL_, int enc = _CARD_TOTALIZER_)
+    : OLL(verb, enc) {
+    nbOriginalSoft = 0;
+    seedBudget = 10000;
+    quiet = false;
+    currentLevel = -1;
+    resumable = false;
+    coresInvalid = false;
+    persistent = false;
+    nbOriginalVars = 0;
+    knownLowerBound = 0;
+    satBudget = 0;
+    satBudgetGrowth = 2;
+    satBudgetRetries = 3;
+    currentBudget = 0;
+    budgetedCalls = 0;
+    exhaustedCalls = 0;
+    budgetStopped = false;
+    inNeighbourhood = false;
+    coreBoostCores = 0;
+    coreBoostTime = 10;
+    boosting = false;
+    boundsAdded = false;
+    algorithm = MaxSATAlgorithm::Auto;
+    selectedAlgorithm = MaxSATAlgorithm::Auto;
+    hardeningWeight = UINT64_MAX;
+    localSearchFlips = 0;
+    localSearchSeed = 0;
+    coreTrimming = false;
+    coreMinimization = false;
+    coreExhaustion = false;
+    coreBudget = 1000;
+    trimCalls = 0;
+    trimmedLits = 0;
+    minimizeCalls = 0;
+    minimizedLits = 0;
+    exhaustCalls = 0;
+    exhaustedBounds = 0;
+}
+
+/**
+ * @brief      Destroys the object, and deletes the cardinality encoders.
+ */
+TSolver::~TSolver() { clearCoreState(); }
+
+/**
+ * @brief      Sets the phase hints to be used by the SAT solver.
+ *
+ * Each literal gives the polarity that the SAT solver tries first for its
+ * variable.
+ *
+ * @param[in]  hints  The hint literals
+ */
+void TSolver::setPhaseHints(const std::vector<Lit> &hints) {
+    phaseHints = hints;
+}
+
+/**
+ * @brief      Gives the phase hints to the SAT solver as its initial
+ * polarities.
+ */
+void TSolver::applyPhaseHints() {
+    for (int i = 0; i < phaseHints.size(); i++) {
+        if (var(phaseHints[i]) < solver->nVars()) {
+            solver->setPolarity(var(phaseHints[i]), sign(phaseHints[i]));
+        }
+    }
+}
+
+/**
+ * @brief      Sets the branching priorities of the variables, which are given
+ * to the SAT solver as their initial VSIDS activities.
+ *
+ * The variables with the highest priorities are decided first, until the
+ * conflicts have bumped the activities of others past them. A priority of
+ * zero leaves the variable to the SAT solver.
+ *
+ * @param[in]  priorities  The priority of each variable
+ */
+void TSolver::setBranchingPriorities(const std::vector<double> &priorities) {
+    branchingPriorities = priorities;
+}
+
+/**
+ * @brief      Gives the branching priorities to the SAT solver.
+ */
+void TSolver::applyBranchingPriorities() {
+    TSATSolver *S = static_cast<TSATSolver *>(solver);
+    for (int i = 0; i < branchingPriorities.size() && i < S->nVars(); i++) {
+        if (branchingPriorities[i] > 0) {
+            S->setActivity(i, branchingPriorities[i]);
+        }
+    }
+}
+
+/**
+ * @brief      Adds a seed, which is a set of literals under which a model is
+ * searched for before the search, to give the initial upper bound.
+ *
+ * @param[in]  name  The name of the seed, printed with the cost of its model
+ * @param[in]  lits  The literals
+ */
+void TSolver::addSeed(const std::string &name, const std::vector<Lit> &lits) {
+    if (lits.size() > 0) {
+        seedNames.push_back(name);
+        seeds.push_back(lits);
+    }
+}
+
+/**
+ * @brief      Sets the conflict budget of each SAT call made to seed the
+ * upper bound.
+ *
+ * @param[in]  budget  The conflict budget
+ */
+void TSolver::setSeedBudget(int64_t budget) { seedBudget = budget; }
+
+/**
+ * @brief      Sets whether the search prints nothing.
+ *
+ * @param[in]  quiet  True if nothing is printed, False otherwise
+ */
+void TSolver::setQuiet(bool quiet) { this->quiet = quiet; }
+
+/**
+ * @brief      Seeds the upper bound from the seeds and the phase hints.
+ *
+ * Each seed is given to the SAT solver as assumptions, within the seed budget,
+ * and the cheapest model found is saved, its cost being the initial upper
+ * bound. If no seed gives a model, as the seeds may contradict the hard
+ * clauses, a model is searched for without assumptions, which follows the
+ * polarities of the phase hints.
+ */
+void TSolver::seedUpperBound() {
+    if (seeds.size() == 0 && phaseHints.size() == 0) {
+        return;
+    }
+    vec<lbool> found;
+    for (int s = 0; s < seeds.size(); s++) {
+        vec<Lit> seedAssumptions;
+        for (int i = 0; i < seeds[s].size(); i++) {
+            if (var(seeds[s][i]) < solver->nVars()) {
+                seedAssumptions.push(seeds[s][i]);
+            }
+        }
+        if (solveWithBudget(seedAssumptions, seedBudget, found) != l_True) {
+            if (!quiet) {
+                std::cout << "No model seeded from " << seedNames[s]
+                          << std::endl;
+            }
+            continue;
+        }
+        uint64_t cost = computeCostModel(found);
+        if (!quiet) {
+            std::cout << "Seeded from " << seedNames[s] << ", cost " << cost
+                      << std::endl;
+        }
+        if (model.size() == 0 || cost < ubCost) {
+            saveModel(found);
+            ubCost = cost;
+        }
+    }
+    if (model.size() > 0) {
+        return;
+    }
+    vec<Lit> noAssumptions;
+    if (solveWithBudget(noAssumptions, seedBudget, found) == l_True) {
+        saveModel(found);
+        ubCost = computeCostModel(found);
+    }
+}
+
+/**
+ * @brief      Sets the MaxSAT algorithm used by tSearch().
+ *
+ * @param[in]  value  The algorithm, or MaxSATAlgorithm::Auto to pick it from
+ * the features of the instance
+ */
+void TSolver::setAlgorithm(MaxSATAlgorithm value) { algorithm = value; }
+
+/**
+ * @brief      Sets the objective level of each soft clause, to optimize the
+ * levels lexicographically instead of optimizing the total weight.
+ *
+ * @param[in]  levels  The level of each soft clause, 0 being the most
+ * important, or empty to optimize the total weight
+ */
+void TSolver::setObjectiveLevels(const std::vector<int> &levels) {
+    softLevel = levels;
+}
+
+/**
+ * @brief      Gets the optimal cost of each objective level, after a
+ * lexicographic search.
+ *
+ * @return     The costs, indexed by level
+ */
+std::vector<uint64_t> TSolver::getLevelCosts() { return levelCosts; }
+
+/**
+ * @brief      Checks whether a soft clause is part of the current search, which
+ * is when no level is being optimized or it is of the level being optimized.
+ *
+ * @param[in]  index  The index of the soft clause
+ *
+ * @return     True if the soft clause is searched, False otherwise
+ */
+bool TSolver::isSearched(int index) {
+    return currentLevel == -1 || softLevel[index] == currentLevel;
+}
+
+/**
+ * @brief      Computes the cost of a model over the soft clauses of the
+ * current search.
+ *
+ * @param      currentModel  The model
+ *
+ * @return     The total weight of the searched soft clauses that the model
+ * does not satisfy
+ */
+uint64_t TSolver::searchCost(vec<lbool> &currentModel) {
+    if (currentLevel == -1) {
+        return computeCostModel(currentModel);
+    }
+    uint64_t cost = 0;
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+        if (!isSearched(i)) {
+            continue;
+        }
+        vec<Lit> &clause = maxsat_formula->getSoftClause(i).clause;
+        bool satisfied = false;
+        for (int j = 0; j < clause.size() && !satisfied; j++) {
+            satisfied = (currentModel[var(clause[j])] ^ sign(clause[j])) ==
+                        l_True;
+        }
+        if (!satisfied) {
+            cost += maxsat_formula->getSoftClause(i).weight;
+        }
+    }
+    return cost;
+}
+
+/**
+ * @brief      Sets whether the search is kept resumable after the optimum is
+ * found, so that more models can be found with resumeSearch().
+ *
+ * Soft clauses are then not hardened, and the search does not stop as soon
+ * as the bounds meet. Both would leave the solver in a state that is no longer
+ * valid once the optimum is blocked.
+ *
+ * @param[in]  value  Whether the search is resumable
+ */
+void TSolver::setResumable(bool value) { resumable = value; }
+
+/**
+ * @brief      Sets whether the search is kept persistent, so that its learnt
+ * clauses and cores can be saved for later runs.
+ *
+ * A persistent search does not harden soft clauses, as the hardened clauses
+ * only hold for the upper bound of this run, and the learnt clauses derived
+ * from them would not hold for the hard clauses alone.
+ *
+ * @param[in]  value  Whether the search is persistent
+ */
+void TSolver::setPersistent(bool value) { persistent = value; }
+
+/**
+ * @brief      Sets a lower bound on the optimal cost, such as one proven by an
+ * earlier run. The search stops as soon as it finds a model of this cost.
+ *
+ * @param[in]  bound  The lower bound
+ */
+void TSolver::setKnownLowerBound(uint64_t bound) { knownLowerBound = bound; }
+
+/**
+ * @brief      Gets the clauses learnt by a persistent search over the
+ * variables of the formula.
+ *
+ * These are the cores found over unit soft clauses, the literals fixed at the
+ * top level and the learnt clauses of the SAT solver of at most the given
+ * length. The hard clauses imply all of them. Once bounds on the objective
+ * were added to the SAT solver, only the cores are given.
+ *
+ * @param[in]  maxLength  The maximum length of a learnt clause
+ *
+ * @return     The clauses, empty if the search is not persistent
+ */
+std::vector<std::vector<Lit>> TSolver::getLearnts(int maxLength) {
+    if (!persistent || solver == NULL) {
+        return std::vector<std::vector<Lit>>();
+    }
+    std::vector<std::vector<Lit>> clauses(recordedCores);
+    if (boundsAdded) {
+        return clauses;
+    }
+    std::vector<std::vector<Lit>> learnts =
+        static_cast<TSATSolver *>(solver)->getLearnts(maxLength,
+                                                      nbOriginalVars);
+    clauses.insert(clauses.end(), learnts.begin(), learnts.end());
+    return clauses;
+}
+
+/**
+ * @brief      Gets the lower bound on the optimal cost proven by the search.
+ *
+ * @return     The lower bound
+ */
+uint64_t TSolver::getLowerBound() {
+    return std::max(lbCost, knownLowerBound);
+}
+
+/**
+ * @brief      Records a core found over unit soft clauses.
+ *
+ * The soft clauses of the core cannot all be satisfied, so the hard clauses
+ * imply the clause of the negations of their literals. This is only kept for
+ * a persistent search, and not in a neighbourhood, where the core may need
+ * the fixed literals.
+ *
+ * @param[in]  core  The core
+ */
+void TSolver::recordCore(const vec<Lit> &core) {
+    if (!persistent || inNeighbourhood || core.size() == 0) {
+        return;
+    }
+    std::vector<Lit> clause;
+    for (int i = 0; i < core.size(); i++) {
+        int index = softClauseOf(core[i]);
+        if (index == -1) {
+            return;
+        }
+        const vec<Lit> &soft = maxsat_formula->getSoftClause(index).clause;
+        if (soft.size() != 1 || var(soft[0]) >= nbOriginalVars) {
+            return;
+        }
+        clause.push_back(~soft[0]);
+    }
+    recordedCores.push_back(clause);
+}
+
+/**
+ * @brief      Blocks the current model, by requiring that at least a given
+ * number of the literals it satisfies become False.
+ *
+ * @param[in]  kept        The literals, which are True in the current model
+ * @param[in]  minChanged  The number of literals that must become False
+ */
+void TSolver::blockModel(const std::vector<Lit> &kept, int minChanged) {
+    vec<Lit> lits;
+    for (int i = 0; i < kept.size(); i++) {
+        lits.push(kept[i]);
+    }
+    if (minChanged > lits.size()) {
+        // no model can change that many, so none is left
+        solver->addClause(vec<Lit>());
+    } else if (minChanged <= 1) {
+        vec<Lit> clause;
+        for (int i = 0; i < lits.size(); i++) {
+            clause.push(~lits[i]);
+        }
+        solver->addClause(clause);
+    } else {
+        Encoder e(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_);
+        e.encodeCardinality(solver, lits, lits.size() - minChanged);
+    }
+}
+
+/**
+ * @brief      Resumes the search after models were blocked or the formula was
+ * changed, to find the best model that is left.
+ *
+ * The cores and totalizers of the previous searches are still valid after
+ * hard clauses, soft clauses or enabled selectors are added, so the search
+ * carries on from them instead of starting over. If a selector that took part
+ * in a core was disabled, the cores are dropped and the soft clauses are
+ * relaxed again, on the same SAT solver.
+ *
+ * @return     The model found, empty if no model is left
+ */
+std::vector<lbool> TSolver::resumeSearch() {
+    assert(resumable);
+    restartCores();
+    model.clear();
+    ubCost = UINT64_MAX;
+    vec<Lit> noAssumptions;
+    if (searchSATSolver(solver, noAssumptions) != l_True) {
+        return std::vector<lbool>();
+    }
+    tWeighted(selectedAlgorithm == MaxSATAlgorithm::Stratified);
+    return Utils::convertVecDataToVector<lbool>(model, model.size());
+}
+
+/**
+ * @brief      Drops the cores of the previous searches once they no longer
+ * hold, see setSelectors().
+ */
+void TSolver::restartCores() {
+    if (!coresInvalid) {
+        return;
+    }
+    // the soft clauses are relaxed afresh, while the learnt clauses and the
+    // clauses of the old totalizers stay in the SAT solver
+    clearCoreState();
+    activeSoft.clear();
+    activeSoft.growTo(maxsat_formula->nSoft(), false);
+    for (int i = 0; i < maxsat_formula->nSoft(); i++)
+        mapSoftClause(i);
+    lbCost = 0;
+    coreSelectors.clear();
+    coresInvalid = false;
+}
+
+/**
+ * @brief      Searches for a better model with some literals fixed, on the
+ * SAT solver of the previous search, for a neighbourhood of the large
+ * neighbourhood search.
+ *
+ * The fixed literals are assumed in every SAT call, as the selectors are, and
+ * are no longer assumed once the search is over. The neighbourhood thus keeps
+ * the learnt clauses of the previous searches, and their cores as long as
+ * none of them needed a fixed literal. Such a core only holds in its
+ * neighbourhood, so the cores are then dropped at the next search, as when a
+ * selector is disabled. The search starts from the model of the seed, which
+ * satisfies the fixed literals, and stops with the best model found once a
+ * SAT call runs out of the budget.
+ *
+ * @param[in]  fixed     The fixed literals
+ * @param[in]  seedLits  The literals of the seed
+ * @param[in]  budget    The conflict budget of each SAT call
+ *
+ * @return     The best model found, empty if the seed gives no model within
+ * the budget
+ */
+std::vector<lbool>
+TSolver::searchNeighbourhood(const std::vector<Lit> &fixed,
+                             const std::vector<Lit> &seedLits,
+                             int64_t budget) {
+    if (!resumable) {
+        // the cores of a search that was not resumable, such as those of
+        // MSU3 or of linear search, cannot be carried on by tWeighted()
+        resumable = true;
+        coresInvalid = true;
+    }
+    std::vector<Lit> selectors =
+        Utils::convertVecDataToVector<Lit>(selectorAssumptions,
+                                           selectorAssumptions.size());
+    std::vector<Lit> assumed(selectors);
+    assumed.insert(assumed.end(), fixed.begin(), fixed.end());
+    setSelectors(assumed);
+    restartCores();
+
+    model.clear();
+    ubCost = UINT64_MAX;
+    vec<Lit> seedAssumptions;
+    for (int i = 0; i < seedLits.size(); i++) {
+        if (var(seedLits[i]) < solver->nVars()) {
+            seedAssumptions.push(seedLits[i]);
+        }
+    }
+    vec<lbool> found;
+    if (solveWithBudget(seedAssumptions, budget, found) == l_True) {
+        saveModel(found);
+        ubCost = computeCostModel(found);
+        int64_t savedBudget = satBudget;
+        int64_t savedCurrentBudget = currentBudget;
+        bool savedStopped = budgetStopped;
+        satBudget = budget;
+        currentBudget = budget;
+        inNeighbourhood = true;
+        tWeighted(true);
+        inNeighbourhood = false;
+        satBudget = savedBudget;
+        currentBudget = savedCurrentBudget;
+        budgetStopped = savedStopped;
+    }
+    setSelectors(selectors);
+    return Utils::convertVecDataToVector<lbool>(model, model.size());
+}
+
+/**
+ * @brief      Calls the SAT solver under the given assumptions and the
+ * assumed selectors.
+ *
+ * This hides MaxSAT::searchSATSolver(), so that every SAT call made by this
+ * class keeps the enabled constraint groups switched on. The selectors that
+ * appear in a conflict are recorded and removed from it, as the cores built
+ * from it only hold while they stay assumed.
+ *
+ * @param      S            The SAT solver
+ * @param      assumptions  The assumptions
+ * @param[in]  pre          Whether the SAT solver preprocesses the formula
+ *
+ * @return     The result of the SAT call
+ */
+lbool TSolver::searchSATSolver(Solver *S, vec<Lit> &assumptions, bool pre) {
+    if (selectorAssumptions.size() == 0) {
+        return MaxSAT::searchSATSolver(S, assumptions, pre);
+    }
+    vec<Lit> allAssumptions;
+    selectorAssumptions.copyTo(allAssumptions);
+    for (int i = 0; i < assumptions.size(); i++) {
+        allAssumptions.push(assumptions[i]);
+    }
+    lbool res = MaxSAT::searchSATSolver(S, allAssumptions, pre);
+    if (res == l_False) {
+        // the selectors are taken out of the conflict, which is then a core
+        // over the other assumptions only
+        int kept = 0;
+        for (int i = 0; i < S->conflict.size(); i++) {
+            if (assumedSelectors.count(var(S->conflict[i])) > 0) {
+                coreSelectors.insert(var(S->conflict[i]));
+            } else {
+                S->conflict[kept++] = S->conflict[i];
+            }
+        }
+        S->conflict.shrink(S->conflict.size() - kept);
+    }
+    return res;
+}
+
+/**
+ * @brief      Sets the selectors assumed True in every SAT call, which are
+ * those of the enabled constraint groups.
+ *
+ * If a selector that took part in a core is no longer assumed, the cores are
+ * dropped at the next call to resumeSearch().
+ *
+ * @param[in]  selectors  The selectors
+ */
+void TSolver::setSelectors(const std::vector<Lit> &selectors) {
+    std::set<Var> next;
+    for (int i = 0; i < selectors.size(); i++) {
+        next.insert(var(selectors[i]));
+    }
+    for (auto it = coreSelectors.begin(); it != coreSelectors.end(); it++) {
+        if (next.count(*it) == 0) {
+            coresInvalid = true;
+        }
+    }
+    assumedSelectors = next;
+    selectorAssumptions.clear();
+    for (int i = 0; i < selectors.size(); i++) {
+        selectorAssumptions.push(selectors[i]);
+    }
+}
+
+/**
+ * @brief      Creates a new variable after the SAT solver is built, in both
+ * the formula and the SAT solver.
+ *
+ * @return     The variable
+ */
+Var TSolver::newVar() {
+    // the encoders add variables to the SAT solver only
+    while (maxsat_formula->nVars() < solver->nVars())
+        maxsat_formula->newLiteral();
+    Lit l = maxsat_formula->newLiteral();
+    newSATVariable(solver);
+    return var(l);
+}
+
+/**
+ * @brief      Adds a hard clause after the SAT solver is built.
+ *
+ * @param      clause  The clause
+ */
+void TSolver::addHardClause(vec<Lit> &clause) {
+    maxsat_formula->addHardClause(clause);
+    solver->addClause(clause);
+}
+
+/**
+ * @brief      Adds a soft clause after the SAT solver is built, relaxed by a
+ * new variable, so that the next search takes it into account.
+ *
+ * @param[in]  weight  The weight
+ * @param      clause  The clause
+ */
+void TSolver::addSoftClause(uint64_t weight, vec<Lit> &clause) {
+    Lit r = mkLit(newVar());
+    vec<Lit> vars;
+    vars.push(r);
+    maxsat_formula->addSoftClause(weight, clause, vars);
+    int index = maxsat_formula->nSoft() - 1;
+    maxsat_formula->getSoftClause(index).assumption_var = r;
+    activeSoft.push(false);
+    mapSoftClause(index);
+    if (softLevel.size() > 0)
+        softLevel.push_back(0);
+    vec<Lit> relaxed;
+    clause.copyTo(relaxed);
+    relaxed.push(r);
+    solver->addClause(relaxed);
+}
+
+/**
+ * @brief      Enables the local search run before the exact search.
+ *
+ * @param[in]  flips  The maximum number of flips, zero to disable it
+ * @param[in]  seed   The seed of the local search
+ */
+void TSolver::setLocalSearch(uint64_t flips, unsigned seed) {
+    localSearchFlips = flips;
+    localSearchSeed = seed;
+}
+
+/**
+ * @brief      Runs the local search on the formula, starting from the phase
+ * hints.
+ *
+ * This must be called before the formula is modified by the search, so that
+ * the local search sees the original soft clauses and weights.
+ */
+void TSolver::runLocalSearch() {
+    initialModel.clear();
+    // the local search cannot keep the selectors assumed, and would disable
+    // every guarded constraint
+    if (localSearchFlips == 0 || selectorAssumptions.size() > 0) {
+        return;
+    }
+    LocalSearch localSearch(maxsat_formula, localSearchSeed);
+    localSearch.setInitialAssignment(phaseHints);
+    if (localSearch.search(localSearchFlips)) {
+        initialModel = localSearch.getBestModel();
+    }
+}
+
+/**
+ * @brief      Gives the model found by the local search to the SAT solver.
+ *
+ * The model is used as the initial polarity of every variable, and if it is
+ * better than the model seeded from the phase hints, it is saved and its cost
+ * is used as the upper bound.
+ */
+void TSolver::applyInitialModel() {
+    if (initialModel.size() == 0) {
+        return;
+    }
+    vec<lbool> currentModel;
+    for (int i = 0; i < initialModel.size(); i++) {
+        currentModel.push(initialModel[i]);
+        if (i < solver->nVars()) {
+            solver->setPolarity(i, initialModel[i] == l_False);
+        }
+    }
+    uint64_t cost = computeCostModel(currentModel);
+    if (model.size() == 0 || cost < ubCost) {
+        saveModel(currentModel);
+        ubCost = cost;
+    }
+}
+
+/**
+ * @brief      Solves the MaxSAT problem by calling the solver
+ *
+ * This is a modification of the search() function in the OLL algorithm of
+ * Open WBO. Most of the code is identical, except that it expects the problem
+ * to be weighted and returns the model found by the solver instead of exiting
+ * at the end.
+ *
+ * The algorithm is the one set with setAlgorithm(), or is picked from the
+ * features of the instance, see InstanceFeatures::selectAlgorithm(). MSU3 and
+ * linear search are replaced by stratified OLL when they would not be exact,
+ * and MSU3, linear search and the core-boosted search are replaced by it when
+ * the search is resumable.
+ * If objective levels were set, the levels are instead optimized one after
+ * another with tLexicographic().
+ *
+ * @return     The model found by the solver. This could be empty if the problem
+ * was unsatisfiable
+ */
+std::vector<lbool> TSolver::tSearch() {
+    if (encoding != _CARD_TOTALIZER_) {
+        printf("Error: Currently algorithm MSU3 with iterative encoding only "
+               "supports the totalizer encoding.\n");
+        printf("s UNKNOWN\n");
+        exit(_ERROR_);
+    }
+
+    if (maxsat_formula->getProblemType() == _WEIGHTED_) {
+        InstanceFeatures features(maxsat_formula);
+        if (!quiet) {
+            features.print();
+        }
+        selectedAlgorithm = algorithm == MaxSATAlgorithm::Auto
+                                ? features.selectAlgorithm()
+                                : algorithm;
+        std::string mode = "";
+        if (softLevel.size() > 0) {
+            // each level is solved with stratified OLL
+            assert(softLevel.size() == maxsat_formula->nSoft());
+            selectedAlgorithm = MaxSATAlgorithm::Stratified;
+            mode = "lexicographic ";
+        } else if ((selectedAlgorithm == MaxSATAlgorithm::MSU3 &&
+                    features.weights.size() > 1) ||
+                   (selectedAlgorithm == MaxSATAlgorithm::LinearSearch &&
+                    features.weights.size() > 1 && !features.lexicographic)) {
+            if (!quiet) {
+                std::cout << "The " << algorithmName(selectedAlgorithm)
+                          << " algorithm is not exact for these weights, "
+                             "using "
+                          << algorithmName(MaxSATAlgorithm::Stratified)
+                          << " instead" << std::endl;
+            }
+            selectedAlgorithm = MaxSATAlgorithm::Stratified;
+        }
+        if (resumable && (selectedAlgorithm == MaxSATAlgorithm::MSU3 ||
+                          selectedAlgorithm == MaxSATAlgorithm::LinearSearch ||
+                          selectedAlgorithm == MaxSATAlgorithm::CoreBoosted)) {
+            // only OLL is resumed by resumeSearch()
+            selectedAlgorithm = MaxSATAlgorithm::Stratified;
+        }
+        if (!quiet) {
+            std::cout << "Algorithm: " << mode
+                      << algorithmName(selectedAlgorithm) << std::endl;
+        }
+
+        prepareSearch();
+        clearCoreState();
+        activeSoft.growTo(maxsat_formula->nSoft(), false);
+        for (int i = 0; i < maxsat_formula->nSoft(); i++)
+            mapSoftClause(i);
+        if (model.size() > 0 && softLevel.size() == 0 &&
+            ubCost <= knownLowerBound) {
+            if (!quiet) {
+                std::cout << "The seeded model meets the known lower bound"
+                          << std::endl;
+            }
+            lbCost = ubCost;
+        } else if (softLevel.size() > 0) {
+            tLexicographic();
+        } else if (selectedAlgorithm == MaxSATAlgorithm::MSU3) {
+            tMSU3();
+        } else if (selectedAlgorithm == MaxSATAlgorithm::LinearSearch) {
+            tLinear();
+        } else if (selectedAlgorithm == MaxSATAlgorithm::CoreBoosted) {
+            tCoreBoosted();
+        } else {
+            tWeighted(selectedAlgorithm == MaxSATAlgorithm::Stratified);
+        }
+        return Utils::convertVecDataToVector<lbool>(model, model.size());
+    } else {
+        printf("Error: Use the solver in 'weighted' mode only!\n");
+        exit(_ERROR_);
+    }
+}
+
+/**
+ * @brief      Grows the variable indexed arrays of the core bookkeeping so
+ * that they can be indexed by a given variable.
+ *
+ * @param[in]  v     The variable
+ */
+void TSolver::growVarArrays(Var v) {
+    if (v < softOfVar.size()) {
+        return;
+    }
+    int size = std::max<int>(v + 1, solver->nVars());
+    softOfVar.resize(size, -1);
+    boundEncoder.resize(size, -1);
+    boundValue.resize(size, 0);
+    boundWeight.resize(size, 0);
+    boundOutputPosition.resize(size, -1);
+    assumptionPosition.resize(size, -1);
+    hardened.resize(size, false);
+}
+
+/**
+ * @brief      Records a soft clause as the one relaxed by its assumption
+ * variable.
+ *
+ * @param[in]  index  The index of the soft clause
+ */
+void TSolver::mapSoftClause(int index) {
+    Var v = var(maxsat_formula->getSoftClause(index).assumption_var);
+    growVarArrays(v);
+    softOfVar[v] = index;
+}
+
+/**
+ * @brief      Gets the soft clause relaxed by the variable of a literal.
+ *
+ * @param[in]  l     The literal
+ *
+ * @return     The index of the soft clause, -1 if there is none
+ */
+int TSolver::softClauseOf(Lit l) {
+    return var(l) < softOfVar.size() ? softOfVar[var(l)] : -1;
+}
+
+/**
+ * @brief      Determines if a literal is an output of a cardinality encoder
+ * whose bound is being enforced.
+ *
+ * @param[in]  l     The literal
+ *
+ * @return     True if it is a bound output, False otherwise
+ */
+bool TSolver::isBoundOutput(Lit l) {
+    return var(l) < boundEncoder.size() && boundEncoder[var(l)] != -1;
+}
+
+/**
+ * @brief      Adds the negation of a literal to the assumptions, unless it is
+ * already assumed.
+ *
+ * @param[in]  l     The literal
+ */
+void TSolver::addAssumption(Lit l) {
+    growVarArrays(var(l));
+    if (assumptionPosition[var(l)] != -1) {
+        return;
+    }
+    assumptionPosition[var(l)] = coreAssumptions.size();
+    coreAssumptions.push(~l);
+}
+
+/**
+ * @brief      Removes the assumption on the variable of a literal, if any.
+ *
+ * The last assumption is moved into its place, so this takes constant time.
+ *
+ * @param[in]  l     The literal
+ */
+void TSolver::removeAssumption(Lit l) {
+    if (var(l) >= assumptionPosition.size() ||
+        assumptionPosition[var(l)] == -1) {
+        return;
+    }
+    int position = assumptionPosition[var(l)];
+    Lit last = coreAssumptions.last();
+    coreAssumptions[position] = last;
+    assumptionPosition[var(last)] = position;
+    coreAssumptions.pop();
+    assumptionPosition[var(l)] = -1;
+}
+
+/**
+ * @brief      Adds an output of a cardinality encoder whose bound is to be
+ * enforced, and assumes it False if its weight is being considered.
+ *
+ * @param[in]  out      The output literal
+ * @param[in]  encoder  The index of the cardinality encoder
+ * @param[in]  bound    The bound enforced by the output
+ * @param[in]  weight   The weight of violating the bound
+ */
+void TSolver::addBoundOutput(Lit out, int encoder, uint64_t bound,
+                             uint64_t weight) {
+    growVarArrays(var(out));
+    boundEncoder[var(out)] = encoder;
+    boundValue[var(out)] = bound;
+    boundWeight[var(out)] = weight;
+    boundOutputPosition[var(out)] = boundOutputs.size();
+    boundOutputs.push_back(out);
+    if (weight >= min_weight) {
+        addAssumption(out);
+    }
+}
+
+/**
+ * @brief      Removes an output of a cardinality encoder once its bound has
+ * been relaxed.
+ *
+ * @param[in]  out   The output literal
+ */
+void TSolver::removeBoundOutput(Lit out) {
+    removeAssumption(out);
+    int position = boundOutputPosition[var(out)];
+    Lit last = boundOutputs.back();
+    boundOutputs[position] = last;
+    boundOutputPosition[var(last)] = position;
+    boundOutputs.pop_back();
+    boundOutputPosition[var(out)] = -1;
+    boundEncoder[var(out)] = -1;
+}
+
+/**
+ * @brief      Rebuilds the assumptions from scratch for the current minimum
+ * weight.
+ *
+ * This takes time linear in the number of soft clauses, and is only needed
+ * when the minimum weight changes.
+ */
+void TSolver::resetAssumptions() {
+    for (int i = 0; i < coreAssumptions.size(); i++) {
+        assumptionPosition[var(coreAssumptions[i])] = -1;
+    }
+    coreAssumptions.clear();
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+        Lit l = maxsat_formula->getSoftClause(i).assumption_var;
+        if (!activeSoft[i] && !hardened[var(l)] && isSearched(i) &&
+            maxsat_formula->getSoftClause(i).weight >= min_weight) {
+            addAssumption(l);
+        }
+    }
+    for (int i = 0; i < boundOutputs.size(); i++) {
+        if (boundWeight[var(boundOutputs[i])] >= min_weight) {
+            addAssumption(boundOutputs[i]);
+        }
+    }
+}
+
+/**
+ * @brief      Finds the largest weight of a soft clause or bound output that
+ * is smaller than a given weight.
+ *
+ * This is findNextWeight() of the OLL algorithm, over the bound outputs kept
+ * by this class. Hardened soft clauses are hard in the SAT solver, so their
+ * weights are skipped.
+ *
+ * @param[in]  weight  The weight
+ *
+ * @return     The next weight, at least 1
+ */
+uint64_t TSolver::nextWeight(uint64_t weight) {
+    uint64_t next = 1;
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+        Lit l = maxsat_formula->getSoftClause(i).assumption_var;
+        uint64_t w = maxsat_formula->getSoftClause(i).weight;
+        if (!hardened[var(l)] && isSearched(i) && w > next && w < weight) {
+            next = w;
+        }
+    }
+    for (int i = 0; i < boundOutputs.size(); i++) {
+        uint64_t w = boundWeight[var(boundOutputs[i])];
+        if (w > next && w < weight) {
+            next = w;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief      Finds the next minimum weight to be considered, so that the
+ * considered clauses have enough diversity of weights.
+ *
+ * This is findNextWeightDiversity() of the OLL algorithm, over the bound
+ * outputs kept by this class, and without the hardened soft clauses.
+ *
+ * @param[in]  weight  The current minimum weight
+ *
+ * @return     The next minimum weight
+ */
+uint64_t TSolver::nextWeightDiversity(uint64_t weight) {
+    assert(nbSatisfiable > 0);
+    uint64_t next = weight;
+    float alpha = 1.25;
+    bool findNext = false;
+    for (;;) {
+        if (nbSatisfiable > 1 || findNext) {
+            next = nextWeight(next);
+        }
+        int nbClauses = 0;
+        int nbSearched = 0;
+        std::set<uint64_t> nbWeights;
+        for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+            Lit l = maxsat_formula->getSoftClause(i).assumption_var;
+            if (hardened[var(l)] || !isSearched(i)) {
+                continue;
+            }
+            nbSearched++;
+            if (maxsat_formula->getSoftClause(i).weight >= next) {
+                nbClauses++;
+                nbWeights.insert(maxsat_formula->getSoftClause(i).weight);
+            }
+        }
+        for (int i = 0; i < boundOutputs.size(); i++) {
+            if (boundWeight[var(boundOutputs[i])] >= next) {
+                nbClauses++;
+                nbWeights.insert(boundWeight[var(boundOutputs[i])]);
+            }
+        }
+        if ((float)nbClauses / nbWeights.size() > alpha ||
+            nbClauses == nbSearched + boundOutputs.size()) {
+            break;
+        }
+        if (nbSatisfiable == 1 && !findNext) {
+            findNext = true;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief      Determines if some soft clause or bound output has a weight
+ * below the current minimum weight, and so has not been considered yet.
+ *
+ * @return     True if there is such a weight, False otherwise
+ */
+bool TSolver::hasUnconsideredWeight() {
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+        Lit l = maxsat_formula->getSoftClause(i).assumption_var;
+        if (!hardened[var(l)] && isSearched(i) &&
+            maxsat_formula->getSoftClause(i).weight < min_weight) {
+            return true;
+        }
+    }
+    for (int i = 0; i < boundOutputs.size(); i++) {
+        if (boundWeight[var(boundOutputs[i])] < min_weight) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief      Hardens the soft clauses and bound outputs whose weight is more
+ * than the gap between the upper and the lower bound.
+ *
+ * Violating such a clause gives a cost above the upper bound, so no better
+ * model can violate it. It is removed from the assumptions and added to the
+ * SAT solver as a hard clause. The largest weight left unhardened is kept, so
+ * that the clauses are only scanned again once the gap falls below it.
+ */
+void TSolver::hardenSoftClauses() {
+    if (resumable || persistent || model.size() == 0 || ubCost < lbCost ||
+        hardeningWeight <= ubCost - lbCost) {
+        return;
+    }
+    uint64_t gap = ubCost - lbCost;
+    hardeningWeight = 0;
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+        Lit l = maxsat_formula->getSoftClause(i).assumption_var;
+        uint64_t weight = maxsat_formula->getSoftClause(i).weight;
+        if (activeSoft[i] || hardened[var(l)] || !isSearched(i)) {
+            continue;
+        }
+        if (weight > gap) {
+            hardened[var(l)] = true;
+            removeAssumption(l);
+            solver->addClause(~l);
+        } else {
+            hardeningWeight = std::max(hardeningWeight, weight);
+        }
+    }
+    for (int i = 0; i < boundOutputs.size();) {
+        Lit out = boundOutputs[i];
+        uint64_t weight = boundWeight[var(out)];
+        if (weight > gap) {
+            // the last output is moved into position i
+            removeBoundOutput(out);
+            solver->addClause(~out);
+        } else {
+            hardeningWeight = std::max(hardeningWeight, weight);
+            i++;
+        }
+    }
+}
+
+/**
+ * @brief      Deletes the cardinality encoders and clears the core
+ * bookkeeping.
+ */
+void TSolver::clearCoreState() {
+    for (int i = 0; i < cardinalityEncoders.size(); i++) {
+        delete cardinalityEncoders[i];
+    }
+    cardinalityEncoders.clear();
+    softOfVar.clear();
+    boundEncoder.clear();
+    boundValue.clear();
+    boundWeight.clear();
+    boundOutputs.clear();
+    boundOutputPosition.clear();
+    assumptionPosition.clear();
+    hardened.clear();
+    coreAssumptions.clear();
+    hardeningWeight = UINT64_MAX;
+}
+
+/**
+ * @brief      Sets how the cores found by the core guided search are reduced
+ * before they are relaxed.
+ *
+ * @param[in]  trim      Whether cores are trimmed
+ * @param[in]  minimize  Whether cores are minimized
+ * @param[in]  exhaust   Whether the bounds of new cores are exhausted
+ * @param[in]  budget    The conflict budget of each SAT call made for these
+ */
+void TSolver::setCoreOptions(bool trim, bool minimize, bool exhaust,
+                             int64_t budget) {
+    coreTrimming = trim;
+    coreMinimization = minimize;
+    coreExhaustion = exhaust;
+    coreBudget = budget;
+}
+
+/**
+ * @brief      Sets the conflict budget of the SAT calls of the core guided
+ * search, and how it escalates.
+ *
+ * Each time a call runs out of its budget, the budget is multiplied by the
+ * growth factor, and the search is diversified before the call is made again.
+ * Once the calls have run out of their budget the given number of times in a
+ * row, the search stops with the best model found if there is one, and goes
+ * on without a budget otherwise.
+ *
+ * @param[in]  budget   The conflict budget of the first call, zero for no
+ * budget
+ * @param[in]  growth   The growth factor of the budget
+ * @param[in]  retries  The number of times in a row a call may run out of its
+ * budget
+ * @param[in]  seed     The seed used to reorder the assumptions
+ */
+void TSolver::setSATBudget(int64_t budget, double growth, int retries,
+                           unsigned seed) {
+    satBudget = budget;
+    satBudgetGrowth = growth;
+    satBudgetRetries = retries;
+    currentBudget = budget;
+    budgetRandom.seed(seed);
+}
+
+/**
+ * @brief      Makes the SAT call of the core guided search under the
+ * assumptions, within the conflict budget.
+ *
+ * A search that must reach the optimum, such as that of a lexicographic level
+ * or a resumable search other than that of a neighbourhood, goes on without a
+ * budget instead of stopping.
+ *
+ * @return     The result of the SAT call, l_Undef if the search is to stop
+ * with the best model found
+ */
+lbool TSolver::budgetedSearch() {
+    if (satBudget <= 0) {
+        return searchSATSolver(solver, coreAssumptions);
+    }
+    for (int retries = 0;; retries++) {
+        solver->setConfBudget(currentBudget);
+        lbool res = searchSATSolver(solver, coreAssumptions);
+        solver->budgetOff();
+        budgetedCalls++;
+        if (res != l_Undef) {
+            return res;
+        }
+        exhaustedCalls++;
+        if (retries >= satBudgetRetries) {
+            if (model.size() > 0 && currentLevel == -1 &&
+                (!resumable || inNeighbourhood)) {
+                budgetStopped = true;
+                return l_Undef;
+            }
+            return searchSATSolver(solver, coreAssumptions);
+        }
+        currentBudget = int64_t(currentBudget * satBudgetGrowth);
+        diversify();
+    }
+}
+
+/**
+ * @brief      Diversifies the search after a SAT call ran out of its budget.
+ *
+ * The assumptions are shuffled, which changes the cores that the SAT solver
+ * finds, and the polarities of the SAT solver are reset to the best model,
+ * so that the next call searches around it.
+ */
+void TSolver::diversify() {
+    for (int i = coreAssumptions.size() - 1; i > 0; i--) {
+        int j = std::uniform_int_distribution<int>(0, i)(budgetRandom);
+        Lit l = coreAssumptions[i];
+        coreAssumptions[i] = coreAssumptions[j];
+        coreAssumptions[j] = l;
+    }
+    for (int i = 0; i < coreAssumptions.size(); i++) {
+        assumptionPosition[var(coreAssumptions[i])] = i;
+    }
+    for (int i = 0; i < model.size() && i < solver->nVars(); i++) {
+        if (model[i] != l_Undef) {
+            solver->setPolarity(i, model[i] == l_False);
+        }
+    }
+}
+
+/**
+ * @brief      Checks if a set of literals is a core under a conflict budget.
+ *
+ * The negations of the literals are given to the SAT solver as assumptions.
+ * If the SAT solver finds a model instead, the model is saved if it is better
+ * than the best one so far.
+ *
+ * @param[in]  core  The literals
+ *
+ * @return     l_False if they are a core, l_True if a model was found, and
+ * l_Undef if the budget ran out
+ */
+lbool TSolver::checkCore(const vec<Lit> &core) {
+    vec<Lit> coreCheckAssumptions;
+    for (int i = 0; i < core.size(); i++) {
+        coreCheckAssumptions.push(~core[i]);
+    }
+    solver->setConfBudget(coreBudget);
+    lbool res = searchSATSolver(solver, coreCheckAssumptions);
+    solver->budgetOff();
+    if (res == l_True) {
+        uint64_t cost = searchCost(solver->model);
+        if (cost < ubCost) {
+            saveModel(solver->model);
+            ubCost = cost;
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief      Trims a core by solving it again as assumptions, until the core
+ * returned is no smaller.
+ *
+ * @param      core  The core, replaced by the trimmed core
+ */
+void TSolver::trimCore(vec<Lit> &core) {
+    while (core.size() > 1) {
+        trimCalls++;
+        if (checkCore(core) != l_False ||
+            solver->conflict.size() >= core.size()) {
+            return;
+        }
+        trimmedLits += core.size() - solver->conflict.size();
+        solver->conflict.copyTo(core);
+    }
+}
+
+/**
+ * @brief      Minimizes a core by deleting literals.
+ *
+ * Each literal is removed in turn, and if the rest is still a core, the core
+ * is replaced by the one the SAT solver returns, which may be smaller still.
+ * Otherwise, or if the budget runs out, the literal is kept.
+ *
+ * @param      core  The core, replaced by the minimized core
+ */
+void TSolver::minimizeCore(vec<Lit> &core) {
+    vec<Lit> necessary;
+    vec<Lit> unknown;
+    core.copyTo(unknown);
+    std::set<Var> kept;
+    while (unknown.size() > 0) {
+        Lit l = unknown.last();
+        unknown.pop();
+        vec<Lit> candidate;
+        necessary.copyTo(candidate);
+        for (int i = 0; i < unknown.size(); i++) {
+            candidate.push(unknown[i]);
+        }
+        minimizeCalls++;
+        if (candidate.size() > 0 && checkCore(candidate) == l_False) {
+            int before = necessary.size() + unknown.size() + 1;
+            unknown.clear();
+            for (int i = 0; i < solver->conflict.size(); i++) {
+                if (kept.count(var(solver->conflict[i])) == 0) {
+                    unknown.push(solver->conflict[i]);
+                }
+            }
+            minimizedLits += before - necessary.size() - unknown.size();
+        } else {
+            necessary.push(l);
+            kept.insert(var(l));
+        }
+    }
+    necessary.copyTo(core);
+}
 
-using namespace Minisat;
-using namespace openwbo;
+/**
+ * @brief      Exhausts the bound of the cardinality encoder of a new core.
+ *
+ * While the hard clauses alone show that more literals of the core must be
+ * relaxed than the bound allows, the bound is increased and the lower bound
+ * grows by the weight of the core. This saves the search loop from finding
+ * each of these as a separate core. The exhaustion stops once the lower
+ * bound reaches the upper bound, as the search is then over and further
+ * probes are wasted.
+ *
+ * @param[in]  index    The index of the cardinality encoder of the core
+ * @param[in]  minCore  The weight of the core
+ *
+ * @return     The exhausted bound
+ */
+uint64_t TSolver::exhaustCore(int index, uint64_t minCore) {
+    Encoder *e = cardinalityEncoders[index];
+    uint64_t bound = 1;
+    exhaustCalls++;
+    while (bound < (unsigned)e->outputs().size() && lbCost < ubCost) {
+        vec<Lit> probe;
+        probe.push(e->outputs()[bound]);
+        if (checkCore(probe) != l_False) {
+            break;
+        }
+        lbCost += minCore;
+        exhaustedBounds++;
+        vec<Lit> join;
+        vec<Lit> encodingAssumptions;
+        e->incUpdateCardinality(solver, join, e->lits(), bound + 1,
+                                encodingAssumptions);
+        bound++;
+    }
+    return bound;
+}
 
 /**
- * @brief      Constructs the TSolver object.
+ * @brief      Prints the statistics of the SAT call budgets and the core
+ * reductions that are enabled.
+ */
+void TSolver::printCoreStatistics() {
+    if (satBudget > 0) {
+        std::cout << "SAT budgets: " << exhaustedCalls << " of "
+                  << budgetedCalls << " calls ran out, budget now "
+                  << currentBudget << " conflicts" << std::endl;
+        if (budgetStopped) {
+            std::cout << "Stopped with the best model found, at cost "
+                      << ubCost << " over the lower bound " << lbCost
+                      << std::endl;
+        }
+    }
+    if (!coreTrimming && !coreMinimization && !coreExhaustion) {
+        return;
+    }
+    std::cout << "Cores: " << nbCores << ", total size " << sumSizeCores
+              << std::endl;
+    if (coreTrimming) {
+        std::cout << "Core trimming: " << trimCalls << " calls, "
+                  << trimmedLits << " literals removed" << std::endl;
+    }
+    if (coreMinimization) {
+        std::cout << "Core minimization: " << minimizeCalls << " calls, "
+                  << minimizedLits << " literals removed" << std::endl;
+    }
+    if (coreExhaustion) {
+        std::cout << "Core exhaustion: " << exhaustCalls << " cores, "
+                  << exhaustedBounds << " bounds raised" << std::endl;
+    }
+}
+
+/**
+ * @brief      Solves the formula under assumptions, within a conflict budget,
+ * on the SAT solver of the core guided search, so that the call shares its
+ * learnt clauses.
  *
- * @param[in]  verb  The verbosity value to be given to the OLL object
- * @param[in]  enc   The encoding value to be given to the OLL object
+ * @param[in]  assumptions     The assumptions
+ * @param[in]  conflictBudget  The conflict budget, or zero for none
+ * @param      found           The model found, if any
+ *
+ * @return     l_True if a model was found, l_False if the assumptions are
+ * unsatisfiable, and l_Undef if the budget ran out
  */
-TSolver::TSolver(int verb = _VERBOSITY_MINIMAL_, int enc = _CARD_TOTALIZER_)
-    : OLL(verb, enc) {}
+lbool TSolver::solveWithBudget(const vec<Lit> &assumptions,
+                               int64_t conflictBudget, vec<lbool> &found) {
+    found.clear();
+    vec<Lit> solverAssumptions;
+    assumptions.copyTo(solverAssumptions);
+    if (conflictBudget > 0) {
+        solver->setConfBudget(conflictBudget);
+    }
+    lbool res = searchSATSolver(solver, solverAssumptions);
+    solver->budgetOff();
+    if (res == l_True) {
+        solver->model.copyTo(found);
+    }
+    return res;
+}
 
 /**
- * @brief      Solves the MaxSAT problem by calling the solver
+ * @brief      Runs the same SAT calls on a new SAT solver loaded with the
+ * formula, and prints the time each call takes.
  *
- * This is a modification of the search() function in the OLL algorithm of
- * Open WBO. Most of the code is identical, except that it expects the problem
- * to be weighted and returns the model found by the solver instead of exiting
- * at the end.
+ * The SAT solver is the one Open WBO was built with, see SAT_SOLVER_NAME, so
+ * the solvers are compared by running this with a build for each. Each soft
+ * clause is added with a new relaxation variable. The calls are the hard
+ * clauses alone, the hard clauses under the phase hints, and the hard clauses
+ * with the soft clauses of each weight and above assumed satisfied, from the
+ * largest weight down. The formula is not modified, so this can be run before
+ * the formula is solved.
+ */
+void TSolver::benchmarkSATSolver() {
+    std::string name = SAT_SOLVER_NAME;
+    std::vector<uint64_t> weights;
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+        weights.push_back(maxsat_formula->getSoftClause(i).weight);
+    }
+    std::sort(weights.begin(), weights.end(), std::greater<uint64_t>());
+    weights.erase(std::unique(weights.begin(), weights.end()), weights.end());
+
+    auto start = std::chrono::steady_clock::now();
+    Solver *target = new Solver();
+    target->verbosity = 0;
+    while (target->nVars() < maxsat_formula->nVars()) {
+        target->newVar();
+    }
+    for (int i = 0; i < maxsat_formula->nHard(); i++) {
+        target->addClause(maxsat_formula->getHardClause(i).clause);
+    }
+    std::vector<Lit> relaxation;
+    vec<Lit> clause;
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+        maxsat_formula->getSoftClause(i).clause.copyTo(clause);
+        relaxation.push_back(mkLit(target->newVar()));
+        clause.push(relaxation.back());
+        target->addClause(clause);
+    }
+    std::cout << name << " load: "
+              << std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " s" << std::endl;
+
+    std::vector<std::string> callNames;
+    std::vector<std::vector<Lit>> calls;
+    callNames.push_back("hard clauses");
+    calls.push_back(std::vector<Lit>());
+    callNames.push_back("phase hints");
+    calls.push_back(std::vector<Lit>());
+    for (int i = 0; i < phaseHints.size(); i++) {
+        if (var(phaseHints[i]) < maxsat_formula->nVars()) {
+            calls.back().push_back(phaseHints[i]);
+        }
+    }
+    for (int w = 0; w < weights.size(); w++) {
+        callNames.push_back("soft weight >= " + std::to_string(weights[w]));
+        calls.push_back(std::vector<Lit>());
+        for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+            if (maxsat_formula->getSoftClause(i).weight >= weights[w]) {
+                calls.back().push_back(~relaxation[i]);
+            }
+        }
+    }
+
+    double total = 0;
+    for (int c = 0; c < calls.size(); c++) {
+        vec<Lit> assumptions;
+        for (int i = 0; i < calls[c].size(); i++) {
+            assumptions.push(calls[c][i]);
+        }
+        start = std::chrono::steady_clock::now();
+        lbool res = target->solveLimited(assumptions);
+        double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        total += seconds;
+        std::cout << name << " " << callNames[c] << ": ";
+        if (res == l_True) {
+            std::cout << "SAT";
+        } else if (res == l_False) {
+            std::cout << "UNSAT, core of " << target->conflict.size();
+        } else {
+            std::cout << "UNKNOWN";
+        }
+        std::cout << ", " << seconds << " s" << std::endl;
+    }
+    std::cout << name << " total: " << total << " s" << std::endl;
+    delete target;
+}
+
+/**
+ * @brief      Builds the SAT solver from the relaxed formula.
  *
- * @return     The model found by the solver. This could be empty if the problem
- * was unsatisfiable
+ * This hides OLL::rebuildSolver(), so that the SAT solver is a TSATSolver
+ * whose learnt clauses can be read. The formula holds no cardinality or
+ * pseudo-Boolean constraints, so only its clauses are added.
+ *
+ * @return     The SAT solver
  */
-std::vector<lbool> TSolver::tSearch() {
-    if (encoding != _CARD_TOTALIZER_) {
-        printf("Error: Currently algorithm MSU3 with iterative encoding only "
-               "supports the totalizer encoding.\n");
-        printf("s UNKNOWN\n");
-        exit(_ERROR_);
+Solver *TSolver::rebuildSolver() {
+    Solver *S = new TSATSolver();
+    for (int i = 0; i < maxsat_formula->nVars(); i++)
+        S->newVar();
+    for (int i = 0; i < maxsat_formula->nHard(); i++)
+        S->addClause(maxsat_formula->getHardClause(i).clause);
+    vec<Lit> clause;
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+        clause.clear();
+        Soft &soft = maxsat_formula->getSoftClause(i);
+        soft.clause.copyTo(clause);
+        for (int j = 0; j < soft.relaxation_vars.size(); j++)
+            clause.push(soft.relaxation_vars[j]);
+        S->addClause(clause);
     }
+    return S;
+}
 
-    if (maxsat_formula->getProblemType() == _WEIGHTED_) {
-        tWeighted();
-        return Utils::convertVecDataToVector<lbool>(model, model.size());
-    } else {
-        printf("Error: Use the solver in 'weighted' mode only!\n");
-        exit(_ERROR_);
+/**
+ * @brief      Prepares the formula and the SAT solver for the search.
+ *
+ * The weights of the soft clauses are recorded before the search splits
+ * them, the local search is run, the soft clauses are relaxed, and the SAT
+ * solver is built and given the phase hints, the branching priorities and any
+ * initial model.
+ */
+void TSolver::prepareSearch() {
+    nbOriginalSoft = maxsat_formula->nSoft();
+    nbOriginalVars = maxsat_formula->nVars();
+    recordedCores.clear();
+    originalWeights.clear();
+    for (int i = 0; i < nbOriginalSoft; i++)
+        originalWeights.push_back(maxsat_formula->getSoftClause(i).weight);
+    runLocalSearch();
+    initRelaxation();
+    solver = rebuildSolver();
+    applyPhaseHints();
+    applyBranchingPriorities();
+    seedUpperBound();
+    applyInitialModel();
+}
+
+/**
+ * @brief      Solves a MaxSAT problem whose soft clauses all have the same
+ * weight with the MSU3 algorithm.
+ *
+ * This follows the MSU3 algorithm of Open WBO with the incremental totalizer.
+ * The soft clauses that have appeared in a core are relaxed together under a
+ * single totalizer, whose bound is the number of cores found so far, and the
+ * other soft clauses are assumed satisfied. The first model found is then
+ * optimal.
+ */
+void TSolver::tMSU3() {
+    uint64_t weight = maxsat_formula->nSoft() > 0
+                          ? maxsat_formula->getSoftClause(0).weight
+                          : 0;
+
+    vec<Lit> objFunction;
+    vec<Lit> joinObjFunction;
+    vec<Lit> encodingAssumptions;
+    vec<Lit> assumptions;
+    Encoder *e = NULL;
+    int bound = 0;
+
+    for (;;) {
+        assumptions.clear();
+        for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+            if (!activeSoft[i]) {
+                assumptions.push(
+                    ~maxsat_formula->getSoftClause(i).assumption_var);
+            }
+        }
+        for (int i = 0; i < encodingAssumptions.size(); i++) {
+            assumptions.push(encodingAssumptions[i]);
+        }
+
+        lbool res = searchSATSolver(solver, assumptions);
+        if (res == l_True) {
+            nbSatisfiable++;
+            uint64_t newCost = computeCostModel(solver->model);
+            if (newCost < ubCost || model.size() == 0) {
+                saveModel(solver->model);
+                ubCost = newCost;
+            }
+            // the assumptions allow no more violated soft clauses than there
+            // are cores, so the model is optimal
+            return;
+        }
+
+        vec<Lit> core;
+        solver->conflict.copyTo(core);
+        if (core.size() == 0) {
+            // the hard clauses are unsatisfiable
+            return;
+        }
+        if (coreTrimming)
+            trimCore(core);
+        if (coreMinimization)
+            minimizeCore(core);
+        recordCore(core);
+        nbCores++;
+        sumSizeCores += core.size();
+        lbCost += weight;
+        bound++;
+        if (lbCost == ubCost) {
+            return;
+        }
+
+        joinObjFunction.clear();
+        for (int i = 0; i < core.size(); i++) {
+            int indexSoft = softClauseOf(core[i]);
+            if (indexSoft != -1 && !activeSoft[indexSoft]) {
+                activeSoft[indexSoft] = true;
+                objFunction.push(core[i]);
+                joinObjFunction.push(core[i]);
+            }
+        }
+
+        encodingAssumptions.clear();
+        if (e == NULL) {
+            // while every relaxed soft clause may be violated, no totalizer
+            // is needed
+            if (bound < objFunction.size()) {
+                e = new Encoder();
+                e->setIncremental(_INCREMENTAL_ITERATIVE_);
+                e->buildCardinality(solver, objFunction, bound);
+                cardinalityEncoders.push_back(e);
+                joinObjFunction.clear();
+                e->incUpdateCardinality(solver, joinObjFunction, objFunction,
+                                        bound, encodingAssumptions);
+            }
+        } else {
+            e->incUpdateCardinality(solver, joinObjFunction, objFunction,
+                                    bound, encodingAssumptions);
+        }
+    }
+}
+
+/**
+ * @brief      Solves a MaxSAT problem by linear search over its weight
+ * levels, from the largest weight down.
+ *
+ * The soft clauses of each weight are bounded by a totalizer, and the bound
+ * is lowered below the number violated in the last model until the SAT solver
+ * fails. The level is then kept at that number while the smaller weights are
+ * optimized. This is optimal when the weights are lexicographic, as no number
+ * of violations of smaller weights can outweigh one of a larger weight.
+ */
+void TSolver::tLinear() {
+    vec<Lit> fixedAssumptions;
+    lbool res = searchSATSolver(solver, fixedAssumptions);
+    if (res != l_True) {
+        return;
+    }
+    nbSatisfiable++;
+    vec<lbool> current;
+    solver->model.copyTo(current);
+    uint64_t newCost = computeCostModel(current);
+    if (newCost < ubCost || model.size() == 0) {
+        saveModel(current);
+        ubCost = newCost;
+    }
+
+    std::vector<uint64_t> levels(originalWeights);
+    std::sort(levels.begin(), levels.end(), std::greater<uint64_t>());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    for (int l = 0; l < levels.size(); l++) {
+        vec<Lit> lits;
+        for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+            if (maxsat_formula->getSoftClause(i).weight == levels[l]) {
+                lits.push(maxsat_formula->getSoftClause(i).assumption_var);
+            }
+        }
+        auto countViolated = [&lits](const vec<lbool> &m) {
+            int count = 0;
+            for (int i = 0; i < lits.size(); i++) {
+                if ((m[var(lits[i])] ^ sign(lits[i])) == l_True) {
+                    count++;
+                }
+            }
+            return count;
+        };
+
+        int count = countViolated(current);
+        Encoder *e = NULL;
+        if (count > 0) {
+            e = new Encoder();
+            e->setIncremental(_INCREMENTAL_ITERATIVE_);
+            e->buildCardinality(solver, lits, count);
+            cardinalityEncoders.push_back(e);
+        }
+        while (count > 0) {
+            vec<Lit> assumptions;
+            fixedAssumptions.copyTo(assumptions);
+            assumptions.push(~e->outputs()[count - 1]);
+            res = searchSATSolver(solver, assumptions);
+            if (res != l_True) {
+                nbCores++;
+                break;
+            }
+            nbSatisfiable++;
+            solver->model.copyTo(current);
+            newCost = computeCostModel(current);
+            if (newCost < ubCost) {
+                saveModel(current);
+                ubCost = newCost;
+            }
+            count = countViolated(current);
+        }
+
+        lbCost += count * levels[l];
+        if (count == 0) {
+            for (int i = 0; i < lits.size(); i++) {
+                fixedAssumptions.push(~lits[i]);
+            }
+        } else if (count < e->outputs().size()) {
+            fixedAssumptions.push(~e->outputs()[count]);
+        }
+    }
+}
+
+/**
+ * @brief      Sets when the core phase of the core-boosted search ends.
+ *
+ * @param[in]  cores    The number of cores, zero for no limit
+ * @param[in]  seconds  The time in seconds, zero for no limit
+ */
+void TSolver::setCoreBoost(int cores, double seconds) {
+    coreBoostCores = cores;
+    coreBoostTime = seconds;
+}
+
+/**
+ * @brief      Checks if the core phase of the core-boosted search has used up
+ * its cores or time. A model must have been found first.
+ *
+ * @return     True if the phase is over, False otherwise
+ */
+bool TSolver::isCorePhaseOver() {
+    if (!boosting || model.size() == 0) {
+        return false;
+    }
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - boostStart)
+                         .count();
+    return (coreBoostCores > 0 && nbCores >= coreBoostCores) ||
+           (coreBoostTime > 0 && elapsed >= coreBoostTime);
+}
+
+/**
+ * @brief      Solves a weighted MaxSAT problem with core-boosted linear
+ * search.
+ *
+ * Stratified OLL is first run until it has found the cores or used the time
+ * given with setCoreBoost(), which raises the lower bound quickly. The cores
+ * have by then reformulated the objective as the lower bound plus the weights
+ * of the soft clauses not yet relaxed and of the outputs of the cardinality
+ * encoders, each of which counts one violation over its bound. The encoders
+ * are extended to all their outputs, and a SAT-UNSAT linear search on the same
+ * SAT solver then lowers a pseudo-Boolean bound on the reformulated objective
+ * until no better model exists. The reformulated objective is usually far
+ * smaller than the original one, so its bounds are cheap to encode.
+ *
+ * The bounds are added as hard clauses, so the search is not resumable.
+ */
+void TSolver::tCoreBoosted() {
+    boosting = true;
+    boostStart = std::chrono::steady_clock::now();
+    tWeighted(true);
+    boosting = false;
+    if (model.size() == 0 || lbCost >= ubCost || budgetStopped) {
+        return;
+    }
+    std::cout << "Core phase: " << nbCores << " cores, lower bound " << lbCost
+              << ", cost " << ubCost << std::endl;
+
+    vec<Lit> objective;
+    vec<uint64_t> coeffs;
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+        Lit l = maxsat_formula->getSoftClause(i).assumption_var;
+        if (activeSoft[i] || hardened[var(l)] || !isSearched(i)) {
+            continue;
+        }
+        objective.push(l);
+        coeffs.push(maxsat_formula->getSoftClause(i).weight);
+    }
+    for (int i = 0; i < boundOutputs.size(); i++) {
+        Lit out = boundOutputs[i];
+        Encoder *e = cardinalityEncoders[boundEncoder[var(out)]];
+        vec<Lit> join;
+        vec<Lit> encodingAssumptions;
+        e->incUpdateCardinality(solver, join, e->lits(), e->lits().size(),
+                                encodingAssumptions);
+        for (int j = boundValue[var(out)]; j < e->outputs().size(); j++) {
+            objective.push(e->outputs()[j]);
+            coeffs.push(boundWeight[var(out)]);
+        }
+    }
+
+    Encoder pbEncoder(_INCREMENTAL_NONE_, _CARD_TOTALIZER_, _AMO_LADDER_,
+                      _PB_GTE_);
+    vec<Lit> noAssumptions;
+    int models = 0;
+    uint64_t bound = ubCost - lbCost;
+    lbool res = l_False;
+    while (bound > 0 && objective.size() > 0) {
+        if (!pbEncoder.hasPBEncoding()) {
+            pbEncoder.encodePB(solver, objective, coeffs, bound - 1);
+        } else {
+            pbEncoder.updatePB(solver, bound - 1);
+        }
+        boundsAdded = true;
+        res = searchSATSolver(solver, noAssumptions);
+        if (res != l_True) {
+            break;
+        }
+        nbSatisfiable++;
+        models++;
+        uint64_t value = 0;
+        for (int i = 0; i < objective.size(); i++) {
+            if ((solver->model[var(objective[i])] ^ sign(objective[i])) ==
+                l_True) {
+                value += coeffs[i];
+            }
+        }
+        uint64_t newCost = searchCost(solver->model);
+        if (newCost < ubCost) {
+            saveModel(solver->model);
+            ubCost = newCost;
+        }
+        bound = std::min(value, ubCost - lbCost);
+    }
+    if (res == l_False || bound == 0) {
+        lbCost = ubCost;
+    }
+    std::cout << "Linear phase: " << models << " models, cost " << ubCost
+              << std::endl;
+}
+
+/**
+ * @brief      Optimizes the objective levels one after another, from level 0
+ * down.
+ *
+ * Each level is solved with stratified OLL over its own soft clauses, on the
+ * same SAT solver, while the soft clauses of the later levels are left free.
+ * Once a level is optimal, its remaining assumptions are added as unit
+ * clauses, see freezeLevel(), so that the later levels keep it optimal.
+ */
+void TSolver::tLexicographic() {
+    levelCosts.clear();
+    vec<Lit> noAssumptions;
+    if (searchSATSolver(solver, noAssumptions) != l_True) {
+        return;
+    }
+    nbSatisfiable++;
+    if (model.size() == 0) {
+        saveModel(solver->model);
+    }
+    int levels = 0;
+    for (int i = 0; i < softLevel.size(); i++) {
+        levels = std::max(levels, softLevel[i] + 1);
+    }
+    for (currentLevel = 0; currentLevel < levels; currentLevel++) {
+        lbCost = 0;
+        ubCost = searchCost(model);
+        hardeningWeight = UINT64_MAX;
+        tWeighted(true);
+        levelCosts.push_back(ubCost);
+        freezeLevel();
+    }
+    currentLevel = -1;
+    ubCost = computeCostModel(model);
+    lbCost = ubCost;
+}
+
+/**
+ * @brief      Keeps the current objective level at its optimum for the rest of
+ * the search.
+ *
+ * When OLL finishes, every model satisfying its assumptions has the optimal
+ * cost, so the assumptions are added to the SAT solver as unit clauses. These
+ * include the outputs of the totalizers built for the cores of the level,
+ * which bound the number of its relaxed soft clauses.
+ */
+void TSolver::freezeLevel() {
+    for (int i = 0; i < coreAssumptions.size(); i++) {
+        solver->addClause(coreAssumptions[i]);
+    }
+    while (boundOutputs.size() > 0) {
+        removeBoundOutput(boundOutputs.back());
+    }
+    while (coreAssumptions.size() > 0) {
+        removeAssumption(~coreAssumptions.last());
     }
 }
 
@@ -83,36 +1923,52 @@ std::vector<lbool> TSolver::tSearch() {
  * Open WBO. Most of the code is identical, except that when the result is
  * found, the function returns instead of printing the answer to stdout and
  * exiting.
+ *
+ * The soft clause of each assumption variable and the bound, weight and
+ * encoder of each cardinality output are kept in arrays indexed by variable,
+ * instead of the maps of the OLL algorithm. The assumptions are updated as
+ * each core is relaxed, instead of being rebuilt over all the soft clauses,
+ * so handling a core takes time linear in its size, apart from the encoding.
+ * The assumptions are only rebuilt when the minimum weight changes.
+ *
+ * Whenever a bound improves, the soft clauses that no better model can violate
+ * are hardened, see hardenSoftClauses().
+ *
+ * The SAT calls may be given a conflict budget, see setSATBudget(), in which
+ * case the search can return with the best model found before it is proven
+ * optimal.
+ *
+ * @param[in]  stratified  Whether the soft clauses are considered in strata of
+ * decreasing weight, instead of all from the first SAT call
  */
-void TSolver::tWeighted() {
+void TSolver::tWeighted(bool stratified) {
     // nbInitialVariables = nVars();
     lbool res = l_True;
-    initRelaxation();
-    solver = rebuildSolver();
 
-    vec<Lit> assumptions;
     vec<Lit> joinObjFunction;
-    vec<Lit> currentObjFunction;
     vec<Lit> encodingAssumptions;
     encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
 
-    activeSoft.growTo(maxsat_formula->nSoft(), false);
-    for (int i = 0; i < maxsat_formula->nSoft(); i++)
-        coreMapping[maxsat_formula->getSoftClause(i).assumption_var] = i;
-
-    std::set<Lit> cardinality_assumptions;
-    vec<Encoder *> soft_cardinality;
-
-    min_weight = maxsat_formula->getMaximumWeight();
+    min_weight = stratified ? maxsat_formula->getMaximumWeight() : 1;
     // printf("current weight %d\n",maxsat_formula->getMaximumWeight());
+    if (nbSatisfiable > 0) {
+        // the hard clauses are known to be satisfiable, so the first call can
+        // already assume the first stratum
+        resetAssumptions();
+    }
+    hardenSoftClauses();
 
     for (;;) {
 
-        res = searchSATSolver(solver, assumptions);
+        res = budgetedSearch();
+        if (res == l_Undef) {
+            return;
+        }
         if (res == l_True) {
             nbSatisfiable++;
-            uint64_t newCost = computeCostModel(solver->model);
-            if (newCost < ubCost || nbSatisfiable == 1) {
+            uint64_t newCost = searchCost(solver->model);
+            // the model may already have been seeded from the phase hints
+            if (newCost < ubCost || model.size() == 0) {
                 saveModel(solver->model);
                 if (maxsat_formula->getFormat() == _FORMAT_PB_) {
                     // optimization problem
@@ -123,98 +1979,51 @@ void TSolver::tWeighted() {
                     // printf("o %" PRId64 "\n", newCost + off_set);
                     ubCost = newCost;
             }
+            hardenSoftClauses();
+            if (ubCost <= knownLowerBound && currentLevel == -1 &&
+                !resumable) {
+                lbCost = ubCost;
+                return;
+            }
 
             if (nbSatisfiable == 1) {
-                min_weight = findNextWeightDiversity(min_weight,
-                                                     cardinality_assumptions);
+                min_weight = nextWeightDiversity(min_weight);
                 // printf("current weight %d\n",min_weight);
-
-                for (int i = 0; i < maxsat_formula->nSoft(); i++)
-                    if (maxsat_formula->getSoftClause(i).weight >= min_weight)
-                        assumptions.push(
-                            ~maxsat_formula->getSoftClause(i).assumption_var);
+                resetAssumptions();
+            } else if (hasUnconsideredWeight()) {
+                min_weight = nextWeightDiversity(min_weight);
+                // printf("currentWeight %d\n",currentWeight);
+                resetAssumptions();
             } else {
-                // compute min weight in soft
-                int not_considered = 0;
-                for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-                    if (maxsat_formula->getSoftClause(i).weight < min_weight)
-                        not_considered++;
-                }
-
-                // printf("not considered %d\n",not_considered);
-
-                for (std::set<Lit>::iterator it =
-                         cardinality_assumptions.begin();
-                     it != cardinality_assumptions.end(); ++it) {
-                    assert(boundMapping.find(*it) != boundMapping.end());
-                    std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-                        boundMapping[*it];
-                    if (soft_id.second < min_weight)
-                        not_considered++;
-                }
-
-                if (not_considered != 0) {
-                    min_weight = findNextWeightDiversity(
-                        min_weight, cardinality_assumptions);
-
-                    // printf("currentWeight %d\n",currentWeight);
-
-                    // reset the assumptions
-                    assumptions.clear();
-                    int active_soft = 0;
-                    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-                        if (!activeSoft[i] &&
-                            maxsat_formula->getSoftClause(i).weight >=
-                                min_weight) {
-                            assumptions.push(~maxsat_formula->getSoftClause(i)
-                                                  .assumption_var);
-                            // printf("s assumption
-                            // %d\n",var(softClauses[i].assumptionVar)+1);
-                        } else
-                            active_soft++;
-                    }
-
-                    // printf("assumptions %d\n",assumptions.size());
-                    for (std::set<Lit>::iterator it =
-                             cardinality_assumptions.begin();
-                         it != cardinality_assumptions.end(); ++it) {
-                        assert(boundMapping.find(*it) != boundMapping.end());
-                        std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-                            boundMapping[*it];
-                        if (soft_id.second >= min_weight)
-                            assumptions.push(~(*it));
-                        // printf("c assumption %d\n",var(*it)+1);
-                    }
-
-                } else {
-                    assert(lbCost == newCost);
-                    return;
-                }
+                assert(lbCost == newCost);
+                return;
             }
         }
 
         if (res == l_False) {
 
+            vec<Lit> core;
+            solver->conflict.copyTo(core);
+            if (nbSatisfiable > 0 && coreTrimming)
+                trimCore(core);
+            if (nbSatisfiable > 0 && coreMinimization)
+                minimizeCore(core);
+            recordCore(core);
+
             // reduce the weighted to the unweighted case
             uint64_t min_core = UINT64_MAX;
-            for (int i = 0; i < solver->conflict.size(); i++) {
-                Lit p = solver->conflict[i];
-                if (coreMapping.find(p) != coreMapping.end()) {
-                    assert(!activeSoft[coreMapping[p]]);
-                    if (maxsat_formula
-                            ->getSoftClause(coreMapping[solver->conflict[i]])
-                            .weight < min_core)
-                        min_core = maxsat_formula
-                                       ->getSoftClause(
-                                           coreMapping[solver->conflict[i]])
-                                       .weight;
+            for (int i = 0; i < core.size(); i++) {
+                Lit p = core[i];
+                int indexSoft = softClauseOf(p);
+                if (indexSoft != -1) {
+                    assert(!activeSoft[indexSoft]);
+                    uint64_t weight =
+                        maxsat_formula->getSoftClause(indexSoft).weight;
+                    min_core = std::min(min_core, weight);
                 }
 
-                if (boundMapping.find(p) != boundMapping.end()) {
-                    std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-                        boundMapping[solver->conflict[i]];
-                    if (soft_id.second < min_core)
-                        min_core = soft_id.second;
+                if (isBoundOutput(p)) {
+                    min_core = std::min(min_core, boundWeight[var(p)]);
                 }
             }
 
@@ -229,27 +2038,29 @@ void TSolver::tWeighted() {
                     return;
                 }
 
-            if (lbCost == ubCost) {
+            // a level is only done once its bound can be frozen, and a
+            // resumable search once all its assumptions hold
+            if (lbCost == ubCost && currentLevel == -1 && !resumable) {
                 assert(nbSatisfiable > 0);
                 if (verbosity > 0)
                     // printf("c LB = UB\n");
                     return;
             }
 
-            sumSizeCores += solver->conflict.size();
+            sumSizeCores += core.size();
 
             vec<Lit> soft_relax;
             vec<Lit> cardinality_relax;
 
-            for (int i = 0; i < solver->conflict.size(); i++) {
-                Lit p = solver->conflict[i];
-                if (coreMapping.find(p) != coreMapping.end()) {
-                    if (maxsat_formula->getSoftClause(coreMapping[p]).weight >
+            for (int i = 0; i < core.size(); i++) {
+                Lit p = core[i];
+                int indexSoft = softClauseOf(p);
+                if (indexSoft != -1) {
+                    assert(!activeSoft[indexSoft]);
+                    if (maxsat_formula->getSoftClause(indexSoft).weight >
                         min_core) {
                         // printf("SPLIT THE CLAUSE\n");
-                        assert(!activeSoft[coreMapping[p]]);
                         // SPLIT THE CLAUSE
-                        int indexSoft = coreMapping[p];
                         assert(maxsat_formula->getSoftClause(indexSoft).weight -
                                    min_core >
                                0);
@@ -257,6 +2068,9 @@ void TSolver::tWeighted() {
                         // Update the weight of the soft clause.
                         maxsat_formula->getSoftClause(indexSoft).weight -=
                             min_core;
+                        if (maxsat_formula->getSoftClause(indexSoft).weight <
+                            min_weight)
+                            removeAssumption(p);
 
                         vec<Lit> clause;
                         vec<Lit> vars;
@@ -272,10 +2086,10 @@ void TSolver::tWeighted() {
                         vars.push(l);
 
                         // Add a new soft clause with the weight of the core.
-                        // addSoftClause(softClauses[indexSoft].weight-min_core,
-                        // clause, vars);
                         maxsat_formula->addSoftClause(min_core, clause, vars);
                         activeSoft.push(true);
+                        if (softLevel.size() > 0)
+                            softLevel.push_back(softLevel[indexSoft]);
 
                         // Add information to the SAT solver
                         newSATVariable(solver);
@@ -290,218 +2104,72 @@ void TSolver::tWeighted() {
                                    .relaxation_vars.size() == 1);
 
                         // Create a new assumption literal.
-
                         maxsat_formula
                             ->getSoftClause(maxsat_formula->nSoft() - 1)
                             .assumption_var = l;
-                        assert(maxsat_formula
-                                   ->getSoftClause(maxsat_formula->nSoft() - 1)
-                                   .assumption_var ==
-                               maxsat_formula
-                                   ->getSoftClause(maxsat_formula->nSoft() - 1)
-                                   .relaxation_vars[0]);
-                        coreMapping[l] = maxsat_formula->nSoft() -
-                                         1; // Map the new soft clause to its
-                                            // assumption literal.
+                        // Map the new soft clause to its assumption literal.
+                        mapSoftClause(maxsat_formula->nSoft() - 1);
 
                         soft_relax.push(l);
-                        assert(maxsat_formula->getSoftClause(coreMapping[l])
-                                   .weight == min_core);
                         assert(activeSoft.size() == maxsat_formula->nSoft());
 
                     } else {
                         // printf("NOT SPLITTING\n");
-                        assert(maxsat_formula
-                                   ->getSoftClause(
-                                       coreMapping[solver->conflict[i]])
-                                   .weight == min_core);
+                        assert(
+                            maxsat_formula->getSoftClause(indexSoft).weight ==
+                            min_core);
                         soft_relax.push(p);
-                        // printf("ASSERT %d\n",var(p)+1);
-                        assert(!activeSoft[coreMapping[p]]);
-                        activeSoft[coreMapping[p]] = true;
+                        activeSoft[indexSoft] = true;
+                        removeAssumption(p);
                     }
                 }
 
-                if (boundMapping.find(p) != boundMapping.end()) {
+                if (isBoundOutput(p)) {
                     // printf("CARD IN CORE\n");
 
-                    std::set<Lit>::iterator it;
-                    it = cardinality_assumptions.find(p);
-                    assert(it != cardinality_assumptions.end());
-
                     // this is a soft cardinality -- bound must be increased
-                    std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-                        boundMapping[solver->conflict[i]];
-                    // increase the bound
-                    assert(soft_id.first.first < soft_cardinality.size());
-                    assert(soft_cardinality[soft_id.first.first]
-                               ->hasCardEncoding());
-
-                    if (soft_id.second == min_core) {
-
-                        cardinality_assumptions.erase(it);
+                    int index = boundEncoder[var(p)];
+                    uint64_t bound = boundValue[var(p)];
+                    uint64_t weight = boundWeight[var(p)];
+                    assert(index < cardinalityEncoders.size());
+                    assert(cardinalityEncoders[index]->hasCardEncoding());
+
+                    if (weight == min_core) {
+                        removeBoundOutput(p);
                         cardinality_relax.push(p);
-
-                        joinObjFunction.clear();
-                        encodingAssumptions.clear();
-                        soft_cardinality[soft_id.first.first]
-                            ->incUpdateCardinality(
-                                solver, joinObjFunction,
-                                soft_cardinality[soft_id.first.first]->lits(),
-                                soft_id.first.second + 1, encodingAssumptions);
-
-                        // if the bound is the same as the number of lits then
-                        // no restriction is applied
-                        if (soft_id.first.second + 1 <
-                            (unsigned)soft_cardinality[soft_id.first.first]
-                                ->outputs()
-                                .size()) {
-                            assert(
-                                (unsigned)soft_cardinality[soft_id.first.first]
-                                    ->outputs()
-                                    .size() > soft_id.first.second + 1);
-                            Lit out = soft_cardinality[soft_id.first.first]
-                                          ->outputs()[soft_id.first.second + 1];
-                            boundMapping[out] = std::make_pair(
-                                std::make_pair(soft_id.first.first,
-                                               soft_id.first.second + 1),
-                                min_core);
-                            cardinality_assumptions.insert(out);
-                        }
-
                     } else {
-
-#if 1
                         // duplicate cardinality constraint???
                         Encoder *e = new Encoder();
                         e->setIncremental(_INCREMENTAL_ITERATIVE_);
                         e->buildCardinality(
-                            solver,
-                            soft_cardinality[soft_id.first.first]->lits(),
-                            soft_id.first.second);
-
-                        assert((unsigned)e->outputs().size() >
-                               soft_id.first.second);
-                        Lit out = e->outputs()[soft_id.first.second];
-                        soft_cardinality.push(e);
-
-                        boundMapping[out] = std::make_pair(
-                            std::make_pair(soft_cardinality.size() - 1,
-                                           soft_id.first.second),
-                            min_core);
-                        cardinality_relax.push(out);
-
-                        // Update value of the previous cardinality constraint
-                        assert(soft_id.second - min_core > 0);
-                        boundMapping[p] =
-                            std::make_pair(std::make_pair(soft_id.first.first,
-                                                          soft_id.first.second),
-                                           soft_id.second - min_core);
-
-                        // Update bound as usual...
-
-                        std::pair<std::pair<int, int>, int> soft_core_id =
-                            boundMapping[out];
-
-                        joinObjFunction.clear();
-                        encodingAssumptions.clear();
-                        soft_cardinality[soft_core_id.first.first]
-                            ->incUpdateCardinality(
-                                solver, joinObjFunction,
-                                soft_cardinality[soft_core_id.first.first]
-                                    ->lits(),
-                                soft_core_id.first.second + 1,
-                                encodingAssumptions);
-
-                        // if the bound is the same as the number of lits then
-                        // no restriction is applied
-                        if (soft_core_id.first.second + 1 <
-                            soft_cardinality[soft_core_id.first.first]
-                                ->outputs()
-                                .size()) {
-                            assert(soft_cardinality[soft_core_id.first.first]
-                                       ->outputs()
-                                       .size() > soft_core_id.first.second + 1);
-                            Lit out =
-                                soft_cardinality[soft_core_id.first.first]
-                                    ->outputs()[soft_core_id.first.second + 1];
-                            boundMapping[out] = std::make_pair(
-                                std::make_pair(soft_core_id.first.first,
-                                               soft_core_id.first.second + 1),
-                                min_core);
-                            cardinality_assumptions.insert(out);
-                        }
-#else
-
-                        // FIXME: improve the OLL algorithm by reusing the
-                        // cardinality constraint This current alternative does
-                        // not work!
-                        while (nVars() < solver->nVars())
-                            newLiteral();
-
-                        Lit l = newLiteral();
-
-                        // Add information to the SAT solver
-                        newSATVariable(solver);
-                        vec<Lit> clause;
-                        clause.push(l);
-                        clause.push(~p);
-                        solver->addClause(clause);
-
-                        clause.clear();
-                        clause.push(~l);
-                        clause.push(p);
-                        solver->addClause(clause);
-
-                        boundMapping[l] =
-                            std::make_pair(std::make_pair(soft_id.first.first,
-                                                          soft_id.first.second),
-                                           min_core);
-                        cardinality_relax.push(l);
-
-                        // Update bound as usual...
-
-                        std::pair<std::pair<int, int>, int> soft_core_id =
-                            boundMapping[p];
-
-                        joinObjFunction.clear();
-                        encodingAssumptions.clear();
-                        soft_cardinality[soft_core_id.first.first]
-                            ->incUpdateCardinality(
-                                solver, joinObjFunction,
-                                soft_cardinality[soft_core_id.first.first]
-                                    ->lits(),
-                                soft_core_id.first.second + 1,
-                                encodingAssumptions);
-
-                        // if the bound is the same as the number of lits then
-                        // no restriction is applied
-                        if (soft_core_id.first.second + 1 <
-                            soft_cardinality[soft_core_id.first.first]
-                                ->outputs()
-                                .size()) {
-                            assert(soft_cardinality[soft_core_id.first.first]
-                                       ->outputs()
-                                       .size() > soft_core_id.first.second + 1);
-                            Lit out =
-                                soft_cardinality[soft_core_id.first.first]
-                                    ->outputs()[soft_core_id.first.second + 1];
-                            boundMapping[out] = std::make_pair(
-                                std::make_pair(soft_core_id.first.first,
-                                               soft_core_id.first.second + 1),
-                                min_core);
-                            cardinality_assumptions.insert(out);
-                        }
+                            solver, cardinalityEncoders[index]->lits(), bound);
+                        assert((unsigned)e->outputs().size() > bound);
+                        cardinality_relax.push(e->outputs()[bound]);
+                        cardinalityEncoders.push_back(e);
+                        index = cardinalityEncoders.size() - 1;
 
                         // Update value of the previous cardinality constraint
-                        assert(soft_id.second - min_core > 0);
-                        boundMapping[p] =
-                            std::make_pair(std::make_pair(soft_id.first.first,
-                                                          soft_id.first.second),
-                                           soft_id.second - min_core);
-
-#endif
+                        assert(weight - min_core > 0);
+                        boundWeight[var(p)] = weight - min_core;
+                        if (boundWeight[var(p)] < min_weight)
+                            removeAssumption(p);
                     }
+
+                    // increase the bound
+                    joinObjFunction.clear();
+                    encodingAssumptions.clear();
+                    cardinalityEncoders[index]->incUpdateCardinality(
+                        solver, joinObjFunction,
+                        cardinalityEncoders[index]->lits(), bound + 1,
+                        encodingAssumptions);
+
+                    // if the bound is the same as the number of lits then
+                    // no restriction is applied
+                    if (bound + 1 <
+                        (unsigned)cardinalityEncoders[index]->outputs().size())
+                        addBoundOutput(
+                            cardinalityEncoders[index]->outputs()[bound + 1],
+                            index, bound + 1, min_core);
                 }
             }
 
@@ -510,11 +2178,12 @@ void TSolver::tWeighted() {
             if (soft_relax.size() == 1 && cardinality_relax.size() == 0) {
                 // Unit core
                 // printf("UNIT CORE\n");
-                solver->addClause(soft_relax[0]);
+                // a resumable search may need to relax it again after a
+                // restart, see resumeSearch()
+                if (!resumable)
+                    solver->addClause(soft_relax[0]);
             }
 
-            // assert (soft_relax.size() > 0 || cardinality_relax.size() != 1);
-
             if (soft_relax.size() + cardinality_relax.size() > 1) {
 
                 vec<Lit> relax_harden;
@@ -522,64 +2191,45 @@ void TSolver::tWeighted() {
                 for (int i = 0; i < cardinality_relax.size(); i++)
                     relax_harden.push(cardinality_relax[i]);
 
-                /*
-                for (int i = 0; i < nSoft(); i++){
-                  printf("soft %d, w: %d, r:
-                %d\n",i,softClauses[i].weight,var(softClauses[i].relaxationVars[0])+1);
-                  for (int j = 0; j < softClauses[i].clause.size(); j++){
-                    printf("%d ",var(softClauses[i].clause[j])+1);
-                  }
-                  printf("\n");
-                }
-
-                for (int i = 0; i < relax_harden.size(); i++)
-                  printf("+1 x%d ",var(relax_harden[i])+1);
-                printf(" <= 1\n");
-                */
                 Encoder *e = new Encoder();
                 e->setIncremental(_INCREMENTAL_ITERATIVE_);
                 e->buildCardinality(solver, relax_harden, 1);
-                soft_cardinality.push(e);
+                cardinalityEncoders.push_back(e);
                 assert(e->outputs().size() > 1);
 
                 // printf("outputs %d\n",e->outputs().size());
-                Lit out = e->outputs()[1];
-                boundMapping[out] = std::make_pair(
-                    std::make_pair(soft_cardinality.size() - 1, 1), min_core);
-                cardinality_assumptions.insert(out);
-            }
-
-            // reset the assumptions
-            assumptions.clear();
-            int active_soft = 0;
-            for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-                if (!activeSoft[i] &&
-                    maxsat_formula->getSoftClause(i).weight >= min_weight) {
-                    assumptions.push(
-                        ~maxsat_formula->getSoftClause(i).assumption_var);
-                    // printf("s assumption
-                    // %d\n",var(softClauses[i].assumptionVar)+1);
-                } else
-                    active_soft++;
+                int index = cardinalityEncoders.size() - 1;
+                uint64_t bound = 1;
+                if (coreExhaustion)
+                    bound = exhaustCore(index, min_core);
+                if (bound < (unsigned)e->outputs().size())
+                    addBoundOutput(e->outputs()[bound], index, bound, min_core);
             }
-
-            // printf("assumptions %d\n",assumptions.size());
-            for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-                 it != cardinality_assumptions.end(); ++it) {
-                assert(boundMapping.find(*it) != boundMapping.end());
-                std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-                    boundMapping[*it];
-                if (soft_id.second >= min_weight)
-                    assumptions.push(~(*it));
-                // printf("c assumption %d\n",var(*it)+1);
+            hardenSoftClauses();
+            if (isCorePhaseOver()) {
+                return;
             }
 
-            // printf("card assumptions %d\n",assumptions.size());
-
             if (verbosity > 0) {
                 //  printf("c Relaxed soft clauses %d / %d\n", active_soft,
                 //         maxsat_formula->nSoft());
             }
         }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief      Gets the model saved by the solver.
+ *
+ * @return     The model, which is empty if no model has been found
+ */
+std::vector<lbool> TSolver::getModel() {
+    return Utils::convertVecDataToVector<lbool>(model, model.size());
+}
+
+/**
+ * @brief      Gets the cost of the model saved by the solver.
+ *
+ * @return     The cost
+ */
+uint64_t TSolver::getCost() { return ubCost; }
@@ -57,4 +57,26 @@ std::string getFieldName(FieldType fieldType, int index, Data &data) {
     return "Invalid Type";
 }
 
+/**
+ * @brief      Gets a numbered variant of a file name, with the number added
+ *             before the extension
+ *
+ * For example, the name numbered 2 of "output.csv" is "output_2.csv".
+ *
+ * @param[in]  fileName  The file name
+ * @param[in]  number    The number
+ *
+ * @return     The numbered file name
+ */
+std::string getNumberedFileName(std::string fileName, int number) {
+    size_t dot = fileName.find_last_of('.');
+    size_t slash = fileName.find_last_of('/');
+    if (dot == std::string::npos ||
+        (slash != std::string::npos && dot < slash)) {
+        dot = fileName.size();
+    }
+    return fileName.substr(0, dot) + "_" + std::to_string(number) +
+           fileName.substr(dot);
+}
+
 } // namespace Utils
\ No newline at end of file
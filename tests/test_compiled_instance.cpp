@@ -0,0 +1,222 @@
+#include "compiled_instance.h"
+#include "data.h"
+#include "global.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TestCompiledInstance : public ::testing::Test {
+  public:
+    std::string fileName;
+    Data data;
+    MaxSATFormula formula;
+    std::vector<int> levels;
+    std::vector<std::pair<int, int>> hardGroups;
+    std::vector<Lit> hints, greedy;
+    TestCompiledInstance() {}
+    void SetUp();
+    void TearDown();
+    std::string readFile();
+    void writeFile(const std::string &);
+};
+
+void TestCompiledInstance::SetUp() {
+    fileName = "test_compiled_instance.bin";
+    data.instructors.push_back(Instructor("Ada", data.symbols));
+    data.instructors.push_back(Instructor("Grace", data.symbols));
+    data.classrooms.push_back(Classroom("101", 40, data.symbols));
+    data.programs.push_back(Program("CSE", CourseType::core, data.symbols));
+    data.programs.push_back(
+        Program("CSE", CourseType::elective, data.symbols));
+    data.segments.push_back(Segment(1, 6));
+    data.isMinors.push_back(IsMinor(MinorType::isMinorCourse));
+    data.isMinors.push_back(IsMinor(MinorType::isNotMinorCourse));
+    std::vector<SlotElement> elements;
+    Time start(9, 0), end(10, 30);
+    elements.push_back(SlotElement(start, end, Day::Tuesday));
+    data.slots.push_back(
+        Slot("A", MinorType::isNotMinorCourse, elements, data.symbols));
+    data.courses.push_back(
+        Course("CS101", 40, 1, 0, 1, std::vector<int>(1, 0), data.symbols));
+
+    int sizes[Global::FIELD_COUNT];
+    sizes[FieldType::instructor] = data.instructors.size();
+    sizes[FieldType::segment] = data.segments.size();
+    sizes[FieldType::isMinor] = data.isMinors.size();
+    sizes[FieldType::program] = data.programs.size();
+    sizes[FieldType::classroom] = data.classrooms.size();
+    sizes[FieldType::slot] = data.slots.size();
+    int vars = 0;
+    data.fieldValueVars.resize(1);
+    data.highLevelVars.resize(1);
+    data.existingAssignmentVars.resize(1);
+    for (int j = 0; j < Global::FIELD_COUNT; j++) {
+        std::vector<Var> fieldVars;
+        for (int k = 0; k < sizes[j]; k++) {
+            fieldVars.push_back(vars++);
+        }
+        data.fieldValueVars[0].push_back(fieldVars);
+        data.existingAssignmentVars[0].push_back(
+            std::vector<lbool>(sizes[j], l_Undef));
+    }
+    for (int j = 0; j < Global::FIELD_COUNT; j++) {
+        data.highLevelVars[0].push_back(vars++);
+    }
+    data.existingAssignmentVars[0][FieldType::instructor][1] = l_True;
+    data.existingAssignmentVars[0][FieldType::slot][0] = l_False;
+    data.highLevelVarWeights[FieldType::slot] = 6;
+    data.predefinedClausesWeights[0] = 3;
+    data.buildIndices();
+
+    for (int i = 0; i < vars; i++) {
+        formula.newVar();
+    }
+    vec<Lit> clause;
+    clause.push(mkLit(0));
+    clause.push(~mkLit(vars - 1));
+    formula.addHardClause(clause);
+    clause.clear();
+    clause.push(mkLit(2));
+    formula.addHardClause(clause);
+    clause.clear();
+    clause.push(~mkLit(1));
+    formula.addSoftClause(5000000000ULL, clause);
+    levels.push_back(2);
+    hardGroups.push_back(std::make_pair(0, 2));
+    hints.push_back(~mkLit(3));
+    greedy.push_back(mkLit(4));
+    greedy.push_back(~mkLit(5));
+}
+
+void TestCompiledInstance::TearDown() { std::remove(fileName.c_str()); }
+
+std::string TestCompiledInstance::readFile() {
+    std::ifstream file(fileName, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+}
+
+void TestCompiledInstance::writeFile(const std::string &contents) {
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+TEST_F(TestCompiledInstance, RoundTrip) {
+    CompiledInstance writer;
+    ASSERT_TRUE(writer.write(fileName, data, &formula, levels, hardGroups,
+                             hints, greedy));
+
+    Data readData;
+    MaxSATFormula readFormula;
+    std::vector<int> readLevels;
+    std::vector<std::pair<int, int>> readGroups;
+    std::vector<Lit> readHints, readGreedy;
+    CompiledInstance reader;
+    ASSERT_TRUE(reader.read(fileName, readData, &readFormula, readLevels,
+                            readGroups, readHints, readGreedy));
+    ASSERT_EQ(reader.getError(), "");
+
+    ASSERT_EQ(readData.instructors.size(), 2);
+    ASSERT_EQ(readData.instructors[1].getName(), "Grace");
+    ASSERT_EQ(readData.classrooms[0].getName(), "101");
+    ASSERT_EQ(readData.classrooms[0].getSize(), 40);
+    ASSERT_EQ(readData.programs.size(), 2);
+    ASSERT_FALSE(readData.programs[1].isCoreProgram());
+    ASSERT_EQ(readData.segments[0].getEndSegment(), 6);
+    ASSERT_EQ(readData.slots[0].getName(), "A");
+    std::vector<SlotElement> elements = readData.slots[0].getSlotElements();
+    ASSERT_EQ(elements.size(), 1);
+    ASSERT_EQ(elements[0].getDay(), Day::Tuesday);
+    ASSERT_EQ(elements[0].getEndTime().getMinutes(), 30);
+    ASSERT_EQ(readData.courses.size(), 1);
+    ASSERT_EQ(readData.courses[0].getName(), "CS101");
+    ASSERT_EQ(readData.courses[0].getInstructor(), 1);
+    ASSERT_EQ(readData.findCourse("CS101"), 0);
+    ASSERT_EQ(readData.fieldValueVars[0], data.fieldValueVars[0]);
+    ASSERT_EQ(readData.highLevelVars[0], data.highLevelVars[0]);
+    ASSERT_EQ(readData.existingAssignmentVars[0][FieldType::instructor][1],
+              l_True);
+    ASSERT_EQ(readData.existingAssignmentVars[0][FieldType::slot][0],
+              l_False);
+    ASSERT_EQ(readData.existingAssignmentVars[0][FieldType::instructor][0],
+              l_Undef);
+    ASSERT_EQ(readData.highLevelVarWeights[FieldType::slot], 6);
+    ASSERT_EQ(readData.predefinedClausesWeights[0], 3);
+
+    ASSERT_EQ(readFormula.nVars(), formula.nVars());
+    ASSERT_EQ(readFormula.nHard(), 2);
+    ASSERT_EQ(readFormula.getHardClause(0).clause.size(), 2);
+    ASSERT_EQ(readFormula.getHardClause(0).clause[1],
+              ~mkLit(formula.nVars() - 1));
+    ASSERT_EQ(readFormula.nSoft(), 1);
+    ASSERT_EQ(readFormula.getSoftClause(0).weight, 5000000000ULL);
+    ASSERT_EQ(readFormula.getSoftClause(0).clause[0], ~mkLit(1));
+    ASSERT_EQ(readLevels, levels);
+    ASSERT_EQ(readGroups, hardGroups);
+    ASSERT_EQ(readHints, hints);
+    ASSERT_EQ(readGreedy, greedy);
+}
+
+TEST_F(TestCompiledInstance, RejectsDamagedFile) {
+    CompiledInstance writer;
+    ASSERT_TRUE(writer.write(fileName, data, &formula, levels, hardGroups,
+                             hints, greedy));
+    std::string contents = readFile();
+    contents[contents.size() / 2 + 16] ^= 1;
+    writeFile(contents);
+
+    Data readData;
+    MaxSATFormula readFormula;
+    std::vector<int> readLevels;
+    std::vector<std::pair<int, int>> readGroups;
+    std::vector<Lit> readHints, readGreedy;
+    CompiledInstance reader;
+    ASSERT_FALSE(reader.read(fileName, readData, &readFormula, readLevels,
+                             readGroups, readHints, readGreedy));
+    ASSERT_EQ(reader.getError(),
+              "the checksum does not match, the file is damaged");
+}
+
+TEST_F(TestCompiledInstance, RejectsTruncatedFile) {
+    CompiledInstance writer;
+    ASSERT_TRUE(writer.write(fileName, data, &formula, levels, hardGroups,
+                             hints, greedy));
+    std::string contents = readFile();
+    writeFile(contents.substr(0, contents.size() - 4));
+
+    Data readData;
+    MaxSATFormula readFormula;
+    std::vector<int> readLevels;
+    std::vector<std::pair<int, int>> readGroups;
+    std::vector<Lit> readHints, readGreedy;
+    CompiledInstance reader;
+    ASSERT_FALSE(reader.read(fileName, readData, &readFormula, readLevels,
+                             readGroups, readHints, readGreedy));
+    ASSERT_EQ(reader.getError(),
+              "the checksum does not match, the file is damaged");
+
+    writeFile(contents.substr(0, 10));
+    ASSERT_FALSE(reader.read(fileName, readData, &readFormula, readLevels,
+                             readGroups, readHints, readGreedy));
+    ASSERT_EQ(reader.getError(), "not a compiled instance");
+}
+
+TEST_F(TestCompiledInstance, RejectsOtherFile) {
+    writeFile(std::string(64, 'x'));
+
+    Data readData;
+    MaxSATFormula readFormula;
+    std::vector<int> readLevels;
+    std::vector<std::pair<int, int>> readGroups;
+    std::vector<Lit> readHints, readGreedy;
+    CompiledInstance reader;
+    ASSERT_FALSE(reader.read(fileName, readData, &readFormula, readLevels,
+                             readGroups, readHints, readGreedy));
+    ASSERT_EQ(reader.getError(), "not a compiled instance");
+    ASSERT_FALSE(reader.read("no_such_file.bin", readData, &readFormula,
+                             readLevels, readGroups, readHints, readGreedy));
+}
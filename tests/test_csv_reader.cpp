@@ -0,0 +1,126 @@
+#include "csv_reader.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+class TestCSVReader : public ::testing::Test {
+  public:
+    std::string fileName;
+    CSVReader reader;
+    TestCSVReader() {}
+    void SetUp();
+    void TearDown();
+    void writeFile(const std::string &);
+};
+
+void TestCSVReader::SetUp() { fileName = "test_csv_reader.csv"; }
+
+void TestCSVReader::TearDown() { std::remove(fileName.c_str()); }
+
+void TestCSVReader::writeFile(const std::string &contents) {
+    std::ofstream file(fileName, std::ios::binary);
+    file << contents;
+}
+
+TEST_F(TestCSVReader, ReadsHeaderAndRows) {
+    writeFile("name,size\nA101,40\nB202,60\n");
+    ASSERT_TRUE(reader.open(fileName));
+    ASSERT_EQ(reader.findColumn("name"), 0);
+    ASSERT_EQ(reader.findColumn("size"), 1);
+    ASSERT_EQ(reader.findColumn("missing"), -1);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.getCell(0) == "A101");
+    ASSERT_TRUE(reader.getCell(1) == "40");
+    ASSERT_EQ(reader.getLine(), 2);
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.getCell(0) == "B202");
+    ASSERT_TRUE(reader.getCell(1) != "40");
+    ASSERT_EQ(reader.getLine(), 3);
+    ASSERT_FALSE(reader.next());
+    ASSERT_FALSE(reader.hasError());
+}
+
+TEST_F(TestCSVReader, LastRowWithoutNewline) {
+    writeFile("name,size\nA101,40");
+    ASSERT_TRUE(reader.open(fileName));
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.getCell(1) == "40");
+    ASSERT_FALSE(reader.next());
+    ASSERT_FALSE(reader.hasError());
+}
+
+TEST_F(TestCSVReader, QuotedCells) {
+    writeFile("name,note\n\"A,101\",\"says \"\"hi\"\"\"\n\"two\nlines\",x\n"
+              "last,\"\"\n");
+    ASSERT_TRUE(reader.open(fileName));
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.getCell(0) == "A,101");
+    ASSERT_TRUE(reader.getCell(1) == "says \"hi\"");
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.getCell(0) == "two\nlines");
+    ASSERT_EQ(reader.getLine(), 3);
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(reader.getLine(), 5);
+    ASSERT_TRUE(reader.getCell(1).empty());
+    ASSERT_FALSE(reader.next());
+    ASSERT_FALSE(reader.hasError());
+}
+
+TEST_F(TestCSVReader, CarriageReturns) {
+    writeFile("name,size\r\nA101,40\r\n\"B202\",60\r\n");
+    ASSERT_TRUE(reader.open(fileName));
+    ASSERT_EQ(reader.findColumn("size"), 1);
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.getCell(1) == "40");
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.getCell(0) == "B202");
+    ASSERT_TRUE(reader.getCell(1) == "60");
+    ASSERT_FALSE(reader.next());
+    ASSERT_FALSE(reader.hasError());
+}
+
+TEST_F(TestCSVReader, SkipsBlankLines) {
+    writeFile("name,size\n\nA101,40\n\n");
+    ASSERT_TRUE(reader.open(fileName));
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.getCell(0) == "A101");
+    ASSERT_EQ(reader.getLine(), 3);
+    ASSERT_FALSE(reader.next());
+    ASSERT_FALSE(reader.hasError());
+}
+
+TEST_F(TestCSVReader, WrongCellCount) {
+    writeFile("name,size\nA101,40,extra\n");
+    ASSERT_TRUE(reader.open(fileName));
+    ASSERT_FALSE(reader.next());
+    ASSERT_TRUE(reader.hasError());
+    ASSERT_EQ(reader.getLine(), 2);
+    ASSERT_EQ(reader.getError(), "expected 2 cells, found 3");
+}
+
+TEST_F(TestCSVReader, UnclosedQuote) {
+    writeFile("name,size\n\"A101,40\n");
+    ASSERT_TRUE(reader.open(fileName));
+    ASSERT_FALSE(reader.next());
+    ASSERT_TRUE(reader.hasError());
+}
+
+TEST_F(TestCSVReader, TextAfterQuote) {
+    writeFile("name,size\n\"A101\"x,40\n");
+    ASSERT_TRUE(reader.open(fileName));
+    ASSERT_FALSE(reader.next());
+    ASSERT_TRUE(reader.hasError());
+}
+
+TEST_F(TestCSVReader, EmptyFile) {
+    writeFile("");
+    ASSERT_FALSE(reader.open(fileName));
+    ASSERT_EQ(reader.getError(), "the file has no header");
+}
+
+TEST_F(TestCSVReader, MissingFile) {
+    ASSERT_FALSE(reader.open("no_such_file.csv"));
+    ASSERT_TRUE(reader.hasError());
+}
@@ -0,0 +1,144 @@
+#include "decomposition.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+class TestDecomposition : public ::testing::Test {
+  public:
+    MaxSATFormula formula;
+    TestDecomposition() {}
+    void SetUp();
+    void TearDown() {}
+    void addHard(Lit, Lit = lit_Undef, Lit = lit_Undef);
+    void addSoft(uint64_t, Lit, Lit = lit_Undef);
+};
+
+void TestDecomposition::SetUp() {
+    for (int i = 0; i < 8; i++) {
+        formula.newVar();
+    }
+}
+
+void TestDecomposition::addHard(Lit a, Lit b, Lit c) {
+    vec<Lit> clause;
+    clause.push(a);
+    if (b != lit_Undef) {
+        clause.push(b);
+    }
+    if (c != lit_Undef) {
+        clause.push(c);
+    }
+    formula.addHardClause(clause);
+}
+
+void TestDecomposition::addSoft(uint64_t weight, Lit a, Lit b) {
+    vec<Lit> clause;
+    clause.push(a);
+    if (b != lit_Undef) {
+        clause.push(b);
+    }
+    formula.addSoftClause(weight, clause);
+}
+
+TEST_F(TestDecomposition, FindsComponents) {
+    addHard(mkLit(0));
+    addHard(~mkLit(0), mkLit(1));
+    addHard(~mkLit(1), mkLit(2), mkLit(3));
+    addHard(mkLit(4), mkLit(5));
+    addSoft(2, mkLit(5), mkLit(6));
+    addSoft(3, ~mkLit(1));
+    addSoft(4, mkLit(0), mkLit(7));
+
+    Decomposition decomposition(&formula);
+    ASSERT_FALSE(decomposition.isConflicting());
+    ASSERT_EQ(decomposition.getComponentCount(), 2);
+    ASSERT_EQ(decomposition.getFixedCost(), 3);
+    ASSERT_EQ(decomposition.getHardClauses(0), std::vector<int>({2}));
+    ASSERT_EQ(decomposition.getHardClauses(1), std::vector<int>({3}));
+
+    std::vector<lbool> model = decomposition.getFixedModel();
+    ASSERT_EQ(model.size(), 8);
+    ASSERT_EQ(model[0], l_True);
+    ASSERT_EQ(model[1], l_True);
+    ASSERT_EQ(model[2], l_False);
+    ASSERT_EQ(model[7], l_False);
+}
+
+TEST_F(TestDecomposition, BuildsComponentFormulas) {
+    addHard(mkLit(0));
+    addHard(~mkLit(0), mkLit(1));
+    addHard(~mkLit(1), mkLit(2), mkLit(3));
+    addHard(mkLit(4), mkLit(5));
+    addSoft(2, mkLit(5), ~mkLit(6));
+
+    Decomposition decomposition(&formula);
+    MaxSATFormula *first = decomposition.buildFormula(0);
+    ASSERT_EQ(first->nVars(), 2);
+    ASSERT_EQ(first->nHard(), 1);
+    ASSERT_EQ(first->nSoft(), 0);
+    // the fixed literal ~1 is removed
+    ASSERT_EQ(first->getHardClause(0).clause.size(), 2);
+    ASSERT_EQ(first->getHardClause(0).clause[0], mkLit(0));
+    ASSERT_EQ(first->getHardClause(0).clause[1], mkLit(1));
+    delete first;
+
+    MaxSATFormula *second = decomposition.buildFormula(1);
+    ASSERT_EQ(second->nVars(), 3);
+    ASSERT_EQ(second->nHard(), 1);
+    ASSERT_EQ(second->nSoft(), 1);
+    ASSERT_EQ(second->getSoftClause(0).weight, 2);
+    ASSERT_EQ(second->getSoftClause(0).clause[0], mkLit(1));
+    ASSERT_EQ(second->getSoftClause(0).clause[1], ~mkLit(2));
+    delete second;
+}
+
+TEST_F(TestDecomposition, MapsHintsAndModels) {
+    addHard(mkLit(0));
+    addHard(~mkLit(0), mkLit(1));
+    addHard(~mkLit(1), mkLit(2), mkLit(3));
+    addHard(mkLit(4), mkLit(5));
+
+    Decomposition decomposition(&formula);
+    std::vector<Lit> hints;
+    hints.push_back(~mkLit(0));
+    hints.push_back(~mkLit(3));
+    hints.push_back(mkLit(5));
+    ASSERT_EQ(decomposition.localHints(0, hints),
+              std::vector<Lit>({~mkLit(1)}));
+    ASSERT_EQ(decomposition.localHints(1, hints),
+              std::vector<Lit>({mkLit(1)}));
+
+    std::vector<lbool> model = decomposition.getFixedModel();
+    decomposition.mergeModel(0, std::vector<lbool>({l_True, l_False}),
+                             model);
+    decomposition.mergeModel(1, std::vector<lbool>({l_False, l_True}),
+                             model);
+    ASSERT_EQ(model, std::vector<lbool>({l_True, l_True, l_True, l_False,
+                                         l_False, l_True, l_False, l_False}));
+}
+
+TEST_F(TestDecomposition, PropagatesChains) {
+    // each implication is only unit once the one after it in the formula
+    // has fixed its premise
+    for (int i = 6; i >= 0; i--) {
+        addHard(~mkLit(i), mkLit(i + 1));
+    }
+    addHard(mkLit(0));
+
+    Decomposition decomposition(&formula);
+    ASSERT_FALSE(decomposition.isConflicting());
+    ASSERT_EQ(decomposition.getComponentCount(), 0);
+    std::vector<lbool> model = decomposition.getFixedModel();
+    for (int i = 0; i < 8; i++) {
+        ASSERT_EQ(model[i], l_True);
+    }
+}
+
+TEST_F(TestDecomposition, FindsConflicts) {
+    addHard(~mkLit(2), ~mkLit(3));
+    addHard(~mkLit(1), mkLit(2));
+    addHard(~mkLit(1), mkLit(3));
+    addHard(mkLit(1));
+
+    Decomposition decomposition(&formula);
+    ASSERT_TRUE(decomposition.isConflicting());
+}
@@ -0,0 +1,142 @@
+#include "data.h"
+#include "fields_loader.h"
+#include "global.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+class TestFieldsLoader : public ::testing::Test {
+  public:
+    Data data;
+    std::string fields;
+    TestFieldsLoader() {}
+    void SetUp();
+    void TearDown() {}
+    bool load(const std::string &);
+};
+
+void TestFieldsLoader::SetUp() {
+    fields = "weights:\n"
+             "  instructor: [3, 4]\n"
+             "  segment: [1, 1]\n"
+             "  is_minor: [1, 1]\n"
+             "  program: 5\n"
+             "  classroom: [1, 1]\n"
+             "  slot: [1, 1]\n"
+             "predefined_weights:\n"
+             "  - clause: 0\n"
+             "    weight: 7\n"
+             "segments:\n"
+             "  start: 1\n"
+             "  end: 3\n"
+             "instructors:\n"
+             "  - Ada\n"
+             "  - Grace\n"
+             "classrooms:\n"
+             "  - number: 101\n"
+             "    size: 40\n"
+             "programs:\n"
+             "  - CSE\n"
+             "slots:\n"
+             "  - name: A\n"
+             "    is_minor: false\n"
+             "    time_periods:\n"
+             "      - day: Monday\n"
+             "        start: \"9:00\"\n"
+             "        end: \"10:00\"\n"
+             "      - day: Thursday\n"
+             "        start: \"11:30\"\n"
+             "        end: \"12:30\"\n";
+}
+
+bool TestFieldsLoader::load(const std::string &contents) {
+    std::istringstream in(contents);
+    FieldsLoader loader(data);
+    return loader.load(in);
+}
+
+TEST_F(TestFieldsLoader, LoadsFields) {
+    ASSERT_TRUE(load(fields));
+
+    ASSERT_EQ(data.instructors.size(), 2);
+    ASSERT_EQ(data.instructors[1].getName(), "Grace");
+    ASSERT_EQ(data.classrooms.size(), 1);
+    ASSERT_EQ(data.classrooms[0].getName(), "101");
+    ASSERT_EQ(data.classrooms[0].getSize(), 40);
+    // a core and an elective program for each program name
+    ASSERT_EQ(data.programs.size(), 2);
+    ASSERT_EQ(data.programs[0].getName(), "CSE");
+    ASSERT_EQ(data.isMinors.size(), 2);
+
+    // every segment from a start to an end within 1 to 3
+    ASSERT_EQ(data.segments.size(), 6);
+    ASSERT_EQ(data.segments[0].getStartSegment(), 1);
+    ASSERT_EQ(data.segments[5].getStartSegment(), 3);
+    ASSERT_EQ(data.segments[5].getEndSegment(), 3);
+
+    ASSERT_EQ(data.slots.size(), 1);
+    ASSERT_EQ(data.slots[0].getName(), "A");
+    ASSERT_FALSE(data.slots[0].isMinorSlot());
+    std::vector<SlotElement> elements = data.slots[0].getSlotElements();
+    ASSERT_EQ(elements.size(), 2);
+    ASSERT_EQ(elements[1].getDay(), Day::Thursday);
+    ASSERT_EQ(elements[1].getStartTime().getHours(), 11);
+    ASSERT_EQ(elements[1].getStartTime().getMinutes(), 30);
+    ASSERT_EQ(elements[1].getEndTime().getHours(), 12);
+}
+
+TEST_F(TestFieldsLoader, LoadsWeights) {
+    ASSERT_TRUE(load(fields));
+
+    ASSERT_EQ(data.existingAssignmentWeights[FieldType::instructor], 3);
+    ASSERT_EQ(data.highLevelVarWeights[FieldType::instructor], 8);
+    ASSERT_EQ(data.existingAssignmentWeights[FieldType::program], 5);
+    ASSERT_EQ(data.predefinedClausesWeights[0], 7);
+    ASSERT_EQ(data.predefinedClausesWeights[1], -1);
+}
+
+TEST_F(TestFieldsLoader, FlowStyle) {
+    ASSERT_TRUE(load("segments: {start: 1, end: 2}\n"
+                     "instructors: [Ada]\n"
+                     "classrooms: [{number: 7, size: 10}]\n"));
+    ASSERT_EQ(data.segments.size(), 3);
+    ASSERT_EQ(data.instructors.size(), 1);
+    ASSERT_EQ(data.classrooms[0].getSize(), 10);
+}
+
+TEST_F(TestFieldsLoader, RejectsInvalidValue) {
+    std::string invalid = fields;
+    invalid.replace(invalid.find("size: 40"), 8, "size: big");
+    std::istringstream in(invalid);
+    FieldsLoader loader(data);
+    ASSERT_FALSE(loader.load(in));
+    ASSERT_EQ(loader.getError(), "invalid classroom size big");
+    ASSERT_EQ(loader.getErrorLine(), 19);
+    ASSERT_EQ(loader.getErrorColumn(), 11);
+}
+
+TEST_F(TestFieldsLoader, RejectsInvalidTime) {
+    std::string invalid = fields;
+    invalid.replace(invalid.find("\"9:00\""), 6, "\"9:75\"");
+    ASSERT_FALSE(load(invalid));
+}
+
+TEST_F(TestFieldsLoader, RejectsIncompleteClassroom) {
+    std::istringstream in("segments: {start: 1, end: 2}\n"
+                          "classrooms:\n"
+                          "  - number: 7\n");
+    FieldsLoader loader(data);
+    ASSERT_FALSE(loader.load(in));
+    ASSERT_EQ(loader.getError(), "a classroom needs a number and a size");
+}
+
+TEST_F(TestFieldsLoader, RejectsMissingSegments) {
+    std::istringstream in("instructors: [Ada]\n");
+    FieldsLoader loader(data);
+    ASSERT_FALSE(loader.load(in));
+    ASSERT_EQ(loader.getError(), "the fields have no segments");
+}
+
+TEST_F(TestFieldsLoader, RejectsSyntaxError) {
+    ASSERT_FALSE(load("instructors: [Ada\n"));
+}
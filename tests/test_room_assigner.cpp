@@ -0,0 +1,164 @@
+#include "data.h"
+#include "global.h"
+#include "room_assigner.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class TestRoomAssigner : public ::testing::Test {
+  public:
+    Data data;
+    std::vector<lbool> model;
+    std::vector<int> rooms;
+    std::vector<std::vector<int>> infeasible;
+    long long cost;
+    TestRoomAssigner() {}
+    void SetUp();
+    void TearDown() {}
+    void addSlot(const std::string &, Day, Time, Time);
+    void addCourse(const std::string &, unsigned, int);
+};
+
+void TestRoomAssigner::SetUp() {
+    data.classrooms.push_back(Classroom("Small", 30, data.symbols));
+    data.classrooms.push_back(Classroom("Medium", 50, data.symbols));
+    data.classrooms.push_back(Classroom("Large", 100, data.symbols));
+    data.segments.push_back(Segment(1, 6));
+    addSlot("A", Day::Monday, Time(9, 0), Time(10, 0));
+    addSlot("B", Day::Monday, Time(9, 30), Time(10, 30));
+    addSlot("C", Day::Tuesday, Time(9, 0), Time(10, 0));
+    addSlot("D", Day::Monday, Time(10, 15), Time(11, 0));
+    data.predefinedClausesWeights
+        [PredefinedClauses::classroomSingleCourseAtATime] = -1;
+    data.predefinedClausesWeights
+        [PredefinedClauses::exactlyOneClassroomPerCourse] = -1;
+    data.existingAssignmentWeights[FieldType::classroom] = 5;
+}
+
+void TestRoomAssigner::addSlot(const std::string &name, Day day, Time start,
+                               Time end) {
+    std::vector<SlotElement> elements;
+    elements.push_back(SlotElement(start, end, day));
+    data.slots.push_back(
+        Slot(name, MinorType::isNotMinorCourse, elements, data.symbols));
+}
+
+// adds a Course meeting in the given slot and the only segment, which is to
+// be given a classroom
+void TestRoomAssigner::addCourse(const std::string &name, unsigned size,
+                                 int slot) {
+    data.courses.push_back(Course(name, size, 0, 0, 1, data.symbols));
+    std::vector<std::vector<Var>> fieldVars(Global::FIELD_COUNT);
+    std::vector<std::vector<lbool>> existing(Global::FIELD_COUNT);
+    std::vector<Var> highLevel;
+    int sizes[Global::FIELD_COUNT] = {0};
+    sizes[FieldType::segment] = data.segments.size();
+    sizes[FieldType::classroom] = data.classrooms.size();
+    sizes[FieldType::slot] = data.slots.size();
+    for (int j = 0; j < Global::FIELD_COUNT; j++) {
+        for (int k = 0; k < sizes[j]; k++) {
+            fieldVars[j].push_back(model.size());
+            model.push_back(l_False);
+        }
+        existing[j].assign(sizes[j], l_Undef);
+        highLevel.push_back(model.size());
+        model.push_back(l_True);
+    }
+    model[fieldVars[FieldType::segment][0]] = l_True;
+    model[fieldVars[FieldType::slot][slot]] = l_True;
+    data.fieldValueVars.push_back(fieldVars);
+    data.existingAssignmentVars.push_back(existing);
+    data.highLevelVars.push_back(highLevel);
+}
+
+TEST_F(TestRoomAssigner, IsApplicable) {
+    RoomAssigner assigner(data);
+    ASSERT_TRUE(assigner.isApplicable());
+
+    data.predefinedClausesWeights
+        [PredefinedClauses::classroomSingleCourseAtATime] = 10;
+    ASSERT_FALSE(RoomAssigner(data).isApplicable());
+    data.predefinedClausesWeights
+        [PredefinedClauses::classroomSingleCourseAtATime] = -1;
+    data.classroomCustomConstraints = true;
+    ASSERT_FALSE(RoomAssigner(data).isApplicable());
+}
+
+TEST_F(TestRoomAssigner, MatchesBySize) {
+    addCourse("Big", 90, 0);
+    addCourse("Mid", 40, 1);
+    addCourse("Tiny", 20, 0);
+    RoomAssigner assigner(data);
+    ASSERT_TRUE(assigner.assign(model, rooms, infeasible, cost));
+    ASSERT_EQ(rooms, std::vector<int>({2, 1, 0}));
+    ASSERT_TRUE(infeasible.empty());
+    ASSERT_EQ(cost, 0);
+}
+
+TEST_F(TestRoomAssigner, SharesRoomsAcrossTimes) {
+    addCourse("Monday", 90, 0);
+    addCourse("Tuesday", 90, 2);
+    RoomAssigner assigner(data);
+    ASSERT_TRUE(assigner.assign(model, rooms, infeasible, cost));
+    ASSERT_EQ(rooms, std::vector<int>({2, 2}));
+    ASSERT_EQ(cost, 0);
+}
+
+TEST_F(TestRoomAssigner, MinimizesBrokenAssignments) {
+    addCourse("First", 20, 0);
+    addCourse("Second", 20, 0);
+    addCourse("Third", 20, 0);
+    data.existingAssignmentVars[1][FieldType::classroom][0] = l_True;
+    data.existingAssignmentVars[2][FieldType::classroom][0] = l_True;
+    data.existingAssignmentVars[2][FieldType::classroom][2] = l_False;
+    RoomAssigner assigner(data);
+    ASSERT_TRUE(assigner.assign(model, rooms, infeasible, cost));
+    // Third keeps Small, as moving it breaks more, and Second is moved at a
+    // cost of 5
+    ASSERT_EQ(cost, 5);
+    ASSERT_EQ(rooms[2], 0);
+    ASSERT_NE(rooms[0], 0);
+    ASSERT_NE(rooms[1], 0);
+    ASSERT_NE(rooms[0], rooms[1]);
+}
+
+TEST_F(TestRoomAssigner, HardExistingAssignment) {
+    data.existingAssignmentWeights[FieldType::classroom] = -1;
+    addCourse("Fixed", 20, 0);
+    addCourse("Free", 20, 0);
+    data.existingAssignmentVars[0][FieldType::classroom][1] = l_True;
+    RoomAssigner assigner(data);
+    ASSERT_TRUE(assigner.assign(model, rooms, infeasible, cost));
+    ASSERT_EQ(rooms[0], 1);
+    ASSERT_NE(rooms[1], 1);
+    ASSERT_EQ(cost, 0);
+}
+
+TEST_F(TestRoomAssigner, SkipsCoursesWithoutClassroom) {
+    addCourse("Big", 90, 0);
+    addCourse("Other", 90, 0);
+    model[data.highLevelVars[1][FieldType::classroom]] = l_False;
+    RoomAssigner assigner(data);
+    ASSERT_TRUE(assigner.assign(model, rooms, infeasible, cost));
+    ASSERT_EQ(rooms, std::vector<int>({2, -1}));
+}
+
+TEST_F(TestRoomAssigner, InfeasibleClique) {
+    addCourse("First", 90, 0);
+    addCourse("Second", 90, 1);
+    addCourse("Elsewhere", 90, 2);
+    RoomAssigner assigner(data);
+    ASSERT_TRUE(assigner.assign(model, rooms, infeasible, cost));
+    ASSERT_EQ(infeasible.size(), 1);
+    ASSERT_EQ(infeasible[0], std::vector<int>({0, 1}));
+    ASSERT_EQ(rooms[2], 2);
+}
+
+TEST_F(TestRoomAssigner, ChainNeedsSolver) {
+    // A and D do not intersect, but both intersect B
+    addCourse("First", 90, 0);
+    addCourse("Second", 90, 1);
+    addCourse("Third", 90, 3);
+    RoomAssigner assigner(data);
+    ASSERT_FALSE(assigner.assign(model, rooms, infeasible, cost));
+}
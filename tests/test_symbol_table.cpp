@@ -0,0 +1,51 @@
+#include "symbol_table.h"
+#include <gtest/gtest.h>
+#include <string>
+
+class TestSymbolTable : public ::testing::Test {
+  public:
+    SymbolTable table;
+    TestSymbolTable() {}
+    void SetUp();
+    void TearDown() {}
+};
+
+void TestSymbolTable::SetUp() {
+    table.intern("CS101");
+    table.intern("MA102");
+    table.intern("PH103");
+}
+
+TEST_F(TestSymbolTable, InternGivesDenseIds) {
+    ASSERT_EQ(table.size(), 3);
+    ASSERT_EQ(table.find("CS101"), 0);
+    ASSERT_EQ(table.find("MA102"), 1);
+    ASSERT_EQ(table.find("PH103"), 2);
+}
+
+TEST_F(TestSymbolTable, InternTwiceGivesSameId) {
+    ASSERT_EQ(table.intern("MA102"), 1);
+    ASSERT_EQ(table.size(), 3);
+    ASSERT_EQ(table.intern("EE104"), 3);
+    ASSERT_EQ(table.size(), 4);
+}
+
+TEST_F(TestSymbolTable, FindUnknownName) {
+    ASSERT_EQ(table.find("EE104"), -1);
+    ASSERT_EQ(table.find(""), -1);
+    ASSERT_EQ(table.size(), 3);
+}
+
+TEST_F(TestSymbolTable, GetNameOfId) {
+    ASSERT_EQ(table.getName(0), "CS101");
+    ASSERT_EQ(table.getName(2), "PH103");
+    ASSERT_EQ(table.getName(table.find("MA102")), "MA102");
+}
+
+TEST_F(TestSymbolTable, NameOutlivesArgument) {
+    std::string name = "HS105";
+    int id = table.intern(name);
+    name = "changed";
+    ASSERT_EQ(table.getName(id), "HS105");
+    ASSERT_EQ(table.find("HS105"), id);
+}